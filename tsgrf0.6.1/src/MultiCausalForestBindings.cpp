@@ -61,7 +61,7 @@ Rcpp::List multi_causal_train(const Rcpp::NumericMatrix& train_matrix,
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
       honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
-  Forest forest = trainer.train(data, options);
+  Forest forest = RcppUtilities::train_forest(trainer, data, options);
 
   std::vector<Prediction> predictions;
   if (compute_oob_predictions) {
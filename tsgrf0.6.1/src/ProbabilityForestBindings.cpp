@@ -45,8 +45,12 @@ Rcpp::List probability_train(const Rcpp::NumericMatrix& train_matrix,
                              unsigned int samples_per_cluster,
                              bool compute_oob_predictions,
                              int num_threads,
-                             unsigned int seed) {
-  ForestTrainer trainer = probability_trainer(num_classes);
+                             unsigned int seed,
+                             unsigned int num_random_thresholds,
+                             unsigned int max_num_thresholds,
+                             size_t min_quantile_node_size) {
+  SplitValueOptions split_value_options(num_random_thresholds, max_num_thresholds, min_quantile_node_size);
+  ForestTrainer trainer = probability_trainer(num_classes, split_value_options);
 
   Data data = RcppUtilities::convert_data(train_matrix);
   data.set_outcome_index(outcome_index);
@@ -56,7 +60,7 @@ Rcpp::List probability_train(const Rcpp::NumericMatrix& train_matrix,
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
       honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
-  Forest forest = trainer.train(data, options);
+  Forest forest = RcppUtilities::train_forest(trainer, data, options);
   
   std::vector<Prediction> predictions;
   if (compute_oob_predictions) {
@@ -45,17 +45,21 @@ Rcpp::List quantile_train(std::vector<double> quantiles,
                           bool compute_oob_predictions,
                           int num_threads,
                           unsigned int seed,
-                          size_t honesty_method) {
+                          size_t honesty_method,
+                          unsigned int num_random_thresholds,
+                          unsigned int max_num_thresholds,
+                          size_t min_quantile_node_size) {
+  SplitValueOptions split_value_options(num_random_thresholds, max_num_thresholds, min_quantile_node_size);
   ForestTrainer trainer = regression_splitting
-      ? regression_trainer()
-      : quantile_trainer(quantiles);
+      ? regression_trainer(split_value_options)
+      : quantile_trainer(quantiles, split_value_options);
 
   Data data = RcppUtilities::convert_data(train_matrix);
   data.set_outcome_index(outcome_index);
 
   ForestOptions options(num_trees, nonlapping_block_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster, honesty_method);
-  Forest forest = trainer.train(data, options);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster, honesty_method, false, 1);
+  Forest forest = RcppUtilities::train_forest(trainer, data, options);
 
   std::vector<Prediction> predictions;
   if (compute_oob_predictions) {
@@ -16,20 +16,31 @@
  #-------------------------------------------------------------------------------*/
 
 #include <Rcpp.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "commons/globals.h"
+#include "forest/Backtester.h"
+#include "forest/ForestBatchTrainer.h"
 #include "forest/ForestPredictors.h"
 #include "forest/ForestTrainers.h"
+#include "forest/ForestTuner.h"
 #include "RcppUtilities.h"
 
 using namespace grf;
 
 // [[Rcpp::export]]
 Rcpp::List regression_train(const Rcpp::NumericMatrix& train_matrix,
+                            const Rcpp::List& train_columns,
+                            const Rcpp::NumericMatrix& virtual_features,
                             size_t outcome_index,
                             size_t sample_weight_index,
                             bool use_sample_weights,
+                            size_t series_index,
+                            bool use_series,
+                            bool equal_series_allocation,
                             unsigned int mtry,
                             unsigned int num_trees,
                             unsigned int min_node_size,
@@ -38,6 +49,7 @@ Rcpp::List regression_train(const Rcpp::NumericMatrix& train_matrix,
                             double honesty_fraction,
                             bool honesty_prune_leaves,
                             size_t nonlapping_block_size,
+                            size_t ci_group_size,
                             double alpha,
                             double imbalance_penalty,
                             std::vector<size_t> clusters,
@@ -45,19 +57,28 @@ Rcpp::List regression_train(const Rcpp::NumericMatrix& train_matrix,
                             bool compute_oob_predictions,
                             unsigned int num_threads,
                             unsigned int seed,
-                            size_t honesty_method) {
-  ForestTrainer trainer = regression_trainer();
+                            size_t honesty_method,
+                            double train_time_budget,
+                            unsigned int num_random_thresholds,
+                            unsigned int max_num_thresholds,
+                            size_t min_quantile_node_size) {
+  SplitValueOptions split_value_options(num_random_thresholds, max_num_thresholds, min_quantile_node_size);
+  ForestTrainer trainer = regression_trainer(split_value_options);
 
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, train_columns);
+  RcppUtilities::add_virtual_columns(data, virtual_features);
   data.set_outcome_index(outcome_index);
   if (use_sample_weights) {
     data.set_weight_index(sample_weight_index);
   }
+  if (use_series) {
+    data.set_series_index(series_index);
+  }
 
   ForestOptions options(num_trees, nonlapping_block_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster, honesty_method);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster, honesty_method, equal_series_allocation, ci_group_size);
   
-  Forest forest = trainer.train(data, options); // 在 ForestTrainer.cpp 中定义,进行训练，并且在训练完成后返回一个 Forest 对象
+  Forest forest = RcppUtilities::train_forest(trainer, data, options, train_time_budget); // 在 ForestTrainer.cpp 中定义,进行训练，并且在训练完成后返回一个 Forest 对象
 
   std::vector<Prediction> predictions;
   if (compute_oob_predictions) {
@@ -68,17 +89,229 @@ Rcpp::List regression_train(const Rcpp::NumericMatrix& train_matrix,
   return RcppUtilities::create_forest_object(forest, predictions);
 }
 
+// Tuned parameters are passed as one value per candidate, the others as a single value.
+template<typename T>
+static T get_candidate_value(const std::vector<T>& values, size_t candidate, const std::string& name) {
+  if (values.size() == 1) {
+    return values[0];
+  } else if (candidate < values.size()) {
+    return values[candidate];
+  }
+  throw std::runtime_error("Tuning parameter " + name + " has fewer values than there are candidates.");
+}
+
+// [[Rcpp::export]]
+Rcpp::NumericVector regression_tune(const Rcpp::NumericMatrix& train_matrix,
+                                    const Rcpp::List& train_columns,
+                                    const Rcpp::NumericMatrix& virtual_features,
+                                    size_t outcome_index,
+                                    size_t sample_weight_index,
+                                    bool use_sample_weights,
+                                    size_t series_index,
+                                    bool use_series,
+                                    bool equal_series_allocation,
+                                    std::vector<unsigned int> mtry,
+                                    unsigned int num_trees,
+                                    std::vector<unsigned int> min_node_size,
+                                    std::vector<double> sample_fraction,
+                                    bool honesty,
+                                    std::vector<double> honesty_fraction,
+                                    std::vector<bool> honesty_prune_leaves,
+                                    size_t nonlapping_block_size,
+                                    std::vector<double> alpha,
+                                    std::vector<double> imbalance_penalty,
+                                    std::vector<size_t> clusters,
+                                    unsigned int samples_per_cluster,
+                                    unsigned int num_threads,
+                                    unsigned int seed,
+                                    size_t honesty_method,
+                                    unsigned int num_random_thresholds,
+                                    unsigned int max_num_thresholds,
+                                    size_t min_quantile_node_size) {
+  SplitValueOptions split_value_options(num_random_thresholds, max_num_thresholds, min_quantile_node_size);
+  ForestTrainer trainer = regression_trainer(split_value_options);
+  ForestPredictor predictor = regression_predictor(1);
+
+  Data data = RcppUtilities::convert_data(train_matrix, train_columns);
+  RcppUtilities::add_virtual_columns(data, virtual_features);
+  data.set_outcome_index(outcome_index);
+  if (use_sample_weights) {
+    data.set_weight_index(sample_weight_index);
+  }
+  if (use_series) {
+    data.set_series_index(series_index);
+  }
+
+  size_t num_candidates = std::max({mtry.size(), min_node_size.size(), sample_fraction.size(),
+                                    honesty_fraction.size(), honesty_prune_leaves.size(),
+                                    alpha.size(), imbalance_penalty.size()});
+
+  // Every candidate forest is grown on a single thread; the tuner runs the candidates concurrently.
+  std::vector<ForestOptions> candidates;
+  candidates.reserve(num_candidates);
+  for (size_t i = 0; i < num_candidates; i++) {
+    candidates.emplace_back(num_trees, nonlapping_block_size,
+        get_candidate_value(sample_fraction, i, "sample.fraction"),
+        get_candidate_value(mtry, i, "mtry"),
+        get_candidate_value(min_node_size, i, "min.node.size"),
+        honesty,
+        get_candidate_value(honesty_fraction, i, "honesty.fraction"),
+        get_candidate_value(honesty_prune_leaves, i, "honesty.prune.leaves"),
+        get_candidate_value(alpha, i, "alpha"),
+        get_candidate_value(imbalance_penalty, i, "imbalance.penalty"),
+        1, seed, clusters, samples_per_cluster, honesty_method, equal_series_allocation, 1);
+  }
+
+  ForestTuner tuner(trainer, predictor);
+  std::vector<double> errors = tuner.compute_errors(data, candidates, ForestOptions::validate_num_threads(num_threads));
+  return Rcpp::NumericVector(errors.begin(), errors.end());
+}
+
+// [[Rcpp::export]]
+Rcpp::List regression_backtest(const Rcpp::NumericMatrix& train_matrix,
+                               const Rcpp::List& train_columns,
+                               const Rcpp::NumericMatrix& virtual_features,
+                               size_t outcome_index,
+                               size_t sample_weight_index,
+                               bool use_sample_weights,
+                               size_t series_index,
+                               bool use_series,
+                               bool equal_series_allocation,
+                               std::vector<size_t> train_end,
+                               std::vector<size_t> horizon,
+                               size_t window_size,
+                               unsigned int mtry,
+                               unsigned int num_trees,
+                               unsigned int min_node_size,
+                               double sample_fraction,
+                               bool honesty,
+                               double honesty_fraction,
+                               bool honesty_prune_leaves,
+                               size_t nonlapping_block_size,
+                               double alpha,
+                               double imbalance_penalty,
+                               unsigned int num_threads,
+                               unsigned int seed,
+                               size_t honesty_method) {
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(1);
+
+  Data data = RcppUtilities::convert_data(train_matrix, train_columns);
+  RcppUtilities::add_virtual_columns(data, virtual_features);
+  data.set_outcome_index(outcome_index);
+  if (use_sample_weights) {
+    data.set_weight_index(sample_weight_index);
+  }
+  if (use_series) {
+    data.set_series_index(series_index);
+  }
+
+  std::vector<std::pair<size_t, size_t>> origins;
+  for (size_t i = 0; i < train_end.size(); i++) {
+    origins.emplace_back(train_end[i], get_candidate_value(horizon, i, "horizon"));
+  }
+
+  ForestOptions options(num_trees, nonlapping_block_size, sample_fraction, mtry, min_node_size, honesty,
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, std::vector<size_t>(), 0, honesty_method, equal_series_allocation, 1);
+  Backtester backtester(trainer, predictor);
+  std::vector<BacktestFold> folds = backtester.backtest(data, origins, options, window_size);
+
+  // One row per forecast, with 1-based origin and row indices.
+  std::vector<size_t> origin;
+  std::vector<size_t> row;
+  std::vector<double> predictions;
+  std::vector<double> errors;
+  for (size_t i = 0; i < folds.size(); i++) {
+    const BacktestFold& fold = folds[i];
+    for (size_t j = 0; j < fold.get_errors().size(); j++) {
+      origin.push_back(i + 1);
+      row.push_back(fold.get_train_end() + j + 1);
+      predictions.push_back(fold.get_predictions()[j].get_predictions()[0]);
+      errors.push_back(fold.get_errors()[j]);
+    }
+  }
+
+  Rcpp::List result;
+  result.push_back(origin, "origin");
+  result.push_back(row, "row");
+  result.push_back(predictions, "predictions");
+  result.push_back(errors, "errors");
+  return result;
+}
+
+// [[Rcpp::export]]
+Rcpp::List regression_train_batch(const Rcpp::NumericMatrix& train_matrix,
+                                  const Rcpp::List& train_columns,
+                                  size_t outcome_index,
+                                  size_t sample_weight_index,
+                                  bool use_sample_weights,
+                                  std::vector<size_t> row_begin,
+                                  std::vector<size_t> row_end,
+                                  std::vector<unsigned int> mtry,
+                                  unsigned int num_trees,
+                                  std::vector<unsigned int> min_node_size,
+                                  std::vector<double> sample_fraction,
+                                  bool honesty,
+                                  double honesty_fraction,
+                                  bool honesty_prune_leaves,
+                                  size_t nonlapping_block_size,
+                                  double alpha,
+                                  double imbalance_penalty,
+                                  unsigned int num_threads,
+                                  unsigned int seed,
+                                  size_t honesty_method) {
+  ForestTrainer trainer = regression_trainer();
+
+  Data data = RcppUtilities::convert_data(train_matrix, train_columns);
+  data.set_outcome_index(outcome_index);
+  if (use_sample_weights) {
+    data.set_weight_index(sample_weight_index);
+  }
+
+  // Every forest is grown on a single thread; the batch trainer runs the forests concurrently.
+  std::vector<std::pair<size_t, size_t>> row_ranges;
+  std::vector<ForestOptions> options;
+  for (size_t i = 0; i < row_begin.size(); i++) {
+    row_ranges.emplace_back(row_begin[i], row_end[i]);
+    options.emplace_back(num_trees, nonlapping_block_size,
+        get_candidate_value(sample_fraction, i, "sample.fraction"),
+        get_candidate_value(mtry, i, "mtry"),
+        get_candidate_value(min_node_size, i, "min.node.size"),
+        honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty,
+        1, seed, std::vector<size_t>(), 0, honesty_method, false, 1);
+  }
+
+  ForestBatchTrainer batch_trainer(trainer);
+  std::vector<Forest> forests = batch_trainer.train(data, row_ranges, options,
+                                                    ForestOptions::validate_num_threads(num_threads));
+
+  Rcpp::List result;
+  for (Forest& forest : forests) {
+    result.push_back(RcppUtilities::serialize_forest(forest));
+  }
+  return result;
+}
+
 // [[Rcpp::export]]
 Rcpp::List regression_predict(const Rcpp::List& forest_object,
                               const Rcpp::NumericMatrix& train_matrix,
+                              const Rcpp::List& train_columns,
                               size_t outcome_index,
+                              size_t series_index,
+                              bool use_series,
                               const Rcpp::NumericMatrix& test_matrix,
+                              const Rcpp::NumericMatrix& virtual_features,
                               unsigned int num_threads,
                               unsigned int estimate_variance) {
-  Data train_data = RcppUtilities::convert_data(train_matrix);
+  Data train_data = RcppUtilities::convert_data(train_matrix, train_columns);
+  RcppUtilities::add_virtual_columns(train_data, virtual_features);
   train_data.set_outcome_index(outcome_index);
+  if (use_series) {
+    train_data.set_series_index(series_index);
+  }
 
   Data data = RcppUtilities::convert_data(test_matrix);
+  RcppUtilities::add_virtual_columns(data, virtual_features);
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
 
   ForestPredictor predictor = regression_predictor(num_threads);
@@ -90,11 +323,20 @@ Rcpp::List regression_predict(const Rcpp::List& forest_object,
 // [[Rcpp::export]]
 Rcpp::List regression_predict_oob(const Rcpp::List& forest_object,
                                   const Rcpp::NumericMatrix& train_matrix,
+                                  const Rcpp::List& train_columns,
+                                  const Rcpp::NumericMatrix& virtual_features,
                                   size_t outcome_index,
+                                  size_t series_index,
+                                  bool use_series,
                                   unsigned int num_threads,
                                   bool estimate_variance) {
-  Data data = RcppUtilities::convert_data(train_matrix);
+  Data data = RcppUtilities::convert_data(train_matrix, train_columns);
+  RcppUtilities::add_virtual_columns(data, virtual_features);
   data.set_outcome_index(outcome_index);
+  // The virtual columns must lag within each series, as in training.
+  if (use_series) {
+    data.set_series_index(series_index);
+  }
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
 
@@ -135,7 +377,7 @@ Rcpp::List ll_regression_train(const Rcpp::NumericMatrix& train_matrix,
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
                         honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
-  Forest forest = trainer.train(data, options);
+  Forest forest = RcppUtilities::train_forest(trainer, data, options);
 
   std::vector<Prediction> predictions;
   return RcppUtilities::create_forest_object(forest, predictions);
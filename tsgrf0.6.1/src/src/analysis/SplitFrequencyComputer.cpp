@@ -38,8 +38,11 @@ std::vector<std::vector<size_t>> SplitFrequencyComputer::compute(const Forest& f
           continue;
         }
 
+        // Virtual feature columns are numbered after all data columns, and are not counted.
         size_t variable = tree->get_split_vars().at(node);
-        result[depth][variable]++;
+        if (variable < num_variables) {
+          result[depth][variable]++;
+        }
 
         next_level.push_back(child_nodes[0][node]);
         next_level.push_back(child_nodes[1][node]);
@@ -0,0 +1,224 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "ColumnFile.h"
+
+namespace grf {
+
+namespace {
+
+const char MAGIC[8] = {'T', 'S', 'G', 'R', 'F', 'C', 'O', 'L'};
+const uint32_t VERSION = 2;
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// The fixed part of the header, followed by one ColumnEntry per column and the column names.
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t num_rows;
+  uint64_t num_cols;
+};
+
+struct ColumnEntry {
+  uint64_t offset;
+  uint32_t type;
+  uint32_t name_length;
+  uint32_t has_nan;
+  uint32_t reserved;
+};
+
+size_t value_size(ColumnType type) {
+  return type == COLUMN_FLOAT32 ? sizeof(float) : sizeof(double);
+}
+
+size_t align(size_t offset) {
+  return (offset + ColumnFile::COLUMN_ALIGNMENT - 1) / ColumnFile::COLUMN_ALIGNMENT * ColumnFile::COLUMN_ALIGNMENT;
+}
+
+} // namespace
+
+ColumnFile::ColumnFile(const std::string& file_name):
+    file(file_name),
+    contents(file.get_contents()),
+    size(file.get_size()),
+    num_rows(0) {
+  read_header();
+}
+
+void ColumnFile::read_header() {
+  FileHeader header;
+  if (size < sizeof(header)) {
+    throw std::runtime_error("Invalid column file: the header is truncated.");
+  }
+  std::memcpy(&header, contents, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw std::runtime_error("Invalid column file: unrecognized format.");
+  }
+  if (header.version != VERSION) {
+    throw std::runtime_error("Unsupported column file version.");
+  }
+  if (header.byte_order != BYTE_ORDER_MARK) {
+    throw std::runtime_error("The column file was written with a different byte order.");
+  }
+  num_rows = header.num_rows;
+
+  size_t position = sizeof(header);
+  size_t names_position = position + header.num_cols * sizeof(ColumnEntry);
+  if (header.num_cols > size / sizeof(ColumnEntry) || names_position > size) {
+    throw std::runtime_error("Invalid column file: the header is truncated.");
+  }
+  for (size_t col = 0; col < header.num_cols; col++) {
+    ColumnEntry entry;
+    std::memcpy(&entry, contents + position, sizeof(entry));
+    position += sizeof(entry);
+
+    if (entry.type != COLUMN_FLOAT64 && entry.type != COLUMN_FLOAT32) {
+      throw std::runtime_error("Invalid column file: unknown column type.");
+    }
+    ColumnType type = static_cast<ColumnType>(entry.type);
+    if (entry.offset % value_size(type) != 0 || entry.offset > size
+        || num_rows > (size - entry.offset) / value_size(type)) {
+      throw std::runtime_error("Invalid column file: a column lies outside the file.");
+    }
+    if (entry.name_length > size - names_position) {
+      throw std::runtime_error("Invalid column file: the header is truncated.");
+    }
+    column_types.push_back(type);
+    column_offsets.push_back(entry.offset);
+    column_has_nan.push_back(entry.has_nan != 0);
+    column_names.emplace_back(contents + names_position, entry.name_length);
+    names_position += entry.name_length;
+  }
+}
+
+Data ColumnFile::get_data() const {
+  Data data(std::vector<const double*>(), num_rows);
+  for (size_t col = 0; col < column_types.size(); col++) {
+    const char* column = contents + column_offsets[col];
+    if (column_types[col] == COLUMN_FLOAT32) {
+      data.add_external_column(reinterpret_cast<const float*>(column), column_has_nan[col]);
+    } else {
+      data.add_external_column(reinterpret_cast<const double*>(column), column_has_nan[col]);
+    }
+  }
+  return data;
+}
+
+size_t ColumnFile::get_num_rows() const {
+  return num_rows;
+}
+
+size_t ColumnFile::get_num_cols() const {
+  return column_types.size();
+}
+
+const std::vector<std::string>& ColumnFile::get_column_names() const {
+  return column_names;
+}
+
+size_t ColumnFile::get_column_index(const std::string& name) const {
+  for (size_t col = 0; col < column_names.size(); col++) {
+    if (column_names[col] == name) {
+      return col;
+    }
+  }
+  throw std::runtime_error("The column file has no column named " + name + ".");
+}
+
+void write_column_file(const std::string& file_name,
+                       const Data& data,
+                       const std::vector<std::string>& column_names,
+                       const std::vector<ColumnType>& column_types) {
+  size_t num_rows = data.get_num_rows();
+  size_t num_cols = data.get_num_cols();
+  if (!column_names.empty() && column_names.size() != num_cols) {
+    throw std::runtime_error("There must be one column name per column.");
+  }
+  if (!column_types.empty() && column_types.size() != num_cols) {
+    throw std::runtime_error("There must be one column type per column.");
+  }
+
+  FileHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.byte_order = BYTE_ORDER_MARK;
+  header.num_rows = num_rows;
+  header.num_cols = num_cols;
+
+  std::vector<ColumnEntry> entries(num_cols);
+  size_t offset = sizeof(header) + num_cols * sizeof(ColumnEntry);
+  for (size_t col = 0; col < num_cols; col++) {
+    entries[col].name_length = column_names.empty() ? 0 : column_names[col].size();
+    entries[col].has_nan = 0;
+    entries[col].reserved = 0;
+    offset += entries[col].name_length;
+  }
+  for (size_t col = 0; col < num_cols; col++) {
+    ColumnType type = column_types.empty() ? COLUMN_FLOAT64 : column_types[col];
+    offset = align(offset);
+    entries[col].offset = offset;
+    entries[col].type = type;
+    offset += num_rows * value_size(type);
+  }
+
+  std::ofstream output_file(file_name, std::ios::binary | std::ios::trunc);
+  if (!output_file.good()) {
+    throw std::runtime_error("Could not open output file.");
+  }
+  // The NaN flags are only known once the columns are written, so the entries are
+  // written again at the end.
+  output_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output_file.write(reinterpret_cast<const char*>(entries.data()), num_cols * sizeof(ColumnEntry));
+  for (const std::string& name : column_names) {
+    output_file.write(name.data(), name.size());
+  }
+
+  std::vector<char> padding(ColumnFile::COLUMN_ALIGNMENT, 0);
+  std::vector<double> values(num_rows);
+  std::vector<float> float_values(num_rows);
+  for (size_t col = 0; col < num_cols; col++) {
+    size_t position = output_file.tellp();
+    output_file.write(padding.data(), entries[col].offset - position);
+    if (entries[col].type == COLUMN_FLOAT32) {
+      for (size_t row = 0; row < num_rows; row++) {
+        float_values[row] = static_cast<float>(data.get(row, col));
+        entries[col].has_nan |= std::isnan(float_values[row]);
+      }
+      output_file.write(reinterpret_cast<const char*>(float_values.data()), num_rows * sizeof(float));
+    } else {
+      for (size_t row = 0; row < num_rows; row++) {
+        values[row] = data.get(row, col);
+        entries[col].has_nan |= std::isnan(values[row]);
+      }
+      output_file.write(reinterpret_cast<const char*>(values.data()), num_rows * sizeof(double));
+    }
+  }
+  output_file.seekp(sizeof(header));
+  output_file.write(reinterpret_cast<const char*>(entries.data()), num_cols * sizeof(ColumnEntry));
+  if (!output_file.good()) {
+    throw std::runtime_error("Could not write the column file.");
+  }
+}
+
+} // namespace grf
@@ -0,0 +1,102 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_COLUMNFILE_H_
+#define GRF_COLUMNFILE_H_
+
+#include <string>
+#include <vector>
+
+#include "Data.h"
+#include "globals.h"
+#include "MappedFile.h"
+
+namespace grf {
+
+enum ColumnType {
+  COLUMN_FLOAT64 = 0,
+  COLUMN_FLOAT32 = 1
+};
+
+/**
+ * A column major binary data file that is memory mapped instead of parsed.
+ *
+ * The file starts with a header holding the dimensions, and the type, offset, name and
+ * whether it contains NaN of each column, followed by the columns themselves, each
+ * aligned to COLUMN_ALIGNMENT bytes. Values are stored in the byte order of the machine
+ * that wrote the file.
+ *
+ * Data returned by get_data reads the columns straight from the mapping, so a file
+ * needs no parse step and no copy on the heap, and the pages of a file opened by
+ * several processes are shared through the page cache. The NaN flags of the header
+ * are trusted, so opening a file reads none of its columns. The Data must not outlive
+ * this object.
+ */
+class ColumnFile {
+public:
+  explicit ColumnFile(const std::string& file_name);
+
+  /**
+   * Data over all columns of the file, in file order.
+   */
+  Data get_data() const;
+
+  size_t get_num_rows() const;
+
+  size_t get_num_cols() const;
+
+  const std::vector<std::string>& get_column_names() const;
+
+  /**
+   * The index of the column called `name`; throws if there is no such column.
+   */
+  size_t get_column_index(const std::string& name) const;
+
+  static const size_t COLUMN_ALIGNMENT = 64;
+
+private:
+  MappedFile file;
+  const char* contents;
+  size_t size;
+
+  size_t num_rows;
+  std::vector<ColumnType> column_types;
+  std::vector<size_t> column_offsets;
+  std::vector<std::string> column_names;
+  std::vector<bool> column_has_nan;
+
+  void read_header();
+
+  DISALLOW_COPY_AND_ASSIGN(ColumnFile);
+};
+
+/**
+ * Writes all columns of `data` (including virtual columns) to a column file.
+ *
+ * @param file_name: the file to write.
+ * @param data: the data to write.
+ * @param column_names: one name per column, or empty to leave the columns unnamed.
+ * @param column_types: one type per column, or empty to store all columns as COLUMN_FLOAT64.
+ */
+void write_column_file(const std::string& file_name,
+                       const Data& data,
+                       const std::vector<std::string>& column_names,
+                       const std::vector<ColumnType>& column_types);
+
+} // namespace grf
+
+#endif /* GRF_COLUMNFILE_H_ */
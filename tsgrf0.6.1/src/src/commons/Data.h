@@ -18,35 +18,74 @@
 #ifndef GRF_DATA_H_
 #define GRF_DATA_H_
 
+#include <algorithm>
+#include <memory>
 #include <set>
 #include <vector>
 
 #include "Eigen/Dense"
 #include "globals.h"
+#include "VirtualColumn.h"
 #include "optional/optional.hpp"
 
 namespace grf {
 
 /**
  * Data wrapper for GRF.
- * Serves as a read-only (immutable) wrapper of a column major (Fortran order)
- * array accessed through its pointer (data_ptr). This class does not own
+ * Serves as a read-only (immutable) wrapper of column major (Fortran order)
+ * storage accessed through one pointer per column. This class does not own
  * data.
  *
- * The GRF data model is a contiguous array [X, Y, z, ...] of covariates X,
- * outcomes Y, and other optional variables z.
+ * The GRF data model is a table [X, Y, z, ...] of covariates X, outcomes Y,
+ * and other optional variables z. The columns can live in one contiguous
+ * array, or in independent buffers (e.g. a covariate matrix and separate
+ * outcome and weight vectors), which avoids concatenating them into a copy.
+ *
+ * Columns can be stored in single precision, which halves the memory traffic
+ * of split scans and tree traversal on wide covariate matrices. Values are
+ * always read as doubles, so sums over outcomes keep double precision. Data
+ * used for prediction should store the covariates in the same precision as
+ * the training data, so that values equal to a split value are sent the same way.
+ *
+ * Wide, mostly zero covariates can be stored as sparse columns in compressed sparse
+ * column (CSC) form. Reading a value then takes a binary search over the nonzeros of
+ * its column, and get_all_values sorts only the nonzero values of a node. During a
+ * split search, SortedSamplesCache reads the values of the node from the nonzeros instead.
  *
  */
 class Data {
 public:
+  /**
+   * Data over a column major array. Like all constructors and the methods that add
+   * stored columns, it scans each column once for NaN (see has_nan): if the storage is
+   * modified after it is wrapped, call refresh_nan_flags.
+   */
   Data(const double* data_ptr, size_t num_rows, size_t num_cols);
 
+  /**
+   * Data over independent column buffers.
+   *
+   * @param columns: one pointer per column, each to `num_rows` values.
+   * @param num_rows: the number of rows.
+   *
+   * The columns are scanned for NaN, see has_nan.
+   */
+  Data(const std::vector<const double*>& columns, size_t num_rows);
+
+  /**
+   * Data over a column major array in single precision, such as a covariate
+   * matrix. Outcomes and other variables can be added in double precision
+   * with add_external_column. The columns are scanned for NaN, see has_nan.
+   */
+  Data(const float* data_ptr, size_t num_rows, size_t num_cols);
+
   /**
    * Convenience constructors for unit test.
    * The intended use case is with storage (data vector) mananaged
    * elsewhere, i.e.
    * std::vector<double> data_vector {1, 2, 3, etc};
    * Data grf_data_wrapper(data_vector, num_rows, num_cols);
+   * The columns are scanned for NaN, so call refresh_nan_flags after modifying the vector.
    */
   Data(const std::vector<double>& data, size_t num_rows, size_t num_cols);
 
@@ -70,6 +109,83 @@ public:
 
   void set_censor_index(size_t index);
 
+  /**
+   * Marks column `index` as the series ID of each row, for panel data holding several
+   * time series. The rows of each series are taken in data order, and may be interleaved
+   * with the rows of other series. Block sampling then draws blocks within each series,
+   * so that no block straddles two series, and virtual columns lag within each series.
+   *
+   * Virtual columns are indexed by rows of the full data, so data with virtual columns
+   * must have its series index set on the full data, not on a row range.
+   */
+  void set_series_index(size_t index);
+
+  /**
+   * Adds a virtual column with a lag or rolling-window statistic of column `source`,
+   * see VirtualColumn. Its values are computed on demand instead of being stored.
+   *
+   * Virtual columns come after all columns of the data array, and can be used as split
+   * variables like any other covariate. Data used for prediction must therefore have the
+   * same number of columns as the training data, and define the same virtual columns.
+   *
+   * If a series index is set, before or after the virtual column is added, the lag and
+   * window are counted within the series of each row.
+   *
+   * @param source: the data column the feature is derived from.
+   * @param lag: the number of rows the window ends before the current row.
+   * @param window: the number of rows in the window (1 for a plain lag).
+   * @param statistic: the statistic of the window, ignored if the window is a single row.
+   * @return: the column index of the virtual column.
+   */
+  size_t add_virtual_column(size_t source, size_t lag, size_t window, RollingStatistic statistic);
+
+  /**
+   * Adds a column that is stored outside the data array, such as a derived outcome
+   * computed during training. It comes after the existing columns, and must be added
+   * before any virtual column. Only the full data (not a row range) can be extended
+   * this way.
+   *
+   * @param column: one value per row, which must outlive this data and its copies.
+   * @return: the column index of the new column.
+   */
+  size_t add_external_column(const double* column);
+
+  size_t add_external_column(const float* column);
+
+  /**
+   * Same as above, for a column whose has_nan flag is already known (such as a column
+   * of a ColumnFile), which avoids reading the whole column when it is added.
+   */
+  size_t add_external_column(const double* column, bool has_nan);
+
+  size_t add_external_column(const float* column, bool has_nan);
+
+  /**
+   * Adds `num_cols` sparse columns in compressed sparse column form, with zero-based
+   * int indices as in R's dgCMatrix. Like external columns they come after the existing
+   * columns, must be added before any virtual column, and the storage must outlive
+   * this data and its copies.
+   *
+   * @param column_starts: `num_cols + 1` offsets; the nonzeros of column j are the entries
+   * column_starts[j], ..., column_starts[j + 1] - 1 of `row_indices` and `values`.
+   * @param row_indices: the row of each nonzero, increasing within each column.
+   * @param values: the value of each nonzero.
+   * @param num_cols: the number of sparse columns.
+   * @return: the column index of the first sparse column.
+   */
+  size_t add_sparse_columns(const int* column_starts,
+                            const int* row_indices,
+                            const double* values,
+                            size_t num_cols);
+
+  /**
+   * A view of the contiguous rows [begin, end) of this data.
+   *
+   * The view shares the storage and the variable indices (outcome, treatment, weights, ...)
+   * of this object, so no data is copied. Row 0 of the view is row `begin` of this data.
+   */
+  Data get_row_range(size_t begin, size_t end) const;
+
   /**
    * Sorts and gets the unique values in `samples` at variable `var`.
    *
@@ -88,6 +204,14 @@ public:
                                      std::vector<size_t>& sorted_samples,
                                      const std::vector<size_t>& samples, size_t var) const;
 
+  /**
+   * Same as get_all_values, with `all_values` already holding the value of each sample
+   * in `samples`, e.g. read from the nonzeros of a sparse column.
+   */
+  std::vector<size_t> sort_all_values(std::vector<double>& all_values,
+                                      std::vector<size_t>& sorted_samples,
+                                      const std::vector<size_t>& samples, size_t var) const;
+
   size_t get_num_cols() const;
 
   size_t get_num_rows() const;
@@ -98,6 +222,12 @@ public:
 
   const std::set<size_t>& get_disallowed_split_variables() const;
 
+  /**
+   * The rows of each series in data order, or an empty vector if no
+   * series index is set.
+   */
+  const std::vector<std::vector<size_t>>& get_series_rows() const;
+
   double get_outcome(size_t row) const;
 
   Eigen::VectorXd get_outcomes(size_t row) const;
@@ -110,6 +240,11 @@ public:
 
   double get_weight(size_t row) const;
 
+  /**
+   * Whether a weight column is set. Otherwise every sample has weight 1.
+   */
+  bool has_weights() const;
+
   double get_causal_survival_numerator(size_t row) const;
 
   double get_causal_survival_denominator(size_t row) const;
@@ -118,10 +253,64 @@ public:
 
   double get(size_t row, size_t col) const;
 
+  /**
+   * Whether column `col` may contain NaN. This is exact for stored columns, which are
+   * scanned once when they are added, and always true for virtual columns. Splitting and
+   * prediction skip the missing value checks on columns without NaN.
+   *
+   * The flags assume that the storage is not modified after it is wrapped: call
+   * refresh_nan_flags if values are changed afterwards.
+   */
+  bool has_nan(size_t col) const;
+
+  /**
+   * Scans every stored column for NaN again, after its storage has been modified in place.
+   * The flags of a row range cover the full data, so they are the same as those of the full data.
+   */
+  void refresh_nan_flags();
+
+  /**
+   * Whether column `col` is stored as a sparse column.
+   */
+  bool is_sparse(size_t col) const;
+
+  /**
+   * The number of stored nonzeros of sparse column `col` over the full data.
+   */
+  size_t get_num_nonzero(size_t col) const;
+
+  /**
+   * Calls `f(row, value)` for each stored nonzero of sparse column `col` within the
+   * rows of this data, in increasing order of the rows. Stored values may be zero or NaN.
+   */
+  template <typename F>
+  void for_each_nonzero(size_t col, F f) const;
+
 private:
-  const double* data_ptr;
+  // A stored column, in double or single precision: exactly one of the
+  // pointers is set, to the value at row 0 of this data. A sparse column
+  // instead holds the rows (of the full data) and values of its nonzeros.
+  struct Column {
+    const double* values;
+    const float* float_values;
+    const int* sparse_rows;
+    size_t num_nonzero;
+    bool has_nan;
+  };
+
+  std::vector<Column> columns;
   size_t num_rows;
-  size_t num_cols;
+  // The number of rows of the full data, which is larger than
+  // num_rows for a row range.
+  size_t full_num_rows;
+  // The row of the full data that is row 0 of this data.
+  size_t row_offset;
+
+  // Virtual columns are shared by row range views, and are indexed by
+  // rows of the full array so that lags can reach back before a view.
+  std::vector<std::shared_ptr<const VirtualColumn>> virtual_columns;
+  // The series of the full data, set with the series index on the full data.
+  std::shared_ptr<const SeriesLayout> series_layout;
 
   std::set<size_t> disallowed_split_variables;
   nonstd::optional<std::vector<size_t>> outcome_index;
@@ -131,6 +320,15 @@ private:
   nonstd::optional<size_t> causal_survival_numerator_index;
   nonstd::optional<size_t> causal_survival_denominator_index;
   nonstd::optional<size_t> censor_index;
+  nonstd::optional<size_t> series_index;
+
+  void compute_series_rows();
+
+  size_t add_column(const Column& column);
+
+  double get_sparse(const Column& column, size_t row) const;
+
+  std::vector<std::vector<size_t>> series_rows;
 };
 
 // inline appropriate getters
@@ -170,6 +368,10 @@ inline double Data::get_weight(size_t row) const {
   }
 }
 
+inline bool Data::has_weights() const {
+  return weight_index.has_value();
+}
+
 inline double Data::get_causal_survival_numerator(size_t row) const {
   return get(row, causal_survival_numerator_index.value());
 }
@@ -183,7 +385,45 @@ inline bool Data::is_failure(size_t row) const {
 }
 
 inline double Data::get(size_t row, size_t col) const {
-  return data_ptr[col * num_rows + row];
+  if (col < columns.size()) {
+    const Column& column = columns[col];
+    if (column.sparse_rows == nullptr) {
+      return column.values != nullptr ? column.values[row] : column.float_values[row];
+    }
+    return get_sparse(column, row);
+  }
+  return virtual_columns[col - columns.size()]->get(row_offset + row);
+}
+
+inline bool Data::has_nan(size_t col) const {
+  return col >= columns.size() || columns[col].has_nan;
+}
+
+inline bool Data::is_sparse(size_t col) const {
+  return col < columns.size() && columns[col].sparse_rows != nullptr;
+}
+
+inline size_t Data::get_num_nonzero(size_t col) const {
+  return columns[col].num_nonzero;
+}
+
+template <typename F>
+void Data::for_each_nonzero(size_t col, F f) const {
+  const Column& column = columns[col];
+  const int* end = column.sparse_rows + column.num_nonzero;
+  // Sparse rows are rows of the full data, so a row range only reads its own rows.
+  const int* first = std::lower_bound(column.sparse_rows, end, static_cast<int>(row_offset));
+  const int* last = std::lower_bound(first, end, static_cast<int>(row_offset + num_rows));
+  for (const int* row = first; row != last; ++row) {
+    f(static_cast<size_t>(*row) - row_offset, column.values[row - column.sparse_rows]);
+  }
+}
+
+inline double Data::get_sparse(const Column& column, size_t row) const {
+  int full_row = static_cast<int>(row_offset + row);
+  const int* end = column.sparse_rows + column.num_nonzero;
+  const int* nonzero = std::lower_bound(column.sparse_rows, end, full_row);
+  return nonzero != end && *nonzero == full_row ? column.values[nonzero - column.sparse_rows] : 0.0;
 }
 
 } // namespace grf
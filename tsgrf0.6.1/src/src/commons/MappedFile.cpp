@@ -0,0 +1,84 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+namespace grf {
+
+MappedFile::MappedFile(const std::string& file_name):
+    contents(nullptr),
+    size(0) {
+#ifdef _WIN32
+  std::ifstream input_file(file_name, std::ios::binary | std::ios::ate);
+  if (!input_file.good()) {
+    throw std::runtime_error("Could not open input file.");
+  }
+  size = input_file.tellg();
+  buffer.resize((size + sizeof(double) - 1) / sizeof(double));
+  input_file.seekg(0);
+  input_file.read(reinterpret_cast<char*>(buffer.data()), size);
+  contents = reinterpret_cast<const char*>(buffer.data());
+#else
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open input file.");
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    throw std::runtime_error("Could not read the size of the input file.");
+  }
+  size = file_stat.st_size;
+  if (size > 0) {
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("Could not memory map the input file.");
+    }
+    contents = static_cast<const char*>(mapping);
+  }
+  close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+  if (contents != nullptr) {
+    munmap(const_cast<char*>(contents), size);
+  }
+#endif
+}
+
+const char* MappedFile::get_contents() const {
+  return contents;
+}
+
+size_t MappedFile::get_size() const {
+  return size;
+}
+
+} // namespace grf
@@ -0,0 +1,53 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_MAPPEDFILE_H_
+#define GRF_MAPPEDFILE_H_
+
+#include <string>
+#include <vector>
+
+#include "globals.h"
+
+namespace grf {
+
+/**
+ * A read-only view of the contents of a file, memory mapped and shared through
+ * the page cache. On Windows the file is read into an 8-byte aligned buffer instead.
+ */
+class MappedFile {
+public:
+  explicit MappedFile(const std::string& file_name);
+
+  ~MappedFile();
+
+  const char* get_contents() const;
+
+  size_t get_size() const;
+
+private:
+  const char* contents;
+  size_t size;
+  // Set if the file was read into memory rather than mapped.
+  std::vector<double> buffer;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+} // namespace grf
+
+#endif /* GRF_MAPPEDFILE_H_ */
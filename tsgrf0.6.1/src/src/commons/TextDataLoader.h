@@ -0,0 +1,56 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_TEXTDATALOADER_H_
+#define GRF_TEXTDATALOADER_H_
+
+#include <string>
+#include <vector>
+
+#include "globals.h"
+
+namespace grf {
+
+/**
+ * Loads a delimited text file into column major storage, in parallel.
+ *
+ * The file is memory mapped and split into chunks on line boundaries. Each chunk is
+ * parsed by its own task on the shared thread pool, straight into the columns of the
+ * result, so the file is read once and never copied into per-line strings.
+ *
+ * Fields are separated by `delimiter`; a space delimiter means any run of spaces
+ * and tabs, like load_data. Surrounding blanks and quotes are trimmed, blank lines
+ * are skipped, and empty fields and the tokens NA and NaN are read as NaN (missing
+ * values). Throws on the first malformed line (a wrong number of fields or a value
+ * that is not a number), reporting its line number.
+ *
+ * @param file_name: the file to load.
+ * @param delimiter: the field separator, such as ',' or ' '.
+ * @param header: whether the first line holds the column names.
+ * @param num_threads: the number of chunks parsed at once (0 for the hardware concurrency).
+ * @param column_names: filled with the column names, or left empty if there is no header.
+ * @return the values and the {number of rows, number of columns}, as load_data.
+ */
+std::pair<std::vector<double>, std::vector<size_t>> load_text_data(const std::string& file_name,
+                                                                   char delimiter,
+                                                                   bool header,
+                                                                   uint num_threads,
+                                                                   std::vector<std::string>& column_names);
+
+} // namespace grf
+
+#endif /* GRF_TEXTDATALOADER_H_ */
@@ -0,0 +1,57 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <memory>
+#include <stdexcept>
+
+#include "commons/ThreadPool.h"
+#include "forest/ForestBatchTrainer.h"
+
+namespace grf {
+
+ForestBatchTrainer::ForestBatchTrainer(const ForestTrainer& trainer):
+    trainer(trainer) {}
+
+std::vector<Forest> ForestBatchTrainer::train(const Data& data,
+                                              const std::vector<std::pair<size_t, size_t>>& row_ranges,
+                                              const std::vector<ForestOptions>& options,
+                                              uint num_threads) const {
+  if (options.size() != 1 && options.size() != row_ranges.size()) {
+    throw std::runtime_error("A batch of forests needs one set of options, or one per row range.");
+  }
+  for (const auto& range : row_ranges) {
+    if (range.first >= range.second || range.second > data.get_num_rows()) {
+      throw std::runtime_error("Each row range of a batch of forests must be nonempty and lie within the data.");
+    }
+  }
+
+  std::vector<std::unique_ptr<Forest>> trained(row_ranges.size());
+  ThreadPool::get_instance().parallel_for(row_ranges.size(), num_threads, [&](size_t i) {
+    Data job_data = data.get_row_range(row_ranges[i].first, row_ranges[i].second);
+    const ForestOptions& job_options = options.size() == 1 ? options[0] : options[i];
+    trained[i] = std::unique_ptr<Forest>(new Forest(trainer.train(job_data, job_options)));
+  });
+
+  std::vector<Forest> forests;
+  forests.reserve(trained.size());
+  for (auto& forest : trained) {
+    forests.push_back(std::move(*forest));
+  }
+  return forests;
+}
+
+} // namespace grf
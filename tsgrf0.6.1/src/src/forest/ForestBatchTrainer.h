@@ -0,0 +1,62 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_FORESTBATCHTRAINER_H
+#define GRF_FORESTBATCHTRAINER_H
+
+#include <utility>
+#include <vector>
+
+#include "forest/Forest.h"
+#include "forest/ForestOptions.h"
+#include "forest/ForestTrainer.h"
+
+namespace grf {
+
+/**
+ * Trains many independent forests, one per row range of a shared data set.
+ *
+ * This is meant for workloads with one small forest per series, where training
+ * each forest through its own call would mostly pay per-call overhead. Every job
+ * trains on a row range view of the shared data, so the rows are not copied. The
+ * jobs are run concurrently on the shared thread pool; the trees of each forest
+ * are in turn grown with the number of threads of the job's options, on the same
+ * pool. For many small forests that should usually be 1.
+ */
+class ForestBatchTrainer {
+public:
+  ForestBatchTrainer(const ForestTrainer& trainer);
+
+  /**
+   * @param data: the shared training data.
+   * @param row_ranges: the rows [begin, end) of the data each forest is trained on.
+   * @param options: the options of each forest, or a single set of options used for all of them.
+   * @param num_threads: the number of forests trained at once.
+   * @return the trained forests, in the order of `row_ranges`.
+   */
+  std::vector<Forest> train(const Data& data,
+                            const std::vector<std::pair<size_t, size_t>>& row_ranges,
+                            const std::vector<ForestOptions>& options,
+                            uint num_threads) const;
+
+private:
+  const ForestTrainer& trainer;
+};
+
+} // namespace grf
+
+#endif //GRF_FORESTBATCHTRAINER_H
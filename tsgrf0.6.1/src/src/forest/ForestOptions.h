@@ -41,7 +41,9 @@ public:
                 uint random_seed,
                 const std::vector<size_t>& sample_clusters,
                 uint samples_per_cluster,
-                size_t honesty_method);
+                size_t honesty_method,
+                bool equal_series_allocation,
+                size_t ci_group_size);
   
   ForestOptions(uint num_trees,
                 size_t ci_group_size,
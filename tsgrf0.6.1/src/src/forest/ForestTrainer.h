@@ -27,6 +27,7 @@
 #include "tree/Tree.h"
 #include "tree/TreeTrainer.h"
 #include "forest/Forest.h"
+#include "forest/TrainingControl.h"
 #include "ForestOptions.h"
 
 namespace grf {
@@ -39,17 +40,28 @@ public:
 
   Forest train(const Data& data, const ForestOptions& options) const;
 
+  /**
+   * Trains a forest while honoring the time budget, cancellation flag and
+   * progress callback of `control`. If training is stopped early, the returned
+   * forest contains the trees that were completed so far.
+   */
+  Forest train(const Data& data,
+               const ForestOptions& options,
+               TrainingControl& control) const;
+
 private:
   // 训练一系列树
   std::vector<std::unique_ptr<Tree>> train_trees(const Data& data,
-                                                 const ForestOptions& options) const;
+                                                 const ForestOptions& options,
+                                                 TrainingControl& control) const;
 
   // 批量训练树
   std::vector<std::unique_ptr<Tree>> train_batch(
       size_t start,
       size_t num_trees,
       const Data& data,
-      const ForestOptions& options) const;
+      const ForestOptions& options,
+      TrainingControl& control) const;
 
   // 训练单棵树
   std::unique_ptr<Tree> train_tree(const Data& data,
@@ -63,6 +75,14 @@ private:
                                                     const ForestOptions& options,
                                                     int block_group_size) const;
 
+  void draw_blocks(const Data& data,
+                   RandomSampler& sampler,
+                   const ForestOptions& options,
+                   double sample_fraction,
+                   std::vector<size_t>& clusters,
+                   std::vector<std::vector<size_t>>& blocks_clusters,
+                   int block_group_size) const;
+
   TreeTrainer tree_trainer;
 };
 
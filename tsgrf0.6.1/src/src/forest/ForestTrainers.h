@@ -19,6 +19,7 @@
 #define GRF_FORESTTRAINERS_H
 
 #include "forest/ForestTrainer.h"
+#include "splitting/SplitValueOptions.h"
 
 namespace grf {
 
@@ -30,13 +31,20 @@ ForestTrainer multi_causal_trainer(size_t num_treatments,
                                    bool stabilize_splits,
                                    const std::vector<double>& gradient_weights = {});
 
-ForestTrainer quantile_trainer(const std::vector<double>& quantiles);
+/**
+ * The quantile, probability, regression and multi-regression trainers can cap the
+ * candidate split values per variable, see SplitValueOptions.
+ */
+ForestTrainer quantile_trainer(const std::vector<double>& quantiles,
+                               const SplitValueOptions& split_value_options = SplitValueOptions());
 
-ForestTrainer probability_trainer(size_t num_classes);
+ForestTrainer probability_trainer(size_t num_classes,
+                                  const SplitValueOptions& split_value_options = SplitValueOptions());
 
-ForestTrainer regression_trainer();
+ForestTrainer regression_trainer(const SplitValueOptions& split_value_options = SplitValueOptions());
 
-ForestTrainer multi_regression_trainer(size_t num_outcomes);
+ForestTrainer multi_regression_trainer(size_t num_outcomes,
+                                       const SplitValueOptions& split_value_options = SplitValueOptions());
 
 ForestTrainer ll_regression_trainer(double split_lambda,
                                    bool weight_penalty,
@@ -0,0 +1,67 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <stdexcept>
+
+#include "commons/ThreadPool.h"
+#include "forest/ForestTuner.h"
+
+namespace grf {
+
+ForestTuner::ForestTuner(const ForestTrainer& trainer,
+                         const ForestPredictor& predictor):
+    trainer(trainer),
+    predictor(predictor) {}
+
+std::vector<double> ForestTuner::compute_errors(const Data& data,
+                                                const std::vector<ForestOptions>& candidates,
+                                                uint num_threads) const {
+  std::vector<double> errors(candidates.size(), NAN);
+
+  ThreadPool::get_instance().parallel_for(candidates.size(), num_threads, [&](size_t i) {
+    // Inadmissible parameter draws (e.g. a very small sample fraction) are expected
+    // while tuning, and simply leave a missing error for this candidate.
+    try {
+      Forest forest = trainer.train(data, candidates[i]);
+      std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+      errors[i] = mean_debiased_error(predictions);
+    } catch (const std::runtime_error&) {
+      errors[i] = NAN;
+    }
+  });
+
+  return errors;
+}
+
+double ForestTuner::mean_debiased_error(const std::vector<Prediction>& predictions) {
+  double sum = 0;
+  size_t num_finite = 0;
+  for (const Prediction& prediction : predictions) {
+    if (!prediction.contains_error_estimates()) {
+      continue;
+    }
+    double error = prediction.get_error_estimates()[0];
+    if (!std::isnan(error)) {
+      sum += error;
+      num_finite++;
+    }
+  }
+  return num_finite > 0 ? sum / num_finite : NAN;
+}
+
+} // namespace grf
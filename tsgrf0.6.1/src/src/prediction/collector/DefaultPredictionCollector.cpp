@@ -15,10 +15,10 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
-#include <future>
 #include <stdexcept>
 
 #include "prediction/collector/DefaultPredictionCollector.h"
+#include "commons/ThreadPool.h"
 #include "commons/utility.h"
 
 namespace grf {
@@ -40,34 +40,22 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions(
   std::vector<uint> thread_ranges;
   split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
 
-  std::vector<std::future<std::vector<Prediction>>> futures;
-  futures.reserve(thread_ranges.size());
-
   std::vector<Prediction> predictions;
   predictions.reserve(num_samples);
 
-  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
-    size_t start_index = thread_ranges[i];
-    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
-
-    futures.push_back(std::async(std::launch::async,
-                                 &DefaultPredictionCollector::collect_predictions_batch,
-                                 this,
-                                 std::ref(forest),
-                                 std::ref(train_data),
-                                 std::ref(data),
-                                 std::ref(leaf_nodes_by_tree),
-                                 std::ref(valid_trees_by_sample),
-                                 estimate_variance,
-                                 start_index,
-                                 num_samples_batch));
-  }
+  size_t num_batches = thread_ranges.size() - 1;
+  std::vector<std::vector<Prediction>> predictions_by_batch(num_batches);
+  ThreadPool::get_instance().parallel_for(num_batches, num_threads, [&](size_t batch) {
+    size_t start_index = thread_ranges[batch];
+    size_t num_samples_batch = thread_ranges[batch + 1] - start_index;
+    predictions_by_batch[batch] = collect_predictions_batch(forest, train_data, data, leaf_nodes_by_tree,
+        valid_trees_by_sample, estimate_variance, start_index, num_samples_batch);
+  });
 
-  for (auto& future : futures) {
-    std::vector<Prediction> thread_predictions = future.get();
+  for (auto& batch_predictions : predictions_by_batch) {
     predictions.insert(predictions.end(),
-                       std::make_move_iterator(thread_predictions.begin()),
-                       std::make_move_iterator(thread_predictions.end()));
+                       std::make_move_iterator(batch_predictions.begin()),
+                       std::make_move_iterator(batch_predictions.end()));
   }
 
   return predictions;
@@ -16,10 +16,9 @@
  #-------------------------------------------------------------------------------*/
 
 #include "TreeTraverser.h"
+#include "commons/ThreadPool.h"
 #include "commons/utility.h"
 
-#include <future>
-
 namespace grf {
 
 TreeTraverser::TreeTraverser(uint num_threads) :
@@ -37,28 +36,18 @@ std::vector<std::vector<size_t>> TreeTraverser::get_leaf_nodes(
   std::vector<uint> thread_ranges;
   split_sequence(thread_ranges, 0, static_cast<uint>(num_trees - 1), num_threads);
 
-  std::vector<std::future<
-      std::vector<std::vector<size_t>>>> futures;
-  futures.reserve(thread_ranges.size());
-
-  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
-    size_t start_index = thread_ranges[i];
-    size_t num_trees_batch = thread_ranges[i + 1] - start_index;
-    futures.push_back(std::async(std::launch::async,
-                                 &TreeTraverser::get_leaf_node_batch,
-                                 this,
-                                 start_index,
-                                 num_trees_batch,
-                                 std::ref(forest),
-                                 std::ref(data),
-                                 oob_prediction));
-  }
+  size_t num_batches = thread_ranges.size() - 1;
+  std::vector<std::vector<std::vector<size_t>>> leaf_nodes_by_batch(num_batches);
+  ThreadPool::get_instance().parallel_for(num_batches, num_threads, [&](size_t batch) {
+    size_t start_index = thread_ranges[batch];
+    size_t num_trees_batch = thread_ranges[batch + 1] - start_index;
+    leaf_nodes_by_batch[batch] = get_leaf_node_batch(start_index, num_trees_batch, forest, data, oob_prediction);
+  });
 
-  for (auto& future : futures) {
-    std::vector<std::vector<size_t>> leaf_nodes = future.get();
+  for (auto& leaf_nodes : leaf_nodes_by_batch) {
     leaf_nodes_by_tree.insert(leaf_nodes_by_tree.end(),
-                              leaf_nodes.begin(),
-                              leaf_nodes.end());
+                              std::make_move_iterator(leaf_nodes.begin()),
+                              std::make_move_iterator(leaf_nodes.end()));
   }
 
   return leaf_nodes_by_tree;
@@ -30,7 +30,17 @@ bool InstrumentalRelabelingStrategy::relabel(
     const std::vector<size_t>& samples,
     const Data& data,
     Eigen::ArrayXXd& responses_by_sample) const {
+  if (data.has_weights()) {
+    return relabel_internal<SampleWeights>(samples, data, responses_by_sample);
+  }
+  return relabel_internal<UnitWeights>(samples, data, responses_by_sample);
+}
 
+template <class Weights>
+bool InstrumentalRelabelingStrategy::relabel_internal(
+    const std::vector<size_t>& samples,
+    const Data& data,
+    Eigen::ArrayXXd& responses_by_sample) const {
   // Prepare the relevant averages.
   double sum_weight = 0.0;
 
@@ -39,7 +49,7 @@ bool InstrumentalRelabelingStrategy::relabel(
   double total_instrument = 0.0;
 
   for (size_t sample : samples) {
-    double weight = data.get_weight(sample);
+    double weight = Weights::get(data, sample);
     total_outcome += weight * data.get_outcome(sample);
     total_treatment += weight * data.get_treatment(sample);
     total_instrument += weight * data.get_instrument(sample);
@@ -61,7 +71,7 @@ bool InstrumentalRelabelingStrategy::relabel(
   double denominator = 0.0;
 
   for (size_t sample : samples) {
-    double weight = data.get_weight(sample);
+    double weight = Weights::get(data, sample);
     double outcome = data.get_outcome(sample);
     double treatment = data.get_treatment(sample);
     double instrument = data.get_instrument(sample);
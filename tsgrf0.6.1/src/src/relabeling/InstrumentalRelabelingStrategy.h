@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "commons/Data.h"
+#include "commons/SampleWeights.h"
 #include "relabeling/RelabelingStrategy.h"
 #include "tree/Tree.h"
 
@@ -40,6 +41,15 @@ public:
   DISALLOW_COPY_AND_ASSIGN(InstrumentalRelabelingStrategy);
 
 private:
+  /**
+   * Instantiated for weighted (SampleWeights) and unweighted (UnitWeights) data.
+   */
+  template <class Weights>
+  bool relabel_internal(
+      const std::vector<size_t>& samples,
+      const Data& data,
+      Eigen::ArrayXXd& responses_by_sample) const;
+
   double reduced_form_weight;
 };
 
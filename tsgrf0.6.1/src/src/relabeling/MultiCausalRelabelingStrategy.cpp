@@ -36,6 +36,26 @@ bool MultiCausalRelabelingStrategy::relabel(
     const std::vector<size_t>& samples,
     const Data& data,
     Eigen::ArrayXXd& responses_by_sample) const {
+  switch (data.get_num_treatments()) {
+    case 1:
+      return relabel_internal<1>(samples, data, responses_by_sample);
+    case 2:
+      return relabel_internal<2>(samples, data, responses_by_sample);
+    case 3:
+      return relabel_internal<3>(samples, data, responses_by_sample);
+    case 4:
+      return relabel_internal<4>(samples, data, responses_by_sample);
+    default:
+      return relabel_internal<Eigen::Dynamic>(samples, data, responses_by_sample);
+  }
+}
+
+template <int NUM_TREATMENTS>
+bool MultiCausalRelabelingStrategy::relabel_internal(
+    const std::vector<size_t>& samples,
+    const Data& data,
+    Eigen::ArrayXXd& responses_by_sample) const {
+  typedef Eigen::Matrix<double, NUM_TREATMENTS, NUM_TREATMENTS> TreatmentMatrix;
 
   // Prepare the relevant averages.
   size_t num_samples = samples.size();
@@ -46,10 +66,10 @@ bool MultiCausalRelabelingStrategy::relabel(
   }
 
   Eigen::MatrixXd Y_centered = Eigen::MatrixXd(num_samples, num_outcomes);
-  Eigen::MatrixXd W_centered = Eigen::MatrixXd(num_samples, num_treatments);
+  Eigen::Matrix<double, Eigen::Dynamic, NUM_TREATMENTS> W_centered(num_samples, num_treatments);
   Eigen::VectorXd weights = Eigen::VectorXd(num_samples);
   Eigen::VectorXd Y_mean = Eigen::VectorXd::Zero(num_outcomes);
-  Eigen::VectorXd W_mean = Eigen::VectorXd::Zero(num_treatments);
+  Eigen::Matrix<double, NUM_TREATMENTS, 1> W_mean = Eigen::Matrix<double, NUM_TREATMENTS, 1>::Zero(num_treatments);
   double sum_weight = 0;
   for (size_t i = 0; i < num_samples; i++) {
     size_t sample = samples[i];
@@ -72,17 +92,17 @@ bool MultiCausalRelabelingStrategy::relabel(
     return true;
   }
 
-  Eigen::MatrixXd WW_bar = W_centered.transpose() * weights.asDiagonal() * W_centered; // [num_treatments X num_treatments]
+  TreatmentMatrix WW_bar = W_centered.transpose() * weights.asDiagonal() * W_centered; // [num_treatments X num_treatments]
   // Calculate the treatment effect.
   // This condition number check works fine in practice - there may be more robust ways.
   if (equal_doubles(WW_bar.determinant(), 0.0, 1.0e-10)) {
     return true;
   }
 
-  Eigen::MatrixXd A_p_inv = WW_bar.inverse();
-  Eigen::MatrixXd beta = A_p_inv * W_centered.transpose() * weights.asDiagonal() * Y_centered; // [num_treatments X num_outcomes]
+  TreatmentMatrix A_p_inv = WW_bar.inverse();
+  Eigen::Matrix<double, NUM_TREATMENTS, Eigen::Dynamic> beta = A_p_inv * W_centered.transpose() * weights.asDiagonal() * Y_centered; // [num_treatments X num_outcomes]
 
-  Eigen::MatrixXd rho_weight = W_centered * A_p_inv.transpose(); // [num_samples X num_treatments]
+  Eigen::Matrix<double, Eigen::Dynamic, NUM_TREATMENTS> rho_weight = W_centered * A_p_inv.transpose(); // [num_samples X num_treatments]
   Eigen::MatrixXd residual = Y_centered - W_centered * beta; // [num_samples X num_outcomes]
 
   // Create the new outcomes, eq (20) in https://arxiv.org/pdf/1610.01271.pdf
@@ -58,6 +58,25 @@ public:
                        std::vector<size_t>& samples,
                        std::vector<std::vector<size_t>>& blocks, 
                        int block_group_size);
+
+  /**
+   * Block sampling for panel data: draws contiguous blocks of rows within each series,
+   * so that no block straddles two series. The block size of a series follows its length
+   * as in single-series block sampling. Each series contributes about `sample_fraction`
+   * of its rows, or, with SamplingOptions#get_equal_series_allocation, the same number of
+   * rows as every other series.
+   *
+   * @param series The rows of each series, in time order (see Data#get_series_rows).
+   * @param sample_fraction The fraction of rows that should be in the sample.
+   * @param samples An empty vector, filled with the rows of all drawn blocks.
+   * @param blocks An empty vector, filled with the rows of each drawn block.
+   * @param block_group_size The block size parameter, as in single-series block sampling.
+   */
+  void sample_series_blocks(const std::vector<std::vector<size_t>>& series,
+                            double sample_fraction,
+                            std::vector<size_t>& samples,
+                            std::vector<std::vector<size_t>>& blocks,
+                            int block_group_size);
   /**
    * If clustering is enabled, draws the appropriate number of samples from the provided
    * cluster IDs. Otherwise, it is a no-op: we simply return the passed in 'cluster IDs',
@@ -158,6 +177,11 @@ public:
 
   size_t sample_poisson(size_t mean);
 
+  /**
+   * Draw a number uniformly from the interval [min, max).
+   */
+  double sample_uniform(double min, double max);
+
 private:
  /**
   * Create numbers from 0 to n_all-1, then shuffle and select the first 'size' elements.
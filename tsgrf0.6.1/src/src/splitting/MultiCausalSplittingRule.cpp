@@ -57,15 +57,45 @@ bool MultiCausalSplittingRule::find_best_split(const Data& data,
                                                std::vector<size_t>& split_vars,
                                                std::vector<double>& split_values,
                                                std::vector<bool>& send_missing_left) {
+  switch (num_treatments) {
+    case 1:
+      return find_best_split_internal<1>(data, node, possible_split_vars, responses_by_sample, samples,
+                                         split_vars, split_values, send_missing_left);
+    case 2:
+      return find_best_split_internal<2>(data, node, possible_split_vars, responses_by_sample, samples,
+                                         split_vars, split_values, send_missing_left);
+    case 3:
+      return find_best_split_internal<3>(data, node, possible_split_vars, responses_by_sample, samples,
+                                         split_vars, split_values, send_missing_left);
+    case 4:
+      return find_best_split_internal<4>(data, node, possible_split_vars, responses_by_sample, samples,
+                                         split_vars, split_values, send_missing_left);
+    default:
+      return find_best_split_internal<Eigen::Dynamic>(data, node, possible_split_vars, responses_by_sample, samples,
+                                                      split_vars, split_values, send_missing_left);
+  }
+}
+
+template <int NUM_TREATMENTS>
+bool MultiCausalSplittingRule::find_best_split_internal(const Data& data,
+                                                        size_t node,
+                                                        const std::vector<size_t>& possible_split_vars,
+                                                        const Eigen::ArrayXXd& responses_by_sample,
+                                                        const std::vector<std::vector<size_t>>& samples,
+                                                        std::vector<size_t>& split_vars,
+                                                        std::vector<double>& split_values,
+                                                        std::vector<bool>& send_missing_left) {
+  typedef Eigen::Array<double, NUM_TREATMENTS, 1> TreatmentArray;
+  typedef Eigen::Array<int, NUM_TREATMENTS, 1> TreatmentCounts;
   size_t num_samples = samples[node].size();
 
   // Precompute the sum of outcomes in this node.
   double weight_sum_node = 0.0;
   Eigen::ArrayXd sum_node = Eigen::ArrayXd::Zero(response_length);
-  Eigen::ArrayXd sum_node_w = Eigen::ArrayXd::Zero(num_treatments);
-  Eigen::ArrayXd sum_node_w_squared = Eigen::ArrayXd::Zero(num_treatments);
+  TreatmentArray sum_node_w = TreatmentArray::Zero(num_treatments);
+  TreatmentArray sum_node_w_squared = TreatmentArray::Zero(num_treatments);
   // Allocate W-array and re-use to avoid expensive copy-inducing calls to `data.get_treatments`
-  Eigen::ArrayXXd treatments = Eigen::ArrayXXd(num_samples, num_treatments);
+  Eigen::Array<double, Eigen::Dynamic, NUM_TREATMENTS> treatments(num_samples, num_treatments);
   for (size_t i = 0; i < num_samples; i++) {
     size_t sample = samples[node][i];
     double sample_weight = data.get_weight(sample);
@@ -73,17 +103,17 @@ bool MultiCausalSplittingRule::find_best_split(const Data& data,
     sum_node += sample_weight * responses_by_sample.row(sample);
     treatments.row(i) = data.get_treatments(sample);
 
-    sum_node_w += sample_weight * treatments.row(i);
-    sum_node_w_squared += sample_weight * treatments.row(i).square();
+    sum_node_w += sample_weight * treatments.row(i).transpose();
+    sum_node_w_squared += sample_weight * treatments.row(i).transpose().square();
   }
 
-  Eigen::ArrayXd size_node = sum_node_w_squared - sum_node_w.square() / weight_sum_node;
-  Eigen::ArrayXd min_child_size = size_node * alpha;
+  TreatmentArray size_node = sum_node_w_squared - sum_node_w.square() / weight_sum_node;
+  TreatmentArray min_child_size = size_node * alpha;
 
-  Eigen::ArrayXd mean_w_node = sum_node_w / weight_sum_node;
-  Eigen::ArrayXi num_node_small_w = Eigen::ArrayXi::Zero(num_treatments);
+  TreatmentArray mean_w_node = sum_node_w / weight_sum_node;
+  TreatmentCounts num_node_small_w = TreatmentCounts::Zero(num_treatments);
   for (size_t i = 0; i < num_samples; i++) {
-    num_node_small_w += (treatments.row(i).transpose() < mean_w_node).cast<int>();
+    num_node_small_w += (treatments.row(i).transpose() < mean_w_node).template cast<int>();
   }
 
   // Initialize the variables to track the best split variable.
@@ -94,7 +124,7 @@ bool MultiCausalSplittingRule::find_best_split(const Data& data,
 
   // For all possible split variables
   for (auto& var : possible_split_vars) {
-    find_best_split_value(data, node, var, num_samples, weight_sum_node, sum_node, mean_w_node, num_node_small_w,
+    find_best_split_value<NUM_TREATMENTS>(data, node, var, num_samples, weight_sum_node, sum_node, mean_w_node, num_node_small_w,
                           sum_node_w, sum_node_w_squared, min_child_size, treatments, best_value,
                           best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
   }
@@ -111,18 +141,19 @@ bool MultiCausalSplittingRule::find_best_split(const Data& data,
   return false;
 }
 
+template <int NUM_TREATMENTS>
 void MultiCausalSplittingRule::find_best_split_value(const Data& data,
                                                      size_t node,
                                                      size_t var,
                                                      size_t num_samples,
                                                      double weight_sum_node,
                                                      const Eigen::ArrayXd& sum_node,
-                                                     const Eigen::ArrayXd& mean_node_w,
-                                                     const Eigen::ArrayXi& num_node_small_w,
-                                                     const Eigen::ArrayXd& sum_node_w,
-                                                     const Eigen::ArrayXd& sum_node_w_squared,
-                                                     const Eigen::ArrayXd& min_child_size,
-                                                     const Eigen::ArrayXXd& treatments,
+                                                     const Eigen::Array<double, NUM_TREATMENTS, 1>& mean_node_w,
+                                                     const Eigen::Array<int, NUM_TREATMENTS, 1>& num_node_small_w,
+                                                     const Eigen::Array<double, NUM_TREATMENTS, 1>& sum_node_w,
+                                                     const Eigen::Array<double, NUM_TREATMENTS, 1>& sum_node_w_squared,
+                                                     const Eigen::Array<double, NUM_TREATMENTS, 1>& min_child_size,
+                                                     const Eigen::Array<double, Eigen::Dynamic, NUM_TREATMENTS>& treatments,
                                                      double& best_value,
                                                      size_t& best_var,
                                                      double& best_decrease,
@@ -131,7 +162,8 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
                                                      const std::vector<std::vector<size_t>>& samples) {
   std::vector<double> possible_split_values;
   std::vector<size_t> sorted_samples;
-  std::vector<size_t> index = data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  std::vector<size_t> index = get_all_values(data, sorted_samples_cache, possible_split_values, sorted_samples,
+                                             samples[node], var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -149,10 +181,12 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
   size_t n_missing = 0;
   double weight_sum_missing = 0;
   Eigen::ArrayXd sum_missing = Eigen::ArrayXd::Zero(response_length);
-  Eigen::ArrayXd sum_w_missing = Eigen::ArrayXd::Zero(num_treatments);
-  Eigen::ArrayXd sum_w_squared_missing = Eigen::ArrayXd::Zero(num_treatments);
-  Eigen::ArrayXi num_small_w_missing = Eigen::ArrayXi::Zero(num_treatments);
+  Eigen::Array<double, NUM_TREATMENTS, 1> sum_w_missing = Eigen::Array<double, NUM_TREATMENTS, 1>::Zero(num_treatments);
+  Eigen::Array<double, NUM_TREATMENTS, 1> sum_w_squared_missing = Eigen::Array<double, NUM_TREATMENTS, 1>::Zero(num_treatments);
+  Eigen::Array<int, NUM_TREATMENTS, 1> num_small_w_missing = Eigen::Array<int, NUM_TREATMENTS, 1>::Zero(num_treatments);
 
+  // Columns without NaN skip the missing value checks.
+  bool has_nan = data.has_nan(var);
   size_t split_index = 0;
   for (size_t i = 0; i < num_samples - 1; i++) {
     size_t sample = sorted_samples[i];
@@ -161,28 +195,31 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
     double sample_value = data.get(sample, var);
     double sample_weight = data.get_weight(sample);
 
-    if (std::isnan(sample_value)) {
+    if (has_nan && std::isnan(sample_value)) {
       weight_sum_missing += sample_weight;
       sum_missing += sample_weight * responses_by_sample.row(sample);
       ++n_missing;
 
-      sum_w_missing += sample_weight * treatments.row(sort_index);
-      sum_w_squared_missing += sample_weight * treatments.row(sort_index).square();
-      num_small_w_missing += (treatments.row(sort_index).transpose() < mean_node_w).cast<int>();
+      sum_w_missing += sample_weight * treatments.row(sort_index).transpose();
+      sum_w_squared_missing += sample_weight * treatments.row(sort_index).transpose().square();
+      num_small_w_missing += (treatments.row(sort_index).transpose() < mean_node_w).template cast<int>();
     } else {
       weight_sums[split_index] += sample_weight;
       sums.row(split_index) += sample_weight * responses_by_sample.row(sample);
       ++counter[split_index];
 
-      sums_w.row(split_index) += sample_weight * treatments.row(sort_index);
-      sums_w_squared.row(split_index) += sample_weight * treatments.row(sort_index).square();
-      num_small_w.row(split_index) += (treatments.row(sort_index).transpose() < mean_node_w).cast<int>();
+      sums_w.row(split_index).template head<NUM_TREATMENTS>(num_treatments) +=
+        sample_weight * treatments.row(sort_index);
+      sums_w_squared.row(split_index).template head<NUM_TREATMENTS>(num_treatments) +=
+        sample_weight * treatments.row(sort_index).square();
+      num_small_w.row(split_index).template head<NUM_TREATMENTS>(num_treatments) +=
+        (treatments.row(sort_index).transpose() < mean_node_w).template cast<int>().transpose();
     }
 
     double next_sample_value = data.get(next_sample, var);
     // if the next sample value is different, including the transition (..., NaN, Xij, ...)
     // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
+    if (sample_value != next_sample_value && (!has_nan || !std::isnan(next_sample_value))) {
       ++split_index;
     }
   }
@@ -190,9 +227,9 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
   size_t n_left = n_missing;
   double weight_sum_left = weight_sum_missing;
   Eigen::Ref<Eigen::ArrayXd> sum_left = sum_missing;
-  Eigen::Ref<Eigen::ArrayXd> sum_left_w = sum_w_missing;
-  Eigen::Ref<Eigen::ArrayXd> sum_left_w_squared = sum_w_squared_missing;
-  Eigen::Ref<Eigen::ArrayXi> num_left_small_w = num_small_w_missing;
+  Eigen::Array<double, NUM_TREATMENTS, 1>& sum_left_w = sum_w_missing;
+  Eigen::Array<double, NUM_TREATMENTS, 1>& sum_left_w_squared = sum_w_squared_missing;
+  Eigen::Array<int, NUM_TREATMENTS, 1>& num_left_small_w = num_small_w_missing;
 
   // Compute decrease of impurity for each possible split
   for (bool send_left : {true, false}) {
@@ -219,10 +256,10 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
 
       n_left += counter[i];
       weight_sum_left += weight_sums[i];
-      num_left_small_w += num_small_w.row(i);
-      sum_left += sums.row(i);
-      sum_left_w += sums_w.row(i);
-      sum_left_w_squared += sums_w_squared.row(i);
+      num_left_small_w += num_small_w.row(i).transpose().template head<NUM_TREATMENTS>(num_treatments);
+      sum_left += sums.row(i).transpose();
+      sum_left_w += sums_w.row(i).transpose().template head<NUM_TREATMENTS>(num_treatments);
+      sum_left_w_squared += sums_w_squared.row(i).transpose().template head<NUM_TREATMENTS>(num_treatments);
 
       // Skip this split if the left child does not contain enough
       // w values below and above the parent's mean.
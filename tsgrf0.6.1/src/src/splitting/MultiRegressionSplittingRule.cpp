@@ -16,18 +16,27 @@
  #-------------------------------------------------------------------------------*/
 
 #include <algorithm>
+#include <stdexcept>
 
 #include "MultiRegressionSplittingRule.h"
+#include "splitting/SplitValues.h"
 
 namespace grf {
 
 MultiRegressionSplittingRule::MultiRegressionSplittingRule(size_t max_num_unique_values,
                                                            double alpha,
                                                            double imbalance_penalty,
-                                                           size_t num_outcomes):
+                                                           size_t num_outcomes,
+                                                           const SplitValueOptions& split_value_options,
+                                                           RandomSampler* sampler):
     alpha(alpha),
     imbalance_penalty(imbalance_penalty),
-    num_outcomes(num_outcomes) {
+    num_outcomes(num_outcomes),
+    split_value_options(split_value_options),
+    sampler(sampler) {
+  if (split_value_options.get_num_random_thresholds() > 0 && sampler == nullptr) {
+    throw std::runtime_error("Random split values need the tree's sampler.");
+  }
   this->counter = new size_t[max_num_unique_values];
   this->sums = Eigen::ArrayXXd(max_num_unique_values, num_outcomes);
   this->weight_sums = new double[max_num_unique_values];
@@ -50,17 +59,62 @@ bool MultiRegressionSplittingRule::find_best_split(const Data& data,
                                                    std::vector<size_t>& split_vars,
                                                    std::vector<double>& split_values,
                                                    std::vector<bool>& send_missing_left) {
+  if (data.has_weights()) {
+    return find_best_split_internal<SampleWeights>(data, node, possible_split_vars, responses_by_sample, samples,
+                                                 split_vars, split_values, send_missing_left);
+  }
+  return find_best_split_internal<UnitWeights>(data, node, possible_split_vars, responses_by_sample, samples,
+                                               split_vars, split_values, send_missing_left);
+}
 
+template <class Weights>
+bool MultiRegressionSplittingRule::find_best_split_internal(const Data& data,
+                                                            size_t node,
+                                                            const std::vector<size_t>& possible_split_vars,
+                                                            const Eigen::ArrayXXd& responses_by_sample,
+                                                            const std::vector<std::vector<size_t>>& samples,
+                                                            std::vector<size_t>& split_vars,
+                                                            std::vector<double>& split_values,
+                                                            std::vector<bool>& send_missing_left) {
+  switch (num_outcomes) {
+    case 1:
+      return find_best_split_values<Weights, 1>(data, node, possible_split_vars, responses_by_sample, samples,
+                                                split_vars, split_values, send_missing_left);
+    case 2:
+      return find_best_split_values<Weights, 2>(data, node, possible_split_vars, responses_by_sample, samples,
+                                                split_vars, split_values, send_missing_left);
+    case 3:
+      return find_best_split_values<Weights, 3>(data, node, possible_split_vars, responses_by_sample, samples,
+                                                split_vars, split_values, send_missing_left);
+    case 4:
+      return find_best_split_values<Weights, 4>(data, node, possible_split_vars, responses_by_sample, samples,
+                                                split_vars, split_values, send_missing_left);
+    default:
+      return find_best_split_values<Weights, Eigen::Dynamic>(data, node, possible_split_vars, responses_by_sample,
+                                                             samples, split_vars, split_values, send_missing_left);
+  }
+}
+
+template <class Weights, int NUM_OUTCOMES>
+bool MultiRegressionSplittingRule::find_best_split_values(const Data& data,
+                                                          size_t node,
+                                                          const std::vector<size_t>& possible_split_vars,
+                                                          const Eigen::ArrayXXd& responses_by_sample,
+                                                          const std::vector<std::vector<size_t>>& samples,
+                                                          std::vector<size_t>& split_vars,
+                                                          std::vector<double>& split_values,
+                                                          std::vector<bool>& send_missing_left) {
+  typedef Eigen::Array<double, NUM_OUTCOMES, 1> OutcomeArray;
   size_t size_node = samples[node].size();
   size_t min_child_size = std::max<size_t>(static_cast<size_t>(std::ceil(size_node * alpha)), 1uL);
 
   // Precompute the sum of outcomes in this node.
-  Eigen::ArrayXd sum_node = Eigen::ArrayXd::Zero(num_outcomes);
+  OutcomeArray sum_node = OutcomeArray::Zero(num_outcomes);
   double weight_sum_node = 0.0;
   for (auto& sample : samples[node]) {
-    double sample_weight = data.get_weight(sample);
+    double sample_weight = Weights::get(data, sample);
     weight_sum_node += sample_weight;
-    sum_node += sample_weight * responses_by_sample.row(sample);
+    sum_node += sample_weight * responses_by_sample.row(sample).transpose().template head<NUM_OUTCOMES>(num_outcomes);
   }
 
   // Initialize the variables to track the best split variable.
@@ -71,8 +125,9 @@ bool MultiRegressionSplittingRule::find_best_split(const Data& data,
 
   // For all possible split variables
   for (auto& var : possible_split_vars) {
-    find_best_split_value(data, node, var, weight_sum_node, sum_node, size_node, min_child_size,
-                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    find_best_split_value<Weights, NUM_OUTCOMES>(data, node, var, weight_sum_node, sum_node, size_node,
+                                                 min_child_size, best_value, best_var, best_decrease,
+                                                 best_send_missing_left, responses_by_sample, samples);
   }
 
   // Stop if no good split found
@@ -87,10 +142,11 @@ bool MultiRegressionSplittingRule::find_best_split(const Data& data,
   return false;
 }
 
+template <class Weights, int NUM_OUTCOMES>
 void MultiRegressionSplittingRule::find_best_split_value(const Data& data,
                                                     size_t node, size_t var,
                                                     double weight_sum_node,
-                                                    const Eigen::ArrayXd& sum_node,
+                                                    const Eigen::Array<double, NUM_OUTCOMES, 1>& sum_node,
                                                     size_t size_node,
                                                     size_t min_child_size,
                                                     double& best_value, size_t& best_var,
@@ -100,7 +156,9 @@ void MultiRegressionSplittingRule::find_best_split_value(const Data& data,
   // sorted_samples: the node samples in increasing order (may contain duplicated Xij). Length: size_node
   std::vector<double> possible_split_values;
   std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  std::vector<size_t> buckets;
+  bool bucketed = get_split_values(data, samples[node], var, split_value_options, sampler, sorted_samples_cache,
+                                   possible_split_values, sorted_samples, buckets);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -113,37 +171,59 @@ void MultiRegressionSplittingRule::find_best_split_value(const Data& data,
   sums.topRows(num_splits).setZero(); // Sets the first num_splits rows to zeros.
   size_t n_missing = 0;
   double weight_sum_missing = 0;
-  Eigen::ArrayXd sum_missing = Eigen::ArrayXd::Zero(num_outcomes);
+  Eigen::Array<double, NUM_OUTCOMES, 1> sum_missing = Eigen::Array<double, NUM_OUTCOMES, 1>::Zero(num_outcomes);
 
   // Fill counter and sums buckets
-  size_t split_index = 0;
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
-    double sample_weight = data.get_weight(sample);
-
-    if (std::isnan(sample_value)) {
-      weight_sum_missing += sample_weight;
-      sum_missing += sample_weight * responses_by_sample.row(sample);
-      ++n_missing;
-    } else {
-      weight_sums[split_index] += sample_weight;
-      sums.row(split_index) += sample_weight * responses_by_sample.row(sample);
-      ++counter[split_index];
+  if (bucketed) {
+    for (size_t i = 0; i < size_node; i++) {
+      size_t sample = samples[node][i];
+      size_t bucket = buckets[i];
+      double sample_weight = Weights::get(data, sample);
+
+      if (bucket == MISSING_BUCKET) {
+        weight_sum_missing += sample_weight;
+        sum_missing += sample_weight * responses_by_sample.row(sample).transpose().template head<NUM_OUTCOMES>(num_outcomes);
+        ++n_missing;
+      } else if (bucket < num_splits) {
+        weight_sums[bucket] += sample_weight;
+        sums.row(bucket).template head<NUM_OUTCOMES>(num_outcomes) +=
+          sample_weight * responses_by_sample.row(sample).template head<NUM_OUTCOMES>(num_outcomes);
+        ++counter[bucket];
+      }
     }
+  } else {
+    // Columns without NaN skip the missing value checks.
+    bool has_nan = data.has_nan(var);
+    size_t split_index = 0;
+    for (size_t i = 0; i < size_node - 1; i++) {
+      size_t sample = sorted_samples[i];
+      size_t next_sample = sorted_samples[i + 1];
+      double sample_value = data.get(sample, var);
+      double sample_weight = Weights::get(data, sample);
+
+      if (has_nan && std::isnan(sample_value)) {
+        weight_sum_missing += sample_weight;
+        sum_missing += sample_weight * responses_by_sample.row(sample).transpose().template head<NUM_OUTCOMES>(num_outcomes);
+        ++n_missing;
+      } else {
+        weight_sums[split_index] += sample_weight;
+        sums.row(split_index).template head<NUM_OUTCOMES>(num_outcomes) +=
+          sample_weight * responses_by_sample.row(sample).template head<NUM_OUTCOMES>(num_outcomes);
+        ++counter[split_index];
+      }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
+      double next_sample_value = data.get(next_sample, var);
+      // if the next sample value is different, including the transition (..., NaN, Xij, ...)
+      // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
+      if (sample_value != next_sample_value && (!has_nan || !std::isnan(next_sample_value))) {
+        ++split_index;
+      }
     }
   }
 
   size_t n_left = n_missing;
   double weight_sum_left = weight_sum_missing;
-  Eigen::Ref<Eigen::ArrayXd> sum_left = sum_missing;
+  Eigen::Array<double, NUM_OUTCOMES, 1>& sum_left = sum_missing;
 
   // Compute decrease of impurity for each possible split
   for (bool send_left : {true, false}) {
@@ -167,7 +247,7 @@ void MultiRegressionSplittingRule::find_best_split_value(const Data& data,
 
       n_left += counter[i];
       weight_sum_left += weight_sums[i];
-      sum_left += sums.row(i);
+      sum_left += sums.row(i).transpose().template head<NUM_OUTCOMES>(num_outcomes);
 
       // Skip this split if one child is too small.
       if (n_left < min_child_size) {
@@ -19,6 +19,10 @@
 #define GRF_REGRESSIONSPLITTINGRULE_H
 
 #include "commons/Data.h"
+#include "commons/SampleWeights.h"
+#include "sampling/RandomSampler.h"
+#include "splitting/SplitValueOptions.h"
+#include "splitting/SplitScan.h"
 #include "splitting/SplittingRule.h"
 #include "tree/Tree.h"
 
@@ -26,9 +30,13 @@ namespace grf {
 
 class RegressionSplittingRule final: public SplittingRule {
 public:
+  // `sampler` draws the random split values, and is required if `split_value_options` asks for them.
   RegressionSplittingRule(size_t max_num_unique_values,
                           double alpha,
-                          double imbalance_penalty);
+                          double imbalance_penalty,
+                          uint num_threads,
+                          const SplitValueOptions& split_value_options = SplitValueOptions(),
+                          RandomSampler* sampler = nullptr);
 
   ~RegressionSplittingRule();
 
@@ -42,6 +50,20 @@ public:
                        std::vector<bool>& send_missing_left);
 
 private:
+  /**
+   * Instantiated for weighted (SampleWeights) and unweighted (UnitWeights) data.
+   */
+  template <class Weights>
+  bool find_best_split_internal(const Data& data,
+                                size_t node,
+                                const std::vector<size_t>& possible_split_vars,
+                                const Eigen::ArrayXXd& responses_by_sample,
+                                const std::vector<std::vector<size_t>>& samples,
+                                std::vector<size_t>& split_vars,
+                                std::vector<double>& split_values,
+                                std::vector<bool>& send_missing_left);
+
+  template <class Weights>
   void find_best_split_value(const Data& data,
                              size_t node,
                              size_t var,
@@ -54,7 +76,31 @@ private:
                              double& best_decrease,
                              bool& best_send_missing_left,
                              const Eigen::ArrayXXd& responses_by_sample,
-                             const std::vector<std::vector<size_t>>& samples);
+                             const std::vector<std::vector<size_t>>& samples,
+                             size_t* counter,
+                             double* sums,
+                             double* weight_sums,
+                             SplitScan& scan);
+
+  /**
+   * Evaluates the candidate variables of a large node concurrently on the shared thread pool.
+   * The per-variable results are reduced in variable order, so the chosen split is the same
+   * as the one found by evaluating the variables one after another.
+   */
+  template <class Weights>
+  void find_best_split_parallel(const Data& data,
+                                size_t node,
+                                const std::vector<size_t>& possible_split_vars,
+                                double weight_sum_node,
+                                double sum_node,
+                                size_t size_node,
+                                size_t min_child_size,
+                                double& best_value,
+                                size_t& best_var,
+                                double& best_decrease,
+                                bool& best_send_missing_left,
+                                const Eigen::ArrayXXd& responses_by_sample,
+                                const std::vector<std::vector<size_t>>& samples);
 
   size_t* counter;
   double* sums;
@@ -62,6 +108,10 @@ private:
 
   double alpha;
   double imbalance_penalty;
+  uint num_threads;
+  SplitValueOptions split_value_options;
+  RandomSampler* sampler;
+  SplitScan scan;
 
   DISALLOW_COPY_AND_ASSIGN(RegressionSplittingRule);
 };
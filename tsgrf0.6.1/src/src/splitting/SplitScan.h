@@ -0,0 +1,113 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SPLITSCAN_H
+#define GRF_SPLITSCAN_H
+
+#include <cstddef>
+#include <vector>
+
+#include "commons/globals.h"
+
+namespace grf {
+
+enum SplitScanKernel {
+  SCAN_SCALAR,
+  SCAN_AVX2,
+  SCAN_AVX512
+};
+
+/**
+ * The candidate splits of one variable, and a search for the one with the
+ * largest decrease in impurity
+ *
+ *   sum_left^2 / weight_sum_left + sum_right^2 / weight_sum_right
+ *     - imbalance_penalty * (1 / size_left + 1 / size_right).
+ *
+ * The splitting rules accumulate the left child's sums in split order and add
+ * every admissible split; the decreases are then evaluated several splits at a
+ * time with AVX2 or AVX-512 when the CPU supports it. The sums are accumulated by
+ * the caller and each decrease is evaluated with the same operations as the scalar
+ * loop (no fused multiply-add), so the chosen split does not depend on the kernel.
+ */
+class SplitScan {
+public:
+  explicit SplitScan(size_t max_num_splits);
+
+  void clear();
+
+  /**
+   * Adds a candidate split. Candidates must be added in increasing order of `split`.
+   */
+  void add(size_t split,
+           double sum_left,
+           double weight_sum_left,
+           double size_left,
+           double size_right) {
+    sums_left[num_candidates] = sum_left;
+    weight_sums_left[num_candidates] = weight_sum_left;
+    sizes_left[num_candidates] = size_left;
+    sizes_right[num_candidates] = size_right;
+    splits[num_candidates] = split;
+    ++num_candidates;
+  }
+
+  /**
+   * Finds the first candidate whose decrease is strictly larger than `best_decrease`
+   * and every other candidate's decrease.
+   *
+   * @return true if such a candidate exists, in which case `best_decrease` and
+   * `best_split` are updated.
+   */
+  bool find_best(double sum_node,
+                 double weight_sum_node,
+                 double imbalance_penalty,
+                 double& best_decrease,
+                 size_t& best_split) const {
+    return find_best(sum_node, weight_sum_node, imbalance_penalty, best_decrease, best_split, get_kernel());
+  }
+
+  bool find_best(double sum_node,
+                 double weight_sum_node,
+                 double imbalance_penalty,
+                 double& best_decrease,
+                 size_t& best_split,
+                 SplitScanKernel kernel) const;
+
+  size_t size() const;
+
+  /**
+   * The widest kernel supported by the CPU, detected once.
+   */
+  static SplitScanKernel get_kernel();
+
+  static bool is_supported(SplitScanKernel kernel);
+
+private:
+  std::vector<double> sums_left;
+  std::vector<double> weight_sums_left;
+  std::vector<double> sizes_left;
+  std::vector<double> sizes_right;
+  std::vector<size_t> splits;
+  size_t num_candidates;
+
+  DISALLOW_COPY_AND_ASSIGN(SplitScan);
+};
+
+} // namespace grf
+
+#endif //GRF_SPLITSCAN_H
@@ -0,0 +1,269 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "splitting/SplitValues.h"
+
+namespace grf {
+
+namespace {
+
+// Reads the values of the node, and their range ignoring missing values.
+bool read_values(const Data& data,
+                 const std::vector<size_t>& samples,
+                 size_t var,
+                 std::vector<double>& values,
+                 double& min_value,
+                 double& max_value) {
+  values.resize(samples.size());
+  min_value = INFINITY;
+  max_value = -INFINITY;
+  bool has_missing = false;
+  for (size_t i = 0; i < samples.size(); i++) {
+    double value = data.get(samples[i], var);
+    values[i] = value;
+    if (std::isnan(value)) {
+      has_missing = true;
+    } else {
+      min_value = std::min(min_value, value);
+      max_value = std::max(max_value, value);
+    }
+  }
+  return has_missing;
+}
+
+// Sorts and deduplicates the thresholds from `first_threshold` on, and appends the largest value.
+void finish_split_values(std::vector<double>& split_values,
+                         size_t first_threshold,
+                         double min_value,
+                         double max_value) {
+  auto thresholds = split_values.begin() + static_cast<std::vector<double>::difference_type>(first_threshold);
+  std::sort(thresholds, split_values.end());
+  split_values.erase(std::unique(thresholds, split_values.end()), split_values.end());
+  if (min_value <= max_value) {
+    split_values.push_back(max_value);
+  }
+}
+
+void assign_buckets(const std::vector<double>& values,
+                    const std::vector<double>& split_values,
+                    size_t first_threshold,
+                    std::vector<size_t>& buckets) {
+  auto thresholds = split_values.begin() + static_cast<std::vector<double>::difference_type>(first_threshold);
+  buckets.resize(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    if (std::isnan(values[i])) {
+      buckets[i] = MISSING_BUCKET;
+    } else {
+      buckets[i] = std::lower_bound(thresholds, split_values.end(), values[i]) - split_values.begin();
+    }
+  }
+}
+
+// Moves the values of the given increasing ranks in [begin, end) to their sorted positions.
+void select_ranks(std::vector<double>& values,
+                  size_t begin,
+                  size_t end,
+                  const std::vector<size_t>& ranks,
+                  size_t rank_begin,
+                  size_t rank_end) {
+  if (rank_begin >= rank_end) {
+    return;
+  }
+  size_t middle = rank_begin + (rank_end - rank_begin) / 2;
+  size_t rank = ranks[middle];
+  std::nth_element(values.begin() + begin, values.begin() + rank, values.begin() + end);
+  select_ranks(values, begin, rank, ranks, rank_begin, middle);
+  select_ranks(values, rank + 1, end, ranks, middle + 1, rank_end);
+}
+
+} // namespace
+
+bool get_split_values(const Data& data,
+                      const std::vector<size_t>& samples,
+                      size_t var,
+                      const SplitValueOptions& options,
+                      RandomSampler* sampler,
+                      SortedSamplesCache* sorted_samples_cache,
+                      std::vector<double>& split_values,
+                      std::vector<size_t>& sorted_samples,
+                      std::vector<size_t>& buckets) {
+  if (options.get_num_random_thresholds() > 0) {
+    draw_random_split_values(data, samples, var, options.get_num_random_thresholds(), *sampler,
+                             split_values, buckets);
+    return true;
+  }
+  if (options.get_max_num_thresholds() > 0 && samples.size() >= options.get_min_quantile_node_size()) {
+    get_quantile_split_values(data, samples, var, options.get_max_num_thresholds(), split_values, buckets);
+    return true;
+  }
+  get_all_values(data, sorted_samples_cache, split_values, sorted_samples, samples, var);
+  return false;
+}
+
+bool get_sparse_split_values(const Data& data,
+                             const std::vector<size_t>& samples,
+                             size_t var,
+                             const SplitValueOptions& options,
+                             const SortedSamplesCache* sorted_samples_cache,
+                             std::vector<double>& split_values,
+                             std::vector<size_t>& nonzero_samples,
+                             std::vector<size_t>& nonzero_buckets,
+                             size_t& zero_bucket) {
+  if (!data.is_sparse(var) || sorted_samples_cache == nullptr || !sorted_samples_cache->is_searching(samples) ||
+      options.get_num_random_thresholds() > 0 ||
+      (options.get_max_num_thresholds() > 0 && samples.size() >= options.get_min_quantile_node_size())) {
+    return false;
+  }
+  // Reading every sample of the node takes a binary search over the nonzeros per sample.
+  double num_nonzero = static_cast<double>(data.get_num_nonzero(var));
+  if (num_nonzero > samples.size() * std::log2(num_nonzero + 2)) {
+    return false;
+  }
+
+  // The nonzeros of the node, with their position in the node to break ties in sample
+  // order like Data#get_all_values.
+  struct Nonzero {
+    double value;
+    size_t position;
+    size_t sample;
+  };
+  std::vector<Nonzero> nonzeros;
+  data.for_each_nonzero(var, [&](size_t sample, double value) {
+    if (value != 0 && sorted_samples_cache->contains(sample)) {
+      size_t position = sorted_samples_cache->get_position(sample);
+      for (size_t count = sorted_samples_cache->get_count(sample); count > 0; count--) {
+        nonzeros.push_back({value, position, sample});
+      }
+    }
+  });
+  std::sort(nonzeros.begin(), nonzeros.end(), [](const Nonzero& lhs, const Nonzero& rhs) {
+    bool lhs_nan = std::isnan(lhs.value);
+    bool rhs_nan = std::isnan(rhs.value);
+    if (lhs_nan != rhs_nan) {
+      return lhs_nan;
+    }
+    if (!lhs_nan && lhs.value != rhs.value) {
+      return lhs.value < rhs.value;
+    }
+    return lhs.position < rhs.position;
+  });
+
+  split_values.clear();
+  nonzero_samples.resize(nonzeros.size());
+  nonzero_buckets.resize(nonzeros.size());
+  zero_bucket = MISSING_BUCKET;
+  bool has_zeros = nonzeros.size() < samples.size();
+  for (size_t i = 0; i < nonzeros.size(); i++) {
+    double value = nonzeros[i].value;
+    // The zeros go between the negative and the positive values.
+    if (has_zeros && zero_bucket == MISSING_BUCKET && value > 0) {
+      zero_bucket = split_values.size();
+      split_values.push_back(0);
+    }
+    bool missing = std::isnan(value);
+    if (split_values.empty() || !(value == split_values.back() || (missing && std::isnan(split_values.back())))) {
+      split_values.push_back(value);
+    }
+    nonzero_samples[i] = nonzeros[i].sample;
+    nonzero_buckets[i] = missing ? MISSING_BUCKET : split_values.size() - 1;
+  }
+  if (has_zeros && zero_bucket == MISSING_BUCKET) {
+    zero_bucket = split_values.size();
+    split_values.push_back(0);
+  }
+  return true;
+}
+
+void draw_random_split_values(const Data& data,
+                              const std::vector<size_t>& samples,
+                              size_t var,
+                              uint num_thresholds,
+                              RandomSampler& sampler,
+                              std::vector<double>& split_values,
+                              std::vector<size_t>& buckets) {
+  std::vector<double> values;
+  double min_value, max_value;
+  bool has_missing = read_values(data, samples, var, values, min_value, max_value);
+
+  split_values.clear();
+  if (has_missing) {
+    split_values.push_back(NAN);
+  }
+  size_t first_threshold = split_values.size();
+
+  // A threshold at the largest value would send every sample left.
+  if (min_value < max_value) {
+    for (uint i = 0; i < num_thresholds; i++) {
+      double threshold = sampler.sample_uniform(min_value, max_value);
+      if (threshold < max_value) {
+        split_values.push_back(threshold);
+      }
+    }
+  }
+  finish_split_values(split_values, first_threshold, min_value, max_value);
+  assign_buckets(values, split_values, first_threshold, buckets);
+}
+
+void get_quantile_split_values(const Data& data,
+                               const std::vector<size_t>& samples,
+                               size_t var,
+                               uint max_num_thresholds,
+                               std::vector<double>& split_values,
+                               std::vector<size_t>& buckets) {
+  std::vector<double> values;
+  double min_value, max_value;
+  bool has_missing = read_values(data, samples, var, values, min_value, max_value);
+
+  split_values.clear();
+  if (has_missing) {
+    split_values.push_back(NAN);
+  }
+  size_t first_threshold = split_values.size();
+
+  std::vector<double> observed;
+  observed.reserve(values.size());
+  for (double value : values) {
+    if (!std::isnan(value)) {
+      observed.push_back(value);
+    }
+  }
+
+  // The j-th threshold is the ceil(j * n / (k + 1))-th smallest value, which splits the node into k + 1 equal parts.
+  size_t num_observed = observed.size();
+  std::vector<size_t> ranks;
+  for (size_t j = 1; j <= max_num_thresholds; j++) {
+    size_t rank = (j * num_observed + max_num_thresholds) / (max_num_thresholds + 1) - 1;
+    if (rank < num_observed && (ranks.empty() || rank > ranks.back())) {
+      ranks.push_back(rank);
+    }
+  }
+  select_ranks(observed, 0, num_observed, ranks, 0, ranks.size());
+
+  for (size_t rank : ranks) {
+    // A threshold at the largest value would send every sample left.
+    if (observed[rank] < max_value) {
+      split_values.push_back(observed[rank]);
+    }
+  }
+  finish_split_values(split_values, first_threshold, min_value, max_value);
+  assign_buckets(values, split_values, first_threshold, buckets);
+}
+
+} // namespace grf
@@ -22,6 +22,7 @@
 
 #include "Eigen/Dense"
 #include "commons/Data.h"
+#include "splitting/SortedSamplesCache.h"
 
 namespace grf {
 
@@ -52,6 +53,17 @@ public:
                                std::vector<size_t>& split_vars,
                                std::vector<double>& split_values,
                                std::vector<bool>& send_missing_left) = 0;
+
+  /**
+   * Lets the rule derive the sorted orders of a node from its parent's. The cache
+   * is owned by the tree trainer and must outlive the rule's use in that tree.
+   */
+  void set_sorted_samples_cache(SortedSamplesCache* cache) {
+    sorted_samples_cache = cache;
+  }
+
+protected:
+  SortedSamplesCache* sorted_samples_cache = nullptr;
 };
 
 } // namespace grf
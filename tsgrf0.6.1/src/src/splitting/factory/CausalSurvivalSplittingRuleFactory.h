@@ -27,7 +27,8 @@ class CausalSurvivalSplittingRuleFactory final: public SplittingRuleFactory {
 public:
   CausalSurvivalSplittingRuleFactory() = default;
   std::unique_ptr<SplittingRule> create(size_t max_num_unique_values,
-                                        const TreeOptions& options) const;
+                                        const TreeOptions& options,
+                                        RandomSampler& sampler) const;
 private:
   DISALLOW_COPY_AND_ASSIGN(CausalSurvivalSplittingRuleFactory);
 };
@@ -20,16 +20,21 @@
 
 namespace grf {
 
-MultiRegressionSplittingRuleFactory::MultiRegressionSplittingRuleFactory(size_t num_outcomes):
-  num_outcomes(num_outcomes) {}
+MultiRegressionSplittingRuleFactory::MultiRegressionSplittingRuleFactory(size_t num_outcomes,
+                                                                         const SplitValueOptions& split_value_options):
+  num_outcomes(num_outcomes),
+  split_value_options(split_value_options) {}
 
 std::unique_ptr<SplittingRule> MultiRegressionSplittingRuleFactory::create(size_t max_num_unique_values,
-                                                                           const TreeOptions& options) const {
+                                                                           const TreeOptions& options,
+                                                                           RandomSampler& sampler) const {
   return std::unique_ptr<SplittingRule>(new MultiRegressionSplittingRule(
       max_num_unique_values,
       options.get_alpha(),
       options.get_imbalance_penalty(),
-      num_outcomes));
+      num_outcomes,
+      split_value_options,
+      &sampler));
 }
 
 } // namespace grf
@@ -19,6 +19,7 @@
 #define GRF_MULTIREGRESSIONSPLITTINGRULEFACTORY_H
 
 
+#include "splitting/SplitValueOptions.h"
 #include "splitting/factory/SplittingRuleFactory.h"
 
 namespace grf {
@@ -28,15 +29,20 @@ namespace grf {
  *
  * In addition to performing standard regression splits, this rule applies
  * a penalty to avoid splits too close to the edge of the node's data.
+ *
+ * The candidate split values are chosen according to `split_value_options`.
  */
 class MultiRegressionSplittingRuleFactory final: public SplittingRuleFactory {
 public:
-  MultiRegressionSplittingRuleFactory(size_t num_outcomes);
+  MultiRegressionSplittingRuleFactory(size_t num_outcomes,
+                                      const SplitValueOptions& split_value_options = SplitValueOptions());
 
   std::unique_ptr<SplittingRule> create(size_t max_num_unique_values,
-                                        const TreeOptions& options) const;
+                                        const TreeOptions& options,
+                                        RandomSampler& sampler) const;
 private:
   size_t num_outcomes;
+  SplitValueOptions split_value_options;
   
   DISALLOW_COPY_AND_ASSIGN(MultiRegressionSplittingRuleFactory);
 };
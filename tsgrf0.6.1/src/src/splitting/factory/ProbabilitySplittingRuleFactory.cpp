@@ -21,16 +21,21 @@
 
 namespace grf {
 
-ProbabilitySplittingRuleFactory::ProbabilitySplittingRuleFactory(size_t num_classes):
-    num_classes(num_classes) {}
+ProbabilitySplittingRuleFactory::ProbabilitySplittingRuleFactory(size_t num_classes,
+                                                                 const SplitValueOptions& split_value_options):
+    num_classes(num_classes),
+    split_value_options(split_value_options) {}
 
 std::unique_ptr<SplittingRule> ProbabilitySplittingRuleFactory::create(size_t max_num_unique_values,
-                                                                       const TreeOptions& options) const {
+                                                                       const TreeOptions& options,
+                                                                       RandomSampler& sampler) const {
   return std::unique_ptr<SplittingRule>(new ProbabilitySplittingRule(
       max_num_unique_values,
       num_classes,
       options.get_alpha(),
-      options.get_imbalance_penalty()));
+      options.get_imbalance_penalty(),
+      split_value_options,
+      &sampler));
 }
 
 } // namespace grf
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "commons/globals.h"
+#include "splitting/SplitValueOptions.h"
 #include "splitting/factory/SplittingRuleFactory.h"
 
 namespace grf {
@@ -30,15 +31,20 @@ namespace grf {
  *
  * In addition to performing standard regression splits, this rule applies
  * a penalty to avoid splits too close to the edge of the node's data.
+ *
+ * The candidate split values are chosen according to `split_value_options`.
  */
 class ProbabilitySplittingRuleFactory final: public SplittingRuleFactory {
 public:
-  ProbabilitySplittingRuleFactory(size_t num_classes);
+  ProbabilitySplittingRuleFactory(size_t num_classes,
+                                  const SplitValueOptions& split_value_options = SplitValueOptions());
   std::unique_ptr<SplittingRule> create(size_t max_num_unique_values,
-                                        const TreeOptions& options) const;
+                                        const TreeOptions& options,
+                                        RandomSampler& sampler) const;
 
 private:
   size_t num_classes;
+  SplitValueOptions split_value_options;
 
   DISALLOW_COPY_AND_ASSIGN(ProbabilitySplittingRuleFactory);
 };
@@ -20,12 +20,19 @@
 
 namespace grf {
 
+RegressionSplittingRuleFactory::RegressionSplittingRuleFactory(const SplitValueOptions& split_value_options):
+    split_value_options(split_value_options) {}
+
 std::unique_ptr<SplittingRule> RegressionSplittingRuleFactory::create(size_t max_num_unique_values,
-                                                                      const TreeOptions& options) const {
+                                                                      const TreeOptions& options,
+                                                                      RandomSampler& sampler) const {
   return std::unique_ptr<SplittingRule>(new RegressionSplittingRule(
       max_num_unique_values,
       options.get_alpha(),
-      options.get_imbalance_penalty()));
+      options.get_imbalance_penalty(),
+      options.get_num_threads(),
+      split_value_options,
+      &sampler));
 }
 
 } // namespace grf
@@ -19,6 +19,7 @@
 #define GRF_REGRESSIONSPLITTINGRULEFACTORY_H
 
 
+#include "splitting/SplitValueOptions.h"
 #include "splitting/factory/SplittingRuleFactory.h"
 
 namespace grf {
@@ -28,13 +29,18 @@ namespace grf {
  *
  * In addition to performing standard regression splits, this rule applies
  * a penalty to avoid splits too close to the edge of the node's data.
+ *
+ * The candidate split values are chosen according to `split_value_options`.
  */
 class RegressionSplittingRuleFactory final: public SplittingRuleFactory {
 public:
-  RegressionSplittingRuleFactory() = default;
+  RegressionSplittingRuleFactory(const SplitValueOptions& split_value_options = SplitValueOptions());
   std::unique_ptr<SplittingRule> create(size_t max_num_unique_values,
-                                        const TreeOptions& options) const;
+                                        const TreeOptions& options,
+                                        RandomSampler& sampler) const;
 private:
+  SplitValueOptions split_value_options;
+
   DISALLOW_COPY_AND_ASSIGN(RegressionSplittingRuleFactory);
 };
 
@@ -31,7 +31,8 @@ public:
   SurvivalSplittingRuleFactory() = default;
 
   std::unique_ptr<SplittingRule> create(size_t max_num_unique_values,
-                                        const TreeOptions& options) const;
+                                        const TreeOptions& options,
+                                        RandomSampler& sampler) const;
 private:
   DISALLOW_COPY_AND_ASSIGN(SurvivalSplittingRuleFactory);
 };
@@ -26,7 +26,8 @@ TreeOptions::TreeOptions(uint mtry,
                          bool honesty_prune_leaves,
                          double alpha,
                          double imbalance_penalty,
-                         size_t honesty_method):
+                         size_t honesty_method,
+                         uint num_threads):
   mtry(mtry),
   min_node_size(min_node_size),
   honesty(honesty),
@@ -34,7 +35,8 @@ TreeOptions::TreeOptions(uint mtry,
   honesty_prune_leaves(honesty_prune_leaves),
   alpha(alpha),
   imbalance_penalty(imbalance_penalty),
-  honesty_method(honesty_method) {}
+  honesty_method(honesty_method),
+  num_threads(num_threads) {}
 
 TreeOptions::TreeOptions(uint mtry,
                          uint min_node_size,
@@ -42,7 +44,8 @@ TreeOptions::TreeOptions(uint mtry,
                          double honesty_fraction,
                          bool honesty_prune_leaves,
                          double alpha,
-                         double imbalance_penalty):
+                         double imbalance_penalty,
+                         uint num_threads):
   mtry(mtry),
   min_node_size(min_node_size),
   honesty(honesty),
@@ -51,7 +54,8 @@ TreeOptions::TreeOptions(uint mtry,
   alpha(alpha),
   imbalance_penalty(imbalance_penalty),
   // 没有传入 honesty_method 时，默认值为 0
-  honesty_method(0) {}
+  honesty_method(0),
+  num_threads(num_threads) {}
 
 uint TreeOptions::get_mtry() const {
   return mtry;
@@ -84,4 +88,9 @@ double TreeOptions::get_imbalance_penalty() const {
 size_t TreeOptions::get_honesty_method() const{
   return honesty_method;
 }
+
+uint TreeOptions::get_num_threads() const {
+  return num_threads;
+}
+
 } // namespace grf
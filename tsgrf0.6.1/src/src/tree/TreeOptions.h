@@ -32,7 +32,8 @@ public:
               bool honesty_prune_leaves,
               double alpha,
               double imbalance_penalty,
-              size_t honesty_method);
+              size_t honesty_method,
+              uint num_threads);
   
   TreeOptions(uint mtry,
               uint min_node_size,
@@ -40,7 +41,8 @@ public:
               double honesty_fraction,
               bool honesty_prune_leaves,
               double alpha,
-              double imbalance_penalty);
+              double imbalance_penalty,
+              uint num_threads);
 
   uint get_mtry() const;
   uint get_min_node_size() const;
@@ -71,6 +73,12 @@ public:
   
   size_t get_honesty_method() const;
 
+  /**
+   * The number of threads a single tree may use when searching for the best split
+   * of a large node. Smaller nodes are always split on the thread growing the tree.
+   */
+  uint get_num_threads() const;
+
 private:
   uint mtry;
   uint min_node_size;
@@ -80,6 +88,7 @@ private:
   double alpha;
   double imbalance_penalty;
   size_t honesty_method;
+  uint num_threads;
 };
 
 } // namespace grf
@@ -17,21 +17,147 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <numeric>
 #include <iterator>
 #include <stdexcept>
+#include <unordered_map>
 
 #include "Data.h"
 
 namespace grf {
 
+namespace {
+
+template <typename T>
+bool contains_nan(const T* values, size_t num_values) {
+  return std::any_of(values, values + num_values, [](T value) { return std::isnan(value); });
+}
+
+// Nodes up to this size are sorted by insertion, and nodes from RADIX_SORT_MIN_SIZE on by radix.
+const size_t INSERTION_SORT_MAX_SIZE = 16;
+const size_t RADIX_SORT_MIN_SIZE = 512;
+
+// An unsigned key with the order of the sort: NaN first, then increasing values, with both zeros equal.
+uint64_t sort_key(double value) {
+  if (std::isnan(value)) {
+    return 0;
+  }
+  if (value == 0) {
+    value = 0;
+  }
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint64_t sign = uint64_t(1) << 63;
+  return (bits & sign) ? ~bits : bits | sign;
+}
+
+// Stable LSD radix sort of the positions in [begin, end) by the keys of their values, one byte
+// per pass. Passes where all keys share the same byte leave the order unchanged and are skipped.
+void radix_sort(const std::vector<double>& values,
+                std::vector<size_t>::iterator begin,
+                std::vector<size_t>::iterator end) {
+  size_t n = static_cast<size_t>(end - begin);
+  std::vector<uint64_t> keys(n);
+  std::vector<size_t> index(begin, end);
+  std::vector<size_t> counts(8 * 256);
+  for (size_t i = 0; i < n; i++) {
+    keys[i] = sort_key(values[index[i]]);
+    for (size_t pass = 0; pass < 8; pass++) {
+      ++counts[pass * 256 + ((keys[i] >> (8 * pass)) & 0xFF)];
+    }
+  }
+
+  std::vector<uint64_t> keys_out(n);
+  std::vector<size_t> index_out(n);
+  for (size_t pass = 0; pass < 8; pass++) {
+    size_t* pass_counts = counts.data() + pass * 256;
+    size_t shift = 8 * pass;
+    if (pass_counts[(keys[0] >> shift) & 0xFF] == n) {
+      continue;
+    }
+    size_t offset = 0;
+    for (size_t digit = 0; digit < 256; digit++) {
+      size_t count = pass_counts[digit];
+      pass_counts[digit] = offset;
+      offset += count;
+    }
+    for (size_t i = 0; i < n; i++) {
+      size_t position = pass_counts[(keys[i] >> shift) & 0xFF]++;
+      keys_out[position] = keys[i];
+      index_out[position] = index[i];
+    }
+    keys.swap(keys_out);
+    index.swap(index_out);
+  }
+  std::copy(index.begin(), index.end(), begin);
+}
+
+// Stable sort of the positions in [begin, end) by their values, NaN first. The kernel depends
+// on the size, but every kernel gives the same order.
+void sort_index(const std::vector<double>& values,
+                std::vector<size_t>::iterator begin,
+                std::vector<size_t>::iterator end,
+                bool may_have_nan) {
+  size_t n = static_cast<size_t>(end - begin);
+  auto less = [&](size_t lhs, size_t rhs) {
+    return values[lhs] < values[rhs] || (may_have_nan && std::isnan(values[lhs]) && !std::isnan(values[rhs]));
+  };
+  if (n <= INSERTION_SORT_MAX_SIZE) {
+    for (auto it = begin + 1; it < end; ++it) {
+      size_t current = *it;
+      auto hole = it;
+      for (; hole != begin && less(current, *(hole - 1)); --hole) {
+        *hole = *(hole - 1);
+      }
+      *hole = current;
+    }
+  } else if (n >= RADIX_SORT_MIN_SIZE) {
+    radix_sort(values, begin, end);
+  } else {
+    std::stable_sort(begin, end, less);
+  }
+}
+
+} // namespace
+
 Data::Data(const double* data_ptr, size_t num_rows, size_t num_cols) {
   if (data_ptr == nullptr) {
     throw std::runtime_error("Invalid data storage: nullptr");
   }
-  this->data_ptr = data_ptr;
+  for (size_t col = 0; col < num_cols; col++) {
+    const double* values = data_ptr + col * num_rows;
+    this->columns.push_back({values, nullptr, nullptr, 0, contains_nan(values, num_rows)});
+  }
   this->num_rows = num_rows;
-  this->num_cols = num_cols;
+  this->full_num_rows = num_rows;
+  this->row_offset = 0;
+}
+
+Data::Data(const std::vector<const double*>& columns, size_t num_rows) {
+  for (const double* column : columns) {
+    if (column == nullptr) {
+      throw std::runtime_error("Invalid data storage: nullptr");
+    }
+    this->columns.push_back({column, nullptr, nullptr, 0, contains_nan(column, num_rows)});
+  }
+  this->num_rows = num_rows;
+  this->full_num_rows = num_rows;
+  this->row_offset = 0;
+}
+
+Data::Data(const float* data_ptr, size_t num_rows, size_t num_cols) {
+  if (data_ptr == nullptr) {
+    throw std::runtime_error("Invalid data storage: nullptr");
+  }
+  for (size_t col = 0; col < num_cols; col++) {
+    const float* values = data_ptr + col * num_rows;
+    this->columns.push_back({nullptr, values, nullptr, 0, contains_nan(values, num_rows)});
+  }
+  this->num_rows = num_rows;
+  this->full_num_rows = num_rows;
+  this->row_offset = 0;
 }
 
 Data::Data(const std::vector<double>& data, size_t num_rows, size_t num_cols) :
@@ -78,6 +204,167 @@ void Data::set_causal_survival_denominator_index(size_t index) {
   disallowed_split_variables.insert(index);
 }
 
+void Data::set_series_index(size_t index) {
+  if (row_offset != 0 && !virtual_columns.empty()) {
+    throw std::runtime_error("The series index of data with virtual columns must be set on the full data.");
+  }
+  this->series_index = index;
+  disallowed_split_variables.insert(index);
+  compute_series_rows();
+  if (row_offset != 0) {
+    return;
+  }
+
+  std::shared_ptr<SeriesLayout> layout = std::make_shared<SeriesLayout>();
+  layout->positions.resize(num_rows);
+  layout->series_positions.resize(num_rows);
+  for (const std::vector<size_t>& rows : series_rows) {
+    for (size_t i = 0; i < rows.size(); i++) {
+      layout->positions[rows[i]] = layout->rows.size();
+      layout->series_positions[rows[i]] = i;
+      layout->rows.push_back(rows[i]);
+    }
+  }
+  series_layout = layout;
+  for (std::shared_ptr<const VirtualColumn>& column : virtual_columns) {
+    column = column->within_series(series_layout);
+  }
+}
+
+void Data::compute_series_rows() {
+  std::unordered_map<double, size_t> series_ids;
+  series_rows.clear();
+  for (size_t row = 0; row < num_rows; row++) {
+    double series = get(row, series_index.value());
+    if (std::isnan(series)) {
+      throw std::runtime_error("The series ID of a row cannot be missing.");
+    }
+    auto it = series_ids.find(series);
+    if (it == series_ids.end()) {
+      it = series_ids.emplace(series, series_rows.size()).first;
+      series_rows.emplace_back();
+    }
+    series_rows[it->second].push_back(row);
+  }
+}
+
+size_t Data::add_virtual_column(size_t source, size_t lag, size_t window, RollingStatistic statistic) {
+  if (source >= columns.size()) {
+    throw std::runtime_error("The source of a virtual column must be a stored column.");
+  }
+  if (columns[source].values == nullptr || columns[source].sparse_rows != nullptr) {
+    throw std::runtime_error("The source of a virtual column must be stored densely in double precision.");
+  }
+  if (series_index.has_value() && series_layout == nullptr) {
+    throw std::runtime_error("The series index of data with virtual columns must be set on the full data.");
+  }
+  const double* source_ptr = columns[source].values - row_offset;
+  virtual_columns.push_back(std::make_shared<const VirtualColumn>(source_ptr, full_num_rows, lag, window, statistic,
+                                                                  series_layout));
+  return columns.size() + virtual_columns.size() - 1;
+}
+
+size_t Data::add_external_column(const double* column) {
+  if (column == nullptr) {
+    throw std::runtime_error("Invalid data storage: nullptr");
+  }
+  return add_external_column(column, contains_nan(column, num_rows));
+}
+
+size_t Data::add_external_column(const float* column) {
+  if (column == nullptr) {
+    throw std::runtime_error("Invalid data storage: nullptr");
+  }
+  return add_external_column(column, contains_nan(column, num_rows));
+}
+
+size_t Data::add_external_column(const double* column, bool has_nan) {
+  if (column == nullptr) {
+    throw std::runtime_error("Invalid data storage: nullptr");
+  }
+  return add_column({column, nullptr, nullptr, 0, has_nan});
+}
+
+size_t Data::add_external_column(const float* column, bool has_nan) {
+  if (column == nullptr) {
+    throw std::runtime_error("Invalid data storage: nullptr");
+  }
+  return add_column({nullptr, column, nullptr, 0, has_nan});
+}
+
+size_t Data::add_sparse_columns(const int* column_starts,
+                                const int* row_indices,
+                                const double* values,
+                                size_t num_cols) {
+  if (column_starts == nullptr) {
+    throw std::runtime_error("Invalid data storage: nullptr");
+  }
+  size_t first_index = columns.size();
+  for (size_t col = 0; col < num_cols; col++) {
+    int start = column_starts[col];
+    int end = column_starts[col + 1];
+    if (start < 0 || end < start) {
+      throw std::runtime_error("Invalid sparse column offsets.");
+    }
+    const int* rows = row_indices + start;
+    for (int i = 0; i < end - start; i++) {
+      if (rows[i] < 0 || static_cast<size_t>(rows[i]) >= full_num_rows || (i > 0 && rows[i] <= rows[i - 1])) {
+        throw std::runtime_error("The row indices of a sparse column must be increasing and within the data.");
+      }
+    }
+    // An empty column still needs a non-null row pointer to be read as sparse.
+    add_column({values + start, nullptr, end > start ? rows : column_starts, static_cast<size_t>(end - start),
+                contains_nan(values + start, end - start)});
+  }
+  return first_index;
+}
+
+size_t Data::add_column(const Column& column) {
+  if (row_offset != 0) {
+    throw std::runtime_error("External columns can only be added to the full data array.");
+  }
+  if (!virtual_columns.empty()) {
+    throw std::runtime_error("External columns must be added before virtual columns.");
+  }
+  columns.push_back(column);
+  return columns.size() - 1;
+}
+
+void Data::refresh_nan_flags() {
+  for (Column& column : columns) {
+    if (column.sparse_rows != nullptr) {
+      column.has_nan = contains_nan(column.values, column.num_nonzero);
+    } else if (column.values != nullptr) {
+      column.has_nan = contains_nan(column.values - row_offset, full_num_rows);
+    } else {
+      column.has_nan = contains_nan(column.float_values - row_offset, full_num_rows);
+    }
+  }
+}
+
+Data Data::get_row_range(size_t begin, size_t end) const {
+  if (begin > end || end > num_rows) {
+    throw std::runtime_error("Invalid row range: rows must satisfy begin <= end <= num_rows.");
+  }
+  Data range(*this);
+  // Sparse columns are indexed by rows of the full data, and are read through row_offset.
+  for (Column& column : range.columns) {
+    if (column.sparse_rows != nullptr) {
+      continue;
+    } else if (column.values != nullptr) {
+      column.values += begin;
+    } else {
+      column.float_values += begin;
+    }
+  }
+  range.num_rows = end - begin;
+  range.row_offset = row_offset + begin;
+  if (series_index.has_value()) {
+    range.compute_series_rows();
+  }
+  return range;
+}
+
 void Data::set_censor_index(size_t index) {
   this->censor_index = index;
   disallowed_split_variables.insert(index);
@@ -92,34 +379,62 @@ std::vector<size_t> Data::get_all_values(std::vector<double>& all_values,
     size_t sample = samples[i];
     all_values[i] = get(sample, var);
   }
+  return sort_all_values(all_values, sorted_samples, samples, var);
+}
 
+std::vector<size_t> Data::sort_all_values(std::vector<double>& all_values,
+                                          std::vector<size_t>& sorted_samples,
+                                          const std::vector<size_t>& samples,
+                                          size_t var) const {
   sorted_samples.resize(samples.size());
   std::vector<size_t> index(samples.size());
-   // fill with [0, 1,..., samples.size() - 1]
-  std::iota(index.begin(), index.end(), 0);
   // sort index based on the split values (argsort)
   // the NaN comparison places all NaNs at the beginning
   // stable sort is needed for consistent element ordering cross platform,
   // otherwise the resulting sums used in the splitting rules may compound rounding error
   // differently and produce different splits.
-  std::stable_sort(index.begin(), index.end(), [&](const size_t& lhs, const size_t& rhs) {
-    return all_values[lhs] < all_values[rhs] || (std::isnan(all_values[lhs]) && !std::isnan(all_values[rhs]));
-  });
+  bool may_have_nan = has_nan(var);
+  if (var < columns.size() && columns[var].sparse_rows != nullptr) {
+    // The zeros of a sparse column form one run, in sample order, between the negative
+    // and the positive values, so only the nonzero values need sorting.
+    std::vector<size_t> zeros;
+    size_t num_nonzero = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+      if (all_values[i] == 0) {
+        zeros.push_back(i);
+      } else {
+        index[num_nonzero++] = i;
+      }
+    }
+    auto nonzero_end = index.begin() + num_nonzero;
+    sort_index(all_values, index.begin(), nonzero_end, may_have_nan);
+    auto positive = std::find_if(index.begin(), nonzero_end, [&](size_t i) { return all_values[i] > 0; });
+    std::copy_backward(positive, nonzero_end, index.end());
+    std::copy(zeros.begin(), zeros.end(), positive);
+  } else {
+    // fill with [0, 1,..., samples.size() - 1]
+    std::iota(index.begin(), index.end(), 0);
+    sort_index(all_values, index.begin(), index.end(), may_have_nan);
+  }
 
+  // Gather the sorted samples and keep the first value of each run of equal values.
+  std::vector<double> values;
+  values.swap(all_values);
+  all_values.reserve(values.size());
   for (size_t i = 0; i < samples.size(); i++) {
     sorted_samples[i] = samples[index[i]];
-    all_values[i] = get(sorted_samples[i], var);
+    double value = values[index[i]];
+    if (all_values.empty() ||
+        !(value == all_values.back() || (may_have_nan && std::isnan(value) && std::isnan(all_values.back())))) {
+      all_values.push_back(value);
+    }
   }
 
-  all_values.erase(unique(all_values.begin(), all_values.end(), [&](const double& lhs, const double& rhs) {
-    return lhs == rhs || (std::isnan(lhs) && std::isnan(rhs));
-  }), all_values.end());
-
   return index;
 }
 
 size_t Data::get_num_cols() const {
-  return num_cols;
+  return columns.size() + virtual_columns.size();
 }
 
 size_t Data::get_num_rows() const {
@@ -146,4 +461,8 @@ const std::set<size_t>& Data::get_disallowed_split_variables() const {
   return disallowed_split_variables;
 }
 
+const std::vector<std::vector<size_t>>& Data::get_series_rows() const {
+  return series_rows;
+}
+
 } // namespace grf
@@ -0,0 +1,46 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SAMPLEWEIGHTS_H
+#define GRF_SAMPLEWEIGHTS_H
+
+#include "commons/Data.h"
+
+namespace grf {
+
+/**
+ * Sample weight policies for the splitting and relabeling loops.
+ *
+ * The loops are templated on the policy and instantiated twice, and the instantiation is
+ * chosen with `Data::has_weights`. With `UnitWeights` the weight is the constant 1, so
+ * unweighted data reads no weight column and the multiplications by the weight fold away.
+ */
+struct SampleWeights {
+  static double get(const Data& data, size_t sample) {
+    return data.get_weight(sample);
+  }
+};
+
+struct UnitWeights {
+  static double get(const Data& data, size_t sample) {
+    return 1.0;
+  }
+};
+
+} // namespace grf
+
+#endif //GRF_SAMPLEWEIGHTS_H
@@ -0,0 +1,261 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "MappedFile.h"
+#include "TextDataLoader.h"
+#include "ThreadPool.h"
+
+namespace grf {
+
+namespace {
+
+// Chunks per thread, so that threads finishing early can pick up more work.
+const size_t CHUNKS_PER_THREAD = 4;
+
+bool is_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Calls `field(begin, end)` for each field of the line [begin, end), with surrounding
+// blanks and quotes trimmed, and returns the number of fields.
+template<typename F>
+size_t for_each_field(const char* begin, const char* end, char delimiter, F field) {
+  size_t num_fields = 0;
+  const char* position = begin;
+  while (true) {
+    if (delimiter == ' ') {
+      while (position < end && is_blank(*position)) {
+        position++;
+      }
+      if (position == end) {
+        return num_fields;
+      }
+    }
+    const char* field_end = position;
+    if (delimiter == ' ') {
+      while (field_end < end && !is_blank(*field_end)) {
+        field_end++;
+      }
+    } else {
+      while (field_end < end && *field_end != delimiter) {
+        field_end++;
+      }
+    }
+
+    const char* value_begin = position;
+    const char* value_end = field_end;
+    while (value_begin < value_end && is_blank(*value_begin)) {
+      value_begin++;
+    }
+    while (value_end > value_begin && is_blank(*(value_end - 1))) {
+      value_end--;
+    }
+    if (value_end - value_begin >= 2 && (*value_begin == '"' || *value_begin == '\'')
+        && *(value_end - 1) == *value_begin) {
+      value_begin++;
+      value_end--;
+    }
+    field(value_begin, value_end);
+    num_fields++;
+
+    if (field_end == end) {
+      return num_fields;
+    }
+    position = field_end + 1;
+  }
+}
+
+bool is_blank_line(const char* begin, const char* end) {
+  return std::all_of(begin, end, is_blank);
+}
+
+// Parses [begin, end) as a double, with empty fields and NA as NaN. Returns false if
+// the field is not a number. The field is copied to a small buffer first since the
+// mapped file is not null-terminated.
+bool parse_value(const char* begin, const char* end, double& value) {
+  size_t length = end - begin;
+  if (length == 0 || (length == 2 && std::strncmp(begin, "NA", 2) == 0)) {
+    value = NAN;
+    return true;
+  }
+  char buffer[64];
+  if (length >= sizeof(buffer)) {
+    return false;
+  }
+  std::memcpy(buffer, begin, length);
+  buffer[length] = '\0';
+  char* parse_end;
+  value = std::strtod(buffer, &parse_end);
+  return parse_end == buffer + length;
+}
+
+const char* next_line(const char* position, const char* end) {
+  const char* newline = static_cast<const char*>(std::memchr(position, '\n', end - position));
+  return newline == nullptr ? end : newline + 1;
+}
+
+struct Chunk {
+  const char* begin;
+  const char* end;
+  // The number of lines, and of non-blank lines (rows), in this chunk.
+  size_t num_lines;
+  size_t num_rows;
+  // The first line number (from 1) and the first row of this chunk.
+  size_t first_line;
+  size_t first_row;
+  // The first malformed line of this chunk, if any.
+  size_t error_line;
+  std::string error;
+};
+
+} // namespace
+
+std::pair<std::vector<double>, std::vector<size_t>> load_text_data(const std::string& file_name,
+                                                                   char delimiter,
+                                                                   bool header,
+                                                                   uint num_threads,
+                                                                   std::vector<std::string>& column_names) {
+  if (num_threads == 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  MappedFile file(file_name);
+  const char* begin = file.get_contents();
+  const char* end = begin + file.get_size();
+
+  // The header, and the first data line which determines the number of columns.
+  column_names.clear();
+  size_t first_line = 1;
+  if (header && begin < end) {
+    const char* header_end = next_line(begin, end);
+    for_each_field(begin, header_end - (header_end > begin && *(header_end - 1) == '\n'), delimiter,
+                   [&](const char* field_begin, const char* field_end) {
+      column_names.emplace_back(field_begin, field_end);
+    });
+    begin = header_end;
+    first_line++;
+  }
+  size_t num_cols = column_names.size();
+  if (!header) {
+    for (const char* line = begin; line < end; line = next_line(line, end)) {
+      const char* line_end = next_line(line, end);
+      if (!is_blank_line(line, line_end - (*(line_end - 1) == '\n'))) {
+        num_cols = for_each_field(line, line_end - (*(line_end - 1) == '\n'), delimiter,
+                                  [](const char*, const char*) {});
+        break;
+      }
+    }
+  }
+
+  // Split the contents into chunks that start at a line.
+  size_t num_chunks = std::max<size_t>(1, std::min<size_t>(num_threads * CHUNKS_PER_THREAD,
+                                                           (end - begin) / 4096 + 1));
+  std::vector<Chunk> chunks;
+  const char* chunk_begin = begin;
+  for (size_t i = 1; i <= num_chunks && chunk_begin < end; i++) {
+    const char* chunk_end = i == num_chunks ? end : begin + (end - begin) * i / num_chunks;
+    if (chunk_end > chunk_begin) {
+      chunk_end = next_line(chunk_end - 1, end);
+    } else {
+      continue;
+    }
+    Chunk chunk;
+    chunk.begin = chunk_begin;
+    chunk.end = chunk_end;
+    chunk.num_lines = 0;
+    chunk.num_rows = 0;
+    chunk.error_line = 0;
+    chunks.push_back(chunk);
+    chunk_begin = chunk_end;
+  }
+
+  // First pass: count the rows of each chunk.
+  ThreadPool::get_instance().parallel_for(chunks.size(), num_threads, [&](size_t i) {
+    Chunk& chunk = chunks[i];
+    for (const char* line = chunk.begin; line < chunk.end; line = next_line(line, chunk.end)) {
+      const char* line_end = next_line(line, chunk.end);
+      chunk.num_lines++;
+      if (!is_blank_line(line, line_end - (*(line_end - 1) == '\n'))) {
+        chunk.num_rows++;
+      }
+    }
+  });
+  size_t num_rows = 0;
+  for (Chunk& chunk : chunks) {
+    chunk.first_line = first_line;
+    chunk.first_row = num_rows;
+    first_line += chunk.num_lines;
+    num_rows += chunk.num_rows;
+  }
+
+  // Second pass: parse each chunk straight into the columns.
+  std::vector<double> storage(num_rows * num_cols);
+  ThreadPool::get_instance().parallel_for(chunks.size(), num_threads, [&](size_t i) {
+    Chunk& chunk = chunks[i];
+    size_t line_number = chunk.first_line;
+    size_t row = chunk.first_row;
+    for (const char* line = chunk.begin; line < chunk.end; line = next_line(line, chunk.end), line_number++) {
+      const char* line_end = next_line(line, chunk.end);
+      line_end -= *(line_end - 1) == '\n';
+      if (is_blank_line(line, line_end)) {
+        continue;
+      }
+      size_t col = 0;
+      bool valid = true;
+      size_t num_fields = for_each_field(line, line_end, delimiter, [&](const char* field_begin, const char* field_end) {
+        if (col < num_cols && valid) {
+          double value;
+          if (parse_value(field_begin, field_end, value)) {
+            storage[col * num_rows + row] = value;
+          } else {
+            valid = false;
+            chunk.error = "Could not parse the value '" + std::string(field_begin, field_end) + "' on line "
+                + std::to_string(line_number) + ".";
+          }
+        }
+        col++;
+      });
+      if (valid && num_fields != num_cols) {
+        valid = false;
+        chunk.error = "Malformed row on line " + std::to_string(line_number) + ": expected "
+            + std::to_string(num_cols) + " values but found " + std::to_string(num_fields) + ".";
+      }
+      if (!valid) {
+        chunk.error_line = line_number;
+        return;
+      }
+      row++;
+    }
+  });
+
+  for (const Chunk& chunk : chunks) {
+    if (chunk.error_line > 0) {
+      throw std::runtime_error(chunk.error);
+    }
+  }
+
+  return std::make_pair(std::move(storage), std::vector<size_t>({num_rows, num_cols}));
+}
+
+} // namespace grf
@@ -0,0 +1,256 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <new>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#include "commons/ThreadPool.h"
+
+namespace grf {
+
+/**
+ * The shared state of one parallel loop. Tasks are claimed one at a time through
+ * `next_task`, so whichever threads happen to be free pick up the remaining work.
+ */
+struct ThreadPool::LoopState {
+  std::function<void(size_t)> task;
+  size_t num_tasks;
+  std::atomic<size_t> next_task;
+  std::atomic<bool> failed;
+
+  std::mutex mutex;
+  size_t num_finished;
+  std::exception_ptr error;
+  std::promise<void> done;
+  std::future<void> result;
+};
+
+static uint read_max_num_threads_from_env() {
+  const char* value = std::getenv("GRF_MAX_NUM_THREADS");
+  if (value == nullptr) {
+    return 0;
+  }
+  long max_num_threads = std::strtol(value, nullptr, 10);
+  return max_num_threads > 0 ? static_cast<uint>(max_num_threads) : 0;
+}
+
+ThreadPool& ThreadPool::get_instance() {
+  static ThreadPool instance(read_max_num_threads_from_env());
+  return instance;
+}
+
+void ThreadPool::set_max_num_threads(uint max_num_threads) {
+  get_instance().resize(max_num_threads);
+}
+
+uint ThreadPool::get_max_num_threads() {
+  ThreadPool& pool = get_instance();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  return static_cast<uint>(pool.max_num_workers);
+}
+
+ThreadPool::ThreadPool(uint max_num_threads):
+    max_num_workers(max_num_threads),
+    stopping(false) {
+#ifndef _WIN32
+  pthread_atfork(&ThreadPool::prepare_fork, &ThreadPool::after_fork_in_parent, &ThreadPool::after_fork_in_child);
+#endif
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  job_available.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::parallel_for(size_t num_tasks,
+                              uint num_threads,
+                              const std::function<void(size_t)>& task) {
+  uint num_helpers = get_num_helpers(num_tasks, num_threads, true);
+  if (num_helpers == 0) {
+    for (size_t i = 0; i < num_tasks; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  std::shared_ptr<LoopState> state = start_loop(num_tasks, num_helpers, task);
+  run_loop(*state);
+  state->result.get();
+}
+
+std::future<void> ThreadPool::parallel_for_async(size_t num_tasks,
+                                                 uint num_threads,
+                                                 const std::function<void(size_t)>& task) {
+  uint num_helpers = get_num_helpers(num_tasks, num_threads, false);
+  std::shared_ptr<LoopState> state = start_loop(num_tasks, num_helpers, task);
+  return std::move(state->result);
+}
+
+std::shared_ptr<ThreadPool::LoopState> ThreadPool::start_loop(size_t num_tasks,
+                                                              uint num_helpers,
+                                                              const std::function<void(size_t)>& task) {
+  std::shared_ptr<LoopState> state(new LoopState());
+  state->task = task;
+  state->num_tasks = num_tasks;
+  state->next_task = 0;
+  state->failed = false;
+  state->num_finished = 0;
+  state->result = state->done.get_future();
+  if (num_tasks == 0) {
+    state->done.set_value();
+    return state;
+  }
+
+  ensure_num_workers(num_helpers);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (uint i = 0; i < num_helpers; ++i) {
+      jobs.push_back([state] { run_loop(*state); });
+    }
+  }
+  job_available.notify_all();
+  return state;
+}
+
+void ThreadPool::run_loop(LoopState& state) {
+  while (true) {
+    size_t task_index = state.next_task++;
+    if (task_index >= state.num_tasks) {
+      return;
+    }
+
+    std::exception_ptr error;
+    if (!state.failed) {
+      try {
+        state.task(task_index);
+      } catch (...) {
+        error = std::current_exception();
+        state.failed = true;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (error && !state.error) {
+      state.error = error;
+    }
+    if (++state.num_finished == state.num_tasks) {
+      if (state.error) {
+        state.done.set_exception(state.error);
+      } else {
+        state.done.set_value();
+      }
+    }
+  }
+}
+
+uint ThreadPool::get_num_helpers(size_t num_tasks, uint num_threads, bool caller_participates) {
+  size_t num_active = std::min(static_cast<size_t>(std::max(num_threads, 1u)), num_tasks);
+  size_t max_active;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    max_active = max_num_workers;
+  }
+  if (max_active > 0) {
+    num_active = std::min(num_active, max_active);
+  }
+  if (caller_participates) {
+    return num_active > 0 ? static_cast<uint>(num_active - 1) : 0;
+  }
+  return static_cast<uint>(std::max(num_active, static_cast<size_t>(1)));
+}
+
+void ThreadPool::ensure_num_workers(size_t num_workers) {
+  std::lock_guard<std::mutex> lock(mutex);
+  while (workers.size() < num_workers) {
+    workers.emplace_back(&ThreadPool::worker_loop, this, workers.size());
+  }
+}
+
+void ThreadPool::resize(uint max_num_threads) {
+  std::vector<std::thread> retired;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    max_num_workers = max_num_threads;
+    if (max_num_workers > 0 && workers.size() > max_num_workers) {
+      retired.insert(retired.end(),
+                     std::make_move_iterator(workers.begin() + max_num_workers),
+                     std::make_move_iterator(workers.end()));
+      workers.resize(max_num_workers);
+    }
+  }
+  job_available.notify_all();
+  for (std::thread& worker : retired) {
+    worker.join();
+  }
+}
+
+void ThreadPool::worker_loop(size_t index) {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      job_available.wait(lock, [&] {
+        return stopping || !jobs.empty() || (max_num_workers > 0 && index >= max_num_workers);
+      });
+      if (stopping || (max_num_workers > 0 && index >= max_num_workers)) {
+        return;
+      }
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+    job();
+  }
+}
+
+void ThreadPool::prepare_fork() {
+  get_instance().mutex.lock();
+}
+
+void ThreadPool::after_fork_in_parent() {
+  get_instance().mutex.unlock();
+}
+
+void ThreadPool::after_fork_in_child() {
+  ThreadPool& pool = get_instance();
+  // The workers do not exist in the child. Their handles are leaked rather than destroyed
+  // (destroying a joinable thread terminates), and so are the jobs, which may reference
+  // loop state that the parent's threads were using at the time of the fork.
+  new std::vector<std::thread>(std::move(pool.workers));
+  new std::deque<std::function<void()>>(std::move(pool.jobs));
+  pool.workers.clear();
+  pool.jobs.clear();
+
+  // The mutex is held by the parent's forking thread and the condition variable may
+  // count waiters that are gone, so both start over.
+  new (&pool.mutex) std::mutex();
+  new (&pool.job_available) std::condition_variable();
+}
+
+} // namespace grf
@@ -0,0 +1,127 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_THREADPOOL_H
+#define GRF_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "globals.h"
+
+namespace grf {
+
+/**
+ * A process-wide pool of worker threads shared by training and prediction.
+ *
+ * Workers are created lazily, the first time a caller asks for more threads than
+ * the pool currently holds, and are then kept alive for the lifetime of the process.
+ * This avoids paying for thread creation on every (possibly tiny) predict call.
+ *
+ * The total number of workers can be bounded through `set_max_num_threads` or the
+ * GRF_MAX_NUM_THREADS environment variable, which is useful when several processes
+ * share one machine. A bound only limits concurrency: the way work is divided into
+ * tasks, and therefore the results, do not depend on it.
+ *
+ * A child process forked while the pool has workers (e.g. by parallel::mclapply in R)
+ * only inherits the forking thread, so the child forgets the inherited workers and
+ * pending jobs and starts a fresh pool on its first parallel loop.
+ */
+class ThreadPool {
+public:
+  static ThreadPool& get_instance();
+
+  /**
+   * Bound the number of threads used at once by a single parallel loop
+   * (0 means no bound). Must not be called from within a parallel loop.
+   */
+  static void set_max_num_threads(uint max_num_threads);
+
+  static uint get_max_num_threads();
+
+  /**
+   * Runs task(0), ..., task(num_tasks - 1) using at most `num_threads` threads,
+   * the calling thread included, and returns once all of them have finished.
+   *
+   * Because the calling thread also executes tasks, parallel loops may be nested
+   * (for example a loop over variables inside a loop over trees) without deadlocking.
+   * If a task throws, remaining unstarted tasks are skipped and the first
+   * exception is rethrown.
+   */
+  void parallel_for(size_t num_tasks,
+                    uint num_threads,
+                    const std::function<void(size_t)>& task);
+
+  /**
+   * Like `parallel_for`, but all tasks are run by pool workers and the calling
+   * thread returns immediately. The returned future becomes ready once every task
+   * has finished, and holds the first exception thrown by a task if any.
+   *
+   * The caller must keep everything referenced by `task` alive until then.
+   */
+  std::future<void> parallel_for_async(size_t num_tasks,
+                                       uint num_threads,
+                                       const std::function<void(size_t)>& task);
+
+  ~ThreadPool();
+
+private:
+  struct LoopState;
+
+  ThreadPool(uint max_num_threads);
+
+  std::shared_ptr<LoopState> start_loop(size_t num_tasks,
+                                        uint num_helpers,
+                                        const std::function<void(size_t)>& task);
+
+  static void run_loop(LoopState& state);
+
+  uint get_num_helpers(size_t num_tasks, uint num_threads, bool caller_participates);
+
+  void ensure_num_workers(size_t num_workers);
+
+  void resize(uint max_num_threads);
+
+  void worker_loop(size_t index);
+
+  // pthread_atfork handlers: the pool is locked across fork, and reset in the child.
+  static void prepare_fork();
+
+  static void after_fork_in_parent();
+
+  static void after_fork_in_child();
+
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> jobs;
+  std::mutex mutex;
+  std::condition_variable job_available;
+
+  size_t max_num_workers;
+  bool stopping;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+} // namespace grf
+
+#endif //GRF_THREADPOOL_H
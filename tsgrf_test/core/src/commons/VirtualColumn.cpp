@@ -0,0 +1,124 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "VirtualColumn.h"
+
+namespace grf {
+
+VirtualColumn::VirtualColumn(const double* source,
+                             size_t num_rows,
+                             size_t lag,
+                             size_t window,
+                             RollingStatistic statistic,
+                             std::shared_ptr<const SeriesLayout> series):
+    source(source),
+    num_rows(num_rows),
+    lag(lag),
+    window(window),
+    statistic(statistic),
+    series(std::move(series)) {
+  if (window == 0) {
+    throw std::runtime_error("The window of a virtual column must contain at least one row.");
+  }
+  if (statistic == ROLLING_SD && window < 2) {
+    throw std::runtime_error("A rolling standard deviation needs a window of at least two rows.");
+  }
+  size_t num_blocks = (num_rows + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  blocks.reset(new std::atomic<double*>[num_blocks]);
+  for (size_t block = 0; block < num_blocks; block++) {
+    blocks[block].store(nullptr);
+  }
+}
+
+VirtualColumn::~VirtualColumn() {
+  size_t num_blocks = (num_rows + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  for (size_t block = 0; block < num_blocks; block++) {
+    delete[] blocks[block].load();
+  }
+}
+
+std::shared_ptr<const VirtualColumn> VirtualColumn::within_series(std::shared_ptr<const SeriesLayout> series) const {
+  return std::make_shared<const VirtualColumn>(source, num_rows, lag, window, statistic, std::move(series));
+}
+
+const double* VirtualColumn::compute_block(size_t block) const {
+  size_t begin = block * BLOCK_SIZE;
+  size_t end = std::min(begin + BLOCK_SIZE, num_rows);
+  double* values = new double[BLOCK_SIZE];
+  std::vector<double> window_values(window);
+  for (size_t row = begin; row < end; row++) {
+    values[row - begin] = compute(row, window_values.data());
+  }
+
+  // Another thread may have filled the same block in the meantime, in which
+  // case its (identical) values are kept and ours are discarded.
+  double* expected = nullptr;
+  if (!blocks[block].compare_exchange_strong(expected, values, std::memory_order_acq_rel)) {
+    delete[] values;
+    return expected;
+  }
+  return values;
+}
+
+double VirtualColumn::compute(size_t row, double* window_values) const {
+  size_t history = series == nullptr ? row : series->series_positions[row];
+  if (history + 1 < lag + window) {
+    return NAN;
+  }
+  // The window is read oldest first, from the rows before `row` in its series if there is one.
+  for (size_t i = 0; i < window; i++) {
+    size_t distance = lag + window - 1 - i;
+    size_t source_row = series == nullptr ? row - distance : series->rows[series->positions[row] - distance];
+    window_values[i] = source[source_row];
+  }
+  const double* begin = window_values;
+  const double* end = begin + window;
+  for (const double* value = begin; value != end; value++) {
+    if (std::isnan(*value)) {
+      return NAN;
+    }
+  }
+
+  switch (statistic) {
+    case ROLLING_MIN:
+      return *std::min_element(begin, end);
+    case ROLLING_MAX:
+      return *std::max_element(begin, end);
+    case ROLLING_MEAN:
+    case ROLLING_SD: {
+      double mean = 0;
+      for (const double* value = begin; value != end; value++) {
+        mean += *value;
+      }
+      mean /= window;
+      if (statistic == ROLLING_MEAN) {
+        return mean;
+      }
+      double sum_squares = 0;
+      for (const double* value = begin; value != end; value++) {
+        sum_squares += (*value - mean) * (*value - mean);
+      }
+      return std::sqrt(sum_squares / (window - 1));
+    }
+  }
+  return NAN;
+}
+
+} // namespace grf
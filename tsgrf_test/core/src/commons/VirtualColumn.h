@@ -0,0 +1,118 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_VIRTUALCOLUMN_H_
+#define GRF_VIRTUALCOLUMN_H_
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "globals.h"
+
+namespace grf {
+
+enum RollingStatistic {
+  ROLLING_MEAN = 0,
+  ROLLING_MIN = 1,
+  ROLLING_MAX = 2,
+  ROLLING_SD = 3
+};
+
+/**
+ * The rows of panel data grouped by series, which lags are resolved within.
+ */
+struct SeriesLayout {
+  // The rows of every series in data order, one series after the other.
+  std::vector<size_t> rows;
+  // For each row, its position in `rows`.
+  std::vector<size_t> positions;
+  // For each row, the number of rows before it in its series.
+  std::vector<size_t> series_positions;
+};
+
+/**
+ * A derived time-series feature of a data column that is not stored in the data array.
+ *
+ * The value at row t is the statistic of the source column over the `window` rows
+ * t - lag - window + 1, ..., t - lag. With a window of one this is simply the source
+ * lagged by `lag` rows, which is read straight from the source column. Longer windows
+ * are computed lazily in blocks of BLOCK_SIZE rows the first time a block is read, and
+ * cached. The cache is filled lock-free, so a column can be read from many threads.
+ *
+ * With a series layout, the rows t - lag - window + 1, ..., t - lag are counted
+ * within the series of row t instead of in data order, so lags never reach into
+ * another series even if the series are interleaved.
+ *
+ * Rows without enough history, and windows that contain a NaN, are NaN.
+ */
+class VirtualColumn {
+public:
+  VirtualColumn(const double* source,
+                size_t num_rows,
+                size_t lag,
+                size_t window,
+                RollingStatistic statistic,
+                std::shared_ptr<const SeriesLayout> series = nullptr);
+
+  ~VirtualColumn();
+
+  double get(size_t row) const;
+
+  /**
+   * The same feature, computed within each series of `series`.
+   */
+  std::shared_ptr<const VirtualColumn> within_series(std::shared_ptr<const SeriesLayout> series) const;
+
+  static const size_t BLOCK_SIZE = 1024;
+
+private:
+  const double* compute_block(size_t block) const;
+
+  double compute(size_t row, double* window_values) const;
+
+  const double* source;
+  size_t num_rows;
+  size_t lag;
+  size_t window;
+  RollingStatistic statistic;
+  std::shared_ptr<const SeriesLayout> series;
+
+  std::unique_ptr<std::atomic<double*>[]> blocks;
+
+  DISALLOW_COPY_AND_ASSIGN(VirtualColumn);
+};
+
+inline double VirtualColumn::get(size_t row) const {
+  if (window == 1) {
+    if (series == nullptr) {
+      return row < lag ? NAN : source[row - lag];
+    }
+    return series->series_positions[row] < lag ? NAN : source[series->rows[series->positions[row] - lag]];
+  }
+  size_t block = row / BLOCK_SIZE;
+  const double* values = blocks[block].load(std::memory_order_acquire);
+  if (values == nullptr) {
+    values = compute_block(block);
+  }
+  return values[row % BLOCK_SIZE];
+}
+
+} // namespace grf
+
+#endif /* GRF_VIRTUALCOLUMN_H_ */
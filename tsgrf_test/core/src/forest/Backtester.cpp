@@ -0,0 +1,114 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+
+#include "commons/ThreadPool.h"
+#include "forest/Backtester.h"
+
+namespace grf {
+
+BacktestFold::BacktestFold(size_t train_start,
+                           size_t train_end,
+                           size_t test_end,
+                           const std::vector<Prediction>& predictions,
+                           const std::vector<double>& errors):
+    train_start(train_start),
+    train_end(train_end),
+    test_end(test_end),
+    predictions(predictions),
+    errors(errors) {}
+
+size_t BacktestFold::get_train_start() const {
+  return train_start;
+}
+
+size_t BacktestFold::get_train_end() const {
+  return train_end;
+}
+
+size_t BacktestFold::get_test_end() const {
+  return test_end;
+}
+
+const std::vector<Prediction>& BacktestFold::get_predictions() const {
+  return predictions;
+}
+
+const std::vector<double>& BacktestFold::get_errors() const {
+  return errors;
+}
+
+Backtester::Backtester(const ForestTrainer& trainer,
+                       const ForestPredictor& predictor):
+    trainer(trainer),
+    predictor(predictor) {}
+
+std::vector<BacktestFold> Backtester::backtest(const Data& data,
+                                               const std::vector<std::pair<size_t, size_t>>& origins,
+                                               const ForestOptions& options,
+                                               size_t window_size) const {
+  if (!options.get_sampling_options().get_clusters().empty()) {
+    throw std::runtime_error("Backtesting does not support clustered samples.");
+  }
+  for (const auto& origin : origins) {
+    if (origin.first == 0 || origin.second == 0 || origin.first + origin.second > data.get_num_rows()) {
+      throw std::runtime_error("Each backtest origin needs training rows and a horizon that fits in the data.");
+    }
+  }
+
+  std::vector<BacktestFold> folds;
+  folds.reserve(origins.size());
+  for (const auto& origin : origins) {
+    size_t train_end = origin.first;
+    size_t train_start = (window_size > 0 && train_end > window_size) ? train_end - window_size : 0;
+    folds.emplace_back(train_start, train_end, train_end + origin.second,
+                       std::vector<Prediction>(), std::vector<double>());
+  }
+
+  ThreadPool::get_instance().parallel_for(origins.size(), options.get_num_threads(), [&](size_t i) {
+    BacktestFold& fold = folds[i];
+    Data train_data = data.get_row_range(fold.train_start, fold.train_end);
+    Data test_data = data.get_row_range(fold.train_end, fold.test_end);
+
+    Forest forest = trainer.train(train_data, options);
+    fold.predictions = predictor.predict(forest, train_data, test_data, false);
+
+    fold.errors.resize(fold.predictions.size());
+    for (size_t row = 0; row < fold.predictions.size(); row++) {
+      fold.errors[row] = test_data.get_outcome(row) - fold.predictions[row].get_predictions()[0];
+    }
+  });
+
+  return folds;
+}
+
+std::vector<std::pair<size_t, size_t>> Backtester::rolling_origins(size_t first_train_end,
+                                                                   size_t horizon,
+                                                                   size_t step,
+                                                                   size_t num_rows) {
+  if (step == 0) {
+    throw std::runtime_error("The step between backtest origins must be positive.");
+  }
+  std::vector<std::pair<size_t, size_t>> origins;
+  for (size_t train_end = first_train_end; train_end + horizon <= num_rows; train_end += step) {
+    origins.emplace_back(train_end, horizon);
+  }
+  return origins;
+}
+
+} // namespace grf
@@ -0,0 +1,113 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_BACKTESTER_H
+#define GRF_BACKTESTER_H
+
+#include <utility>
+#include <vector>
+
+#include "forest/ForestOptions.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestTrainer.h"
+
+namespace grf {
+
+/**
+ * The out-of-sample results of one forecast origin in a backtest.
+ *
+ * The forest was trained on rows [train_start, train_end) and predicted
+ * rows [train_end, test_end).
+ */
+class BacktestFold {
+public:
+  BacktestFold(size_t train_start,
+               size_t train_end,
+               size_t test_end,
+               const std::vector<Prediction>& predictions,
+               const std::vector<double>& errors);
+
+  size_t get_train_start() const;
+  size_t get_train_end() const;
+  size_t get_test_end() const;
+
+  const std::vector<Prediction>& get_predictions() const;
+
+  /**
+   * The forecast errors Y - prediction of each test row, using the first
+   * prediction value.
+   */
+  const std::vector<double>& get_errors() const;
+
+private:
+  friend class Backtester;
+
+  size_t train_start;
+  size_t train_end;
+  size_t test_end;
+  std::vector<Prediction> predictions;
+  std::vector<double> errors;
+};
+
+/**
+ * Rolling-origin evaluation of a forest on a time series.
+ *
+ * The rows of the data are assumed to be in time order. For every origin
+ * (train_end, horizon) a forest is trained on the rows before train_end and
+ * used to predict the next `horizon` rows. The training rows are either all rows
+ * before the origin (an expanding window), or only the last `window_size` of them
+ * (a sliding window).
+ *
+ * The per-origin forests are trained concurrently on the shared thread pool. Each
+ * fold trains on a row range view of the shared data, so the series is not copied.
+ */
+class Backtester {
+public:
+  Backtester(const ForestTrainer& trainer,
+             const ForestPredictor& predictor);
+
+  /**
+   * @param data: the full series, in time order.
+   * @param origins: the (train_end, horizon) pair of each forecast origin.
+   * @param options: the forest options used at every origin. Origins are evaluated with
+   * options.get_num_threads() threads, and clusters are not supported.
+   * @param window_size: the number of rows in a sliding training window, or 0 for an
+   * expanding window.
+   * @return the results of each origin, in the order of `origins`.
+   */
+  std::vector<BacktestFold> backtest(const Data& data,
+                                     const std::vector<std::pair<size_t, size_t>>& origins,
+                                     const ForestOptions& options,
+                                     size_t window_size) const;
+
+  /**
+   * Evenly spaced origins with the given horizon, starting at `first_train_end` and
+   * moving forward `step` rows at a time as long as the horizon fits in `num_rows`.
+   */
+  static std::vector<std::pair<size_t, size_t>> rolling_origins(size_t first_train_end,
+                                                                size_t horizon,
+                                                                size_t step,
+                                                                size_t num_rows);
+
+private:
+  const ForestTrainer& trainer;
+  const ForestPredictor& predictor;
+};
+
+} // namespace grf
+
+#endif //GRF_BACKTESTER_H
@@ -0,0 +1,151 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <future>
+
+#include "commons/ThreadPool.h"
+#include "forest/CausalPipeline.h"
+
+namespace grf {
+
+CausalPipeline::CausalPipeline(const ForestTrainer& nuisance_trainer,
+                               const ForestPredictor& nuisance_predictor,
+                               const ForestTrainer& trainer,
+                               const ForestPredictor& predictor):
+    nuisance_trainer(nuisance_trainer),
+    nuisance_predictor(nuisance_predictor),
+    trainer(trainer),
+    predictor(predictor) {}
+
+Forest CausalPipeline::train(const Data& data,
+                             size_t outcome_index,
+                             size_t treatment_index,
+                             const ForestOptions& nuisance_options,
+                             const ForestOptions& options,
+                             bool compute_oob_predictions,
+                             std::vector<double>& Y_hat,
+                             std::vector<double>& W_hat,
+                             std::vector<Prediction>& predictions) const {
+  TrainingControl control;
+  return train(data, outcome_index, treatment_index, nuisance_options, options, compute_oob_predictions,
+               Y_hat, W_hat, predictions, control);
+}
+
+Forest CausalPipeline::train(const Data& data,
+                             size_t outcome_index,
+                             size_t treatment_index,
+                             const ForestOptions& nuisance_options,
+                             const ForestOptions& options,
+                             bool compute_oob_predictions,
+                             std::vector<double>& Y_hat,
+                             std::vector<double>& W_hat,
+                             std::vector<Prediction>& predictions,
+                             TrainingControl& control) const {
+  size_t num_rows = data.get_num_rows();
+
+  // Neither Y nor W is ever a split variable. The W forest uses the same columns,
+  // with W as its outcome.
+  Data outcome_data(data);
+  outcome_data.set_treatment_index(treatment_index);
+  outcome_data.set_outcome_index(outcome_index);
+  Data treatment_data(outcome_data);
+  treatment_data.set_outcome_index(treatment_index);
+
+  // Each nuisance forest has its own control, which the calling thread stops when `control` does.
+  const Data* nuisance_data[] = {&outcome_data, &treatment_data};
+  std::vector<double>* nuisance_estimates[] = {&Y_hat, &W_hat};
+  TrainingControl nuisance_controls[2];
+  auto train_nuisance_task = [&](size_t i) {
+    Forest forest = nuisance_trainer.train(*nuisance_data[i], nuisance_options, nuisance_controls[i]);
+    if (nuisance_controls[i].stopped_early()) {
+      return;
+    }
+    std::vector<Prediction> oob_predictions = nuisance_predictor.predict_oob(forest, *nuisance_data[i], false);
+    std::vector<double>& estimates = *nuisance_estimates[i];
+    estimates.resize(num_rows);
+    for (size_t row = 0; row < num_rows; row++) {
+      estimates[row] = oob_predictions[row].get_predictions()[0];
+    }
+  };
+
+  size_t num_trees_reported = 0;
+  auto report_nuisance_progress = [&] {
+    size_t num_trees_done = nuisance_controls[0].get_num_trees_done() + nuisance_controls[1].get_num_trees_done();
+    control.add_trees_done(num_trees_done - num_trees_reported);
+    num_trees_reported = num_trees_done;
+    if (!control.report_progress()) {
+      nuisance_controls[0].cancel();
+      nuisance_controls[1].cancel();
+    }
+  };
+
+  control.start(2 * nuisance_options.get_num_trees());
+  if (control.is_cancelled()) {
+    nuisance_controls[0].cancel();
+    nuisance_controls[1].cancel();
+  }
+  ThreadPool& pool = ThreadPool::get_instance();
+  if (control.has_progress_callback() || control.has_time_budget()) {
+    // As in ForestTrainer, the workers train while this thread reports progress, and are
+    // stopped before rethrowing if reporting throws.
+    std::future<void> done = pool.parallel_for_async(2, nuisance_options.get_num_threads(), train_nuisance_task);
+    try {
+      while (done.wait_for(control.get_poll_interval()) != std::future_status::ready) {
+        report_nuisance_progress();
+      }
+    } catch (...) {
+      nuisance_controls[0].cancel();
+      nuisance_controls[1].cancel();
+      done.wait();
+      throw;
+    }
+    done.get();
+  } else {
+    pool.parallel_for(2, nuisance_options.get_num_threads(), train_nuisance_task);
+  }
+  report_nuisance_progress();
+
+  if (nuisance_controls[0].stopped_early() || nuisance_controls[1].stopped_early()) {
+    Y_hat.clear();
+    W_hat.clear();
+    std::vector<std::unique_ptr<Tree>> no_trees;
+    size_t num_variables = outcome_data.get_num_cols() - outcome_data.get_disallowed_split_variables().size();
+    return Forest(no_trees, num_variables, options.get_ci_group_size());
+  }
+
+  std::vector<double> Y_centered(num_rows);
+  std::vector<double> W_centered(num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    Y_centered[row] = outcome_data.get_outcome(row) - Y_hat[row];
+    W_centered[row] = treatment_data.get_outcome(row) - W_hat[row];
+  }
+
+  Data causal_data(outcome_data);
+  size_t centered_outcome_index = causal_data.add_external_column(Y_centered.data());
+  size_t centered_treatment_index = causal_data.add_external_column(W_centered.data());
+  causal_data.set_outcome_index(centered_outcome_index);
+  causal_data.set_treatment_index(centered_treatment_index);
+  causal_data.set_instrument_index(centered_treatment_index);
+
+  Forest forest = trainer.train(causal_data, options, control);
+  if (compute_oob_predictions) {
+    predictions = predictor.predict_oob(forest, causal_data, false);
+  }
+  return forest;
+}
+
+} // namespace grf
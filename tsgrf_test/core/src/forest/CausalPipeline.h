@@ -0,0 +1,98 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_CAUSALPIPELINE_H
+#define GRF_CAUSALPIPELINE_H
+
+#include <vector>
+
+#include "forest/Forest.h"
+#include "forest/ForestOptions.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestTrainer.h"
+#include "forest/TrainingControl.h"
+
+namespace grf {
+
+/**
+ * Trains a causal forest together with its nuisance forests in a single pass.
+ *
+ * The two nuisance forests for E[Y | X] and E[W | X] are trained concurrently on the
+ * shared thread pool, and each computes its OOB predictions in the same task right
+ * after training. The causal forest is then trained on the centered outcome and
+ * treatment. All three forests read the covariates from the same data array: the
+ * centered columns are attached as external columns (see Data#add_external_column)
+ * instead of copying the covariates into a new array.
+ */
+class CausalPipeline {
+public:
+  CausalPipeline(const ForestTrainer& nuisance_trainer,
+                 const ForestPredictor& nuisance_predictor,
+                 const ForestTrainer& trainer,
+                 const ForestPredictor& predictor);
+
+  /**
+   * @param data: the full training data, with sample weights set if they are used.
+   * @param outcome_index: the column of the outcome Y.
+   * @param treatment_index: the column of the treatment W.
+   * @param nuisance_options: the options of both nuisance forests.
+   * @param options: the options of the causal forest.
+   * @param compute_oob_predictions: whether to fill `predictions`.
+   * @param Y_hat: filled with the OOB estimates of E[Y | X].
+   * @param W_hat: filled with the OOB estimates of E[W | X].
+   * @param predictions: filled with the OOB predictions of the causal forest, if requested.
+   * @return the causal forest.
+   */
+  Forest train(const Data& data,
+               size_t outcome_index,
+               size_t treatment_index,
+               const ForestOptions& nuisance_options,
+               const ForestOptions& options,
+               bool compute_oob_predictions,
+               std::vector<double>& Y_hat,
+               std::vector<double>& W_hat,
+               std::vector<Prediction>& predictions) const;
+
+  /**
+   * Same as above, but training can be stopped through `control`. Its progress callback
+   * is invoked on the calling thread, first for the trees of both nuisance forests and
+   * then for the causal forest, and its time budget applies to each stage in turn.
+   *
+   * If the nuisance stage is stopped, the returned forest has no trees and `Y_hat`,
+   * `W_hat` and `predictions` are left empty: `control.stopped_early()` tells either case.
+   */
+  Forest train(const Data& data,
+               size_t outcome_index,
+               size_t treatment_index,
+               const ForestOptions& nuisance_options,
+               const ForestOptions& options,
+               bool compute_oob_predictions,
+               std::vector<double>& Y_hat,
+               std::vector<double>& W_hat,
+               std::vector<Prediction>& predictions,
+               TrainingControl& control) const;
+
+private:
+  const ForestTrainer& nuisance_trainer;
+  const ForestPredictor& nuisance_predictor;
+  const ForestTrainer& trainer;
+  const ForestPredictor& predictor;
+};
+
+} // namespace grf
+
+#endif //GRF_CAUSALPIPELINE_H
@@ -37,26 +37,29 @@ ForestOptions::ForestOptions(uint num_trees,
                              uint random_seed,
                              const std::vector<size_t>& sample_clusters,
                              uint samples_per_cluster,
-                             size_t honesty_method):
+                             size_t honesty_method,
+                             bool equal_series_allocation,
+                             size_t ci_group_size):
     if_block(true),
+    ci_group_size(ci_group_size),
     nonlapping_block_size(nonlapping_block_size),
     sample_fraction(sample_fraction),
-    tree_options(mtry, min_node_size, honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, honesty_method),
-    sampling_options(samples_per_cluster, sample_clusters),
+    tree_options(mtry, min_node_size, honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, honesty_method,
+                 validate_num_threads(num_threads)),
+    sampling_options(samples_per_cluster, sample_clusters, equal_series_allocation),
     random_seed(random_seed) {
     
   this->num_threads = validate_num_threads(num_threads);
 
   // If necessary, round the number of trees up to a multiple of
   // the confidence interval group size.
-  // this->num_trees = num_trees + (num_trees % ci_group_size);
-
-  this->num_trees = num_trees;
+  this->num_trees = num_trees + (num_trees % ci_group_size);
 
-  // if (ci_group_size > 1 && sample_fraction > 1.0) {
-  //   throw std::runtime_error("When confidence intervals are enabled, the"
-  //       " sampling fraction must be less than 1.");
-  // }
+  // Each group draws its trees' blocks from a half-sample of blocks, see ForestTrainer::train_ci_group.
+  if (ci_group_size > 1 && sample_fraction > 0.5) {
+    throw std::runtime_error("When confidence intervals are enabled with block sampling, the"
+        " sampling fraction must be at most 0.5.");
+  }
 }
 
 ForestOptions::ForestOptions(uint num_trees,
@@ -76,7 +79,8 @@ ForestOptions::ForestOptions(uint num_trees,
     if_block(false),
     ci_group_size(ci_group_size),
     sample_fraction(sample_fraction),
-    tree_options(mtry, min_node_size, honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty),
+    tree_options(mtry, min_node_size, honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty,
+                 validate_num_threads(num_threads)),
     sampling_options(samples_per_cluster, sample_clusters),
     random_seed(random_seed) {
 
@@ -20,6 +20,7 @@
 #include <future>
 #include <stdexcept>
 
+#include "commons/ThreadPool.h"
 #include "commons/utility.h"
 #include "ForestTrainer.h"
 #include "random/random.hpp"
@@ -36,8 +37,15 @@ ForestTrainer::ForestTrainer(std::unique_ptr<RelabelingStrategy> relabeling_stra
     // ForestTrainer 包含了训练一个树的所有函数
 
 Forest ForestTrainer::train(const Data& data, const ForestOptions& options) const {
+  TrainingControl control;
+  return train(data, options, control);
+}
+
+Forest ForestTrainer::train(const Data& data,
+                            const ForestOptions& options,
+                            TrainingControl& control) const {
   // 所有的树被存储在一个 std::vector 中，train_trees 将返回多颗树
-  std::vector<std::unique_ptr<Tree>> trees = train_trees(data, options);
+  std::vector<std::unique_ptr<Tree>> trees = train_trees(data, options, control);
 
   size_t num_variables = data.get_num_cols() - data.get_disallowed_split_variables().size();
   size_t ci_group_size = options.get_ci_group_size();
@@ -45,7 +53,8 @@ Forest ForestTrainer::train(const Data& data, const ForestOptions& options) cons
 }
 
 std::vector<std::unique_ptr<Tree>> ForestTrainer::train_trees(const Data& data,
-                                                              const ForestOptions& options) const {
+                                                              const ForestOptions& options,
+                                                              TrainingControl& control) const {
   size_t num_samples = data.get_num_rows();
   uint num_trees = options.get_num_trees();
 
@@ -68,30 +77,42 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_trees(const Data& data,
   std::vector<uint> thread_ranges;
   split_sequence(thread_ranges, 0, num_groups - 1, options.get_num_threads());
 
-  std::vector<std::future<std::vector<std::unique_ptr<Tree>>>> futures;
-  futures.reserve(thread_ranges.size());
+  size_t num_batches = thread_ranges.size() - 1;
+  std::vector<std::vector<std::unique_ptr<Tree>>> trees_by_batch(num_batches);
+  auto train_batch_task = [&](size_t batch) {
+    size_t start_index = thread_ranges[batch];
+    size_t num_trees_batch = thread_ranges[batch + 1] - start_index;
+    trees_by_batch[batch] = train_batch(start_index, num_trees_batch, data, options, control);
+  };
+
+  control.start(num_groups * options.get_ci_group_size());
+
+  ThreadPool& pool = ThreadPool::get_instance();
+  if (control.has_progress_callback() || control.has_time_budget()) {
+    // Leave the batches to the pool workers and wake up regularly on this thread to report
+    // progress. If reporting throws, stop the workers before rethrowing as they reference `data`.
+    std::future<void> done = pool.parallel_for_async(num_batches, options.get_num_threads(), train_batch_task);
+    try {
+      while (done.wait_for(control.get_poll_interval()) != std::future_status::ready) {
+        control.report_progress();
+      }
+    } catch (...) {
+      control.cancel();
+      done.wait();
+      throw;
+    }
+    done.get();
+  } else {
+    pool.parallel_for(num_batches, options.get_num_threads(), train_batch_task);
+  }
+  control.report_progress();
 
   std::vector<std::unique_ptr<Tree>> trees;
   trees.reserve(num_trees);
-
-  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
-    size_t start_index = thread_ranges[i];
-    size_t num_trees_batch = thread_ranges[i + 1] - start_index;
-
-    futures.push_back(std::async(std::launch::async,
-                                 &ForestTrainer::train_batch,
-                                 this,
-                                 start_index,
-                                 num_trees_batch,
-                                 std::ref(data),
-                                 options));
-  }
-
-  for (auto& future : futures) {
-    std::vector<std::unique_ptr<Tree>> thread_trees = future.get();
+  for (auto& batch_trees : trees_by_batch) {
     trees.insert(trees.end(),
-                 std::make_move_iterator(thread_trees.begin()),
-                 std::make_move_iterator(thread_trees.end()));
+                 std::make_move_iterator(batch_trees.begin()),
+                 std::make_move_iterator(batch_trees.end()));
   }
 
   return trees;
@@ -101,7 +122,8 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_batch(
     size_t start,
     size_t num_trees,
     const Data& data,
-    const ForestOptions& options) const {
+    const ForestOptions& options,
+    TrainingControl& control) const {
   size_t ci_group_size = options.get_ci_group_size();
 
   // ----------------------------------------------
@@ -125,17 +147,28 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_batch(
   std::vector<std::unique_ptr<Tree>> trees;
 
   // 预分配足够的空间，提高性能
-  // trees.reserve(num_trees * ci_group_size);
-  trees.reserve(num_trees);
+  trees.reserve(num_trees * ci_group_size);
 
   for (size_t i = 0; i < num_trees; i++) {
+    if (control.should_stop()) {
+      break;
+    }
     uint tree_seed = udist(random_number_generator);
 
     // 定义一个随机采样器
     RandomSampler sampler(tree_seed, options.get_sampling_options());
 
-    std::unique_ptr<Tree> tree = train_tree(data, sampler, options, block_group_size);
-    trees.push_back(std::move(tree));
+    // 置信区间组：同一组的树从同一个半样本（block 半样本）中二次抽样
+    if (ci_group_size == 1) {
+      std::unique_ptr<Tree> tree = train_tree(data, sampler, options, block_group_size);
+      trees.push_back(std::move(tree));
+    } else {
+      std::vector<std::unique_ptr<Tree>> group = train_ci_group(data, sampler, options, block_group_size);
+      trees.insert(trees.end(),
+                   std::make_move_iterator(group.begin()),
+                   std::make_move_iterator(group.end()));
+    }
+    control.add_trees_done(ci_group_size);
   }
   return trees;
 }
@@ -149,13 +182,28 @@ std::unique_ptr<Tree> ForestTrainer::train_tree(const Data& data,
   std::vector<size_t> clusters;
   std::vector<std::vector<size_t>> blocks_clusters;
 
-  sampler.sample_clusters(data.get_num_rows(), options.get_sample_fraction(), clusters, blocks_clusters, block_group_size);
+  draw_blocks(data, sampler, options, options.get_sample_fraction(), clusters, blocks_clusters, block_group_size);
   // 下面代码的作用：重新洗牌抽样，对clasters进行赋值修改
   /*  由于 clusters 是通过引用传递的，
   所以在 sample_clusters 方法内部所做的所有修改都会反映在外部传入的 clusters 向量中*/
   return tree_trainer.train(data, sampler, clusters, options.get_tree_options(), blocks_clusters);
 }
 
+// 抽取样本块：面板数据按序列分别抽块，避免块跨越两个序列
+void ForestTrainer::draw_blocks(const Data& data,
+                                RandomSampler& sampler,
+                                const ForestOptions& options,
+                                double sample_fraction,
+                                std::vector<size_t>& clusters,
+                                std::vector<std::vector<size_t>>& blocks_clusters,
+                                int block_group_size) const {
+  if (options.get_if_block() && !data.get_series_rows().empty()) {
+    sampler.sample_series_blocks(data.get_series_rows(), sample_fraction, clusters, blocks_clusters, block_group_size);
+  } else {
+    sampler.sample_clusters(data.get_num_rows(), sample_fraction, clusters, blocks_clusters, block_group_size);
+  }
+}
+
 // 训练置信区间组，进行多次抽样
 std::vector<std::unique_ptr<Tree>> ForestTrainer::train_ci_group(const Data& data,
                                                                  RandomSampler& sampler,
@@ -167,7 +215,7 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_ci_group(const Data& dat
   std::vector<std::vector<size_t>> blocks_clusters;
 
   // 第一次进行 默认为 0.5 的抽样
-  sampler.sample_clusters(data.get_num_rows(), 0.5, clusters, blocks_clusters, block_group_size); // 调用 block 抽样
+  draw_blocks(data, sampler, options, 0.5, clusters, blocks_clusters, block_group_size); // 调用 block 抽样
 
   double sample_fraction = options.get_sample_fraction();
 
@@ -69,19 +69,22 @@ ForestTrainer multi_causal_trainer(size_t num_treatments,
                        std::move(prediction_strategy));
 }
 
-ForestTrainer quantile_trainer(const std::vector<double>& quantiles) {
+ForestTrainer quantile_trainer(const std::vector<double>& quantiles,
+                               const SplitValueOptions& split_value_options) {
     std::unique_ptr<RelabelingStrategy> relabeling_strategy(new QuantileRelabelingStrategy(quantiles));
   std::unique_ptr<SplittingRuleFactory> splitting_rule_factory(
-      new ProbabilitySplittingRuleFactory(quantiles.size() + 1));
+      new ProbabilitySplittingRuleFactory(quantiles.size() + 1, split_value_options));
 
   return ForestTrainer(std::move(relabeling_strategy),
                        std::move(splitting_rule_factory),
                        nullptr);
 }
 
-ForestTrainer probability_trainer(size_t num_classes) {
+ForestTrainer probability_trainer(size_t num_classes,
+                                  const SplitValueOptions& split_value_options) {
   std::unique_ptr<RelabelingStrategy> relabeling_strategy(new NoopRelabelingStrategy());
-  std::unique_ptr<SplittingRuleFactory> splitting_rule_factory(new ProbabilitySplittingRuleFactory(num_classes));
+  std::unique_ptr<SplittingRuleFactory> splitting_rule_factory(
+      new ProbabilitySplittingRuleFactory(num_classes, split_value_options));
   std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(new ProbabilityPredictionStrategy(num_classes));
 
   return ForestTrainer(std::move(relabeling_strategy),
@@ -89,9 +92,9 @@ ForestTrainer probability_trainer(size_t num_classes) {
                        std::move(prediction_strategy));
 }
 
-ForestTrainer regression_trainer() {
+ForestTrainer regression_trainer(const SplitValueOptions& split_value_options) {
   std::unique_ptr<RelabelingStrategy> relabeling_strategy(new NoopRelabelingStrategy());
-  std::unique_ptr<SplittingRuleFactory> splitting_rule_factory(new RegressionSplittingRuleFactory());
+  std::unique_ptr<SplittingRuleFactory> splitting_rule_factory(new RegressionSplittingRuleFactory(split_value_options));
   std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(new RegressionPredictionStrategy());
 
   return ForestTrainer(std::move(relabeling_strategy),
@@ -99,9 +102,11 @@ ForestTrainer regression_trainer() {
                        std::move(prediction_strategy));
 }
 
-ForestTrainer multi_regression_trainer(size_t num_outcomes) {
+ForestTrainer multi_regression_trainer(size_t num_outcomes,
+                                       const SplitValueOptions& split_value_options) {
   std::unique_ptr<RelabelingStrategy> relabeling_strategy(new MultiNoopRelabelingStrategy(num_outcomes));
-  std::unique_ptr<SplittingRuleFactory> splitting_rule_factory(new MultiRegressionSplittingRuleFactory(num_outcomes));
+  std::unique_ptr<SplittingRuleFactory> splitting_rule_factory(
+      new MultiRegressionSplittingRuleFactory(num_outcomes, split_value_options));
   std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(new MultiRegressionPredictionStrategy(num_outcomes));
 
   return ForestTrainer(std::move(relabeling_strategy),
@@ -0,0 +1,67 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_FORESTTUNER_H
+#define GRF_FORESTTUNER_H
+
+#include <vector>
+
+#include "forest/ForestOptions.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestTrainer.h"
+
+namespace grf {
+
+/**
+ * Evaluates candidate parameter settings for hyperparameter tuning.
+ *
+ * For each candidate a small forest is trained on the shared training data and
+ * scored by its debiased out-of-bag error. The candidates are independent, so they
+ * are trained concurrently on the shared thread pool, one candidate per task.
+ * Each candidate forest is grown with the number of threads of its own options,
+ * which should usually be 1 so that the scores do not depend on `num_threads`.
+ */
+class ForestTuner {
+public:
+  ForestTuner(const ForestTrainer& trainer,
+              const ForestPredictor& predictor);
+
+  /**
+   * @param data: the training data, shared by all candidates.
+   * @param candidates: the forest options to evaluate.
+   * @param num_threads: the number of candidates trained at once.
+   * @return the mean debiased OOB error of each candidate, in the order of `candidates`.
+   * The error is NaN if the candidate could not be trained (for example because its
+   * sample fraction leaves no observations) or none of its OOB error estimates were finite.
+   */
+  std::vector<double> compute_errors(const Data& data,
+                                     const std::vector<ForestOptions>& candidates,
+                                     uint num_threads) const;
+
+  /**
+   * The mean of the debiased error estimates in `predictions`, ignoring NaN entries.
+   */
+  static double mean_debiased_error(const std::vector<Prediction>& predictions);
+
+private:
+  const ForestTrainer& trainer;
+  const ForestPredictor& predictor;
+};
+
+} // namespace grf
+
+#endif //GRF_FORESTTUNER_H
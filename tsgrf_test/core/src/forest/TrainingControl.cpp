@@ -0,0 +1,108 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "forest/TrainingControl.h"
+
+namespace grf {
+
+// Used when only a time budget (and no progress callback) is set, so that
+// the trainer still wakes up regularly.
+static const double DEFAULT_POLL_INTERVAL = 0.1;
+
+TrainingControl::TrainingControl():
+    cancelled(false),
+    num_trees_done(0),
+    num_trees(0),
+    time_budget(0),
+    poll_interval(DEFAULT_POLL_INTERVAL) {}
+
+void TrainingControl::set_time_budget(double seconds) {
+  this->time_budget = (std::isfinite(seconds) && seconds > 0) ? seconds : 0;
+}
+
+void TrainingControl::set_progress_callback(const ProgressCallback& callback,
+                                            double interval_seconds) {
+  this->progress_callback = callback;
+  this->poll_interval = interval_seconds > 0 ? interval_seconds : DEFAULT_POLL_INTERVAL;
+}
+
+void TrainingControl::cancel() {
+  cancelled = true;
+}
+
+bool TrainingControl::is_cancelled() const {
+  return cancelled;
+}
+
+bool TrainingControl::should_stop() const {
+  if (cancelled) {
+    return true;
+  }
+  return time_budget > 0 && std::chrono::steady_clock::now() >= deadline;
+}
+
+bool TrainingControl::stopped_early() const {
+  return num_trees_done < num_trees;
+}
+
+size_t TrainingControl::get_num_trees_done() const {
+  return num_trees_done;
+}
+
+void TrainingControl::start(size_t num_trees) {
+  this->num_trees = num_trees;
+  this->num_trees_done = 0;
+  this->start_time = std::chrono::steady_clock::now();
+  this->deadline = start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(time_budget));
+}
+
+void TrainingControl::add_trees_done(size_t num_trees) {
+  num_trees_done += num_trees;
+}
+
+std::chrono::milliseconds TrainingControl::get_poll_interval() const {
+  return std::chrono::milliseconds(static_cast<long>(std::ceil(poll_interval * 1000)));
+}
+
+bool TrainingControl::has_progress_callback() const {
+  return static_cast<bool>(progress_callback);
+}
+
+bool TrainingControl::has_time_budget() const {
+  return time_budget > 0;
+}
+
+bool TrainingControl::report_progress() {
+  if (progress_callback) {
+    size_t done = num_trees_done;
+    double eta = NAN;
+    if (done > 0) {
+      double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+      eta = elapsed / done * (num_trees - std::min(done, num_trees));
+    }
+    if (!progress_callback(done, num_trees, eta)) {
+      cancel();
+    }
+  }
+  return !should_stop();
+}
+
+} // namespace grf
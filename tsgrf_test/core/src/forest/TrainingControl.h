@@ -0,0 +1,119 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_TRAININGCONTROL_H
+#define GRF_TRAININGCONTROL_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+#include "commons/globals.h"
+
+namespace grf {
+
+/**
+ * Cooperative control over a running ForestTrainer::train call.
+ *
+ * Every training worker checks `should_stop` before starting its next tree (or
+ * confidence interval group), so a stopped run still returns a valid forest made
+ * of the trees completed so far. Training stops early once the wall-clock time
+ * budget has elapsed, `cancel` has been called (from any thread), or the
+ * progress callback returned false.
+ *
+ * The progress callback is only ever invoked on the thread that called
+ * ForestTrainer::train, never on a worker, which makes it a safe place to
+ * poll for user interrupts.
+ */
+class TrainingControl {
+public:
+  /**
+   * @param num_trees_done: the number of trees trained so far.
+   * @param num_trees: the number of trees requested.
+   * @param eta_seconds: the estimated remaining training time in seconds
+   * (NaN until the first tree has finished).
+   * @return false to stop training.
+   */
+  typedef std::function<bool(size_t num_trees_done, size_t num_trees, double eta_seconds)> ProgressCallback;
+
+  TrainingControl();
+
+  /**
+   * Stop starting new trees once `seconds` of wall-clock time have elapsed
+   * since training started. A non-positive or non-finite value disables the budget.
+   */
+  void set_time_budget(double seconds);
+
+  /**
+   * Invoke `callback` roughly every `interval_seconds` while training is running,
+   * and once more when it has finished.
+   */
+  void set_progress_callback(const ProgressCallback& callback,
+                             double interval_seconds);
+
+  /**
+   * Request that training stops. Trees already being grown are finished.
+   */
+  void cancel();
+
+  bool is_cancelled() const;
+
+  /**
+   * True if the trainer should not start another tree.
+   */
+  bool should_stop() const;
+
+  /**
+   * True if the last training run ended before all requested trees were grown.
+   */
+  bool stopped_early() const;
+
+  size_t get_num_trees_done() const;
+
+  /**
+   * The following methods are intended for internal use by ForestTrainer.
+   */
+  void start(size_t num_trees);
+  void add_trees_done(size_t num_trees);
+  std::chrono::milliseconds get_poll_interval() const;
+  bool has_progress_callback() const;
+  bool has_time_budget() const;
+
+  /**
+   * Invokes the progress callback (if any) and cancels training if it returns false.
+   * @return false if training should stop.
+   */
+  bool report_progress();
+
+private:
+  std::atomic<bool> cancelled;
+  std::atomic<size_t> num_trees_done;
+  size_t num_trees;
+
+  double time_budget;
+  std::chrono::steady_clock::time_point start_time;
+  std::chrono::steady_clock::time_point deadline;
+
+  ProgressCallback progress_callback;
+  double poll_interval;
+
+  DISALLOW_COPY_AND_ASSIGN(TrainingControl);
+};
+
+} // namespace grf
+
+#endif //GRF_TRAININGCONTROL_H
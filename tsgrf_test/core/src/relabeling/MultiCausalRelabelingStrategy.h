@@ -53,6 +53,17 @@ public:
   size_t get_response_length() const;
 
 private:
+  /**
+   * Instantiated for 1 to 4 treatments, so that the treatment covariance and its inverse
+   * are fixed-size matrices with closed-form determinants and inverses. NUM_TREATMENTS =
+   * Eigen::Dynamic is the fallback for any other number of treatments.
+   */
+  template <int NUM_TREATMENTS>
+  bool relabel_internal(
+      const std::vector<size_t>& samples,
+      const Data& data,
+      Eigen::ArrayXXd& responses_by_sample) const;
+
   size_t response_length;
   std::vector<double> gradient_weights;
 };
@@ -13,6 +13,7 @@
  #-------------------------------------------------------------------------------*/
 
 #include <algorithm>
+#include <cmath>
 #include <random>
 #include <cstddef>
 
@@ -55,6 +56,45 @@ void RandomSampler::sample_clusters(size_t num_rows,
   }
 }
 
+void RandomSampler::sample_series_blocks(const std::vector<std::vector<size_t>>& series,
+                                         double sample_fraction,
+                                         std::vector<size_t>& samples,
+                                         std::vector<std::vector<size_t>>& blocks,
+                                         int block_group_size) {
+  if (!options.get_clusters().empty()) {
+    throw std::runtime_error("Panel block sampling does not support clustered samples.");
+  }
+
+  size_t num_rows = 0;
+  for (const auto& rows : series) {
+    num_rows += rows.size();
+  }
+  double rows_per_series = sample_fraction * num_rows / series.size();
+
+  for (const auto& rows : series) {
+    size_t n_series = rows.size();
+    size_t block_num = (size_t) std::ceil(std::pow(n_series, 1.0 / block_group_size));
+    size_t block_size = (size_t) std::floor(n_series / block_num);
+    if (block_size == 0) {
+      continue;
+    }
+    size_t block_sample_num;
+    if (options.get_equal_series_allocation()) {
+      block_sample_num = (size_t) std::ceil(rows_per_series / block_size);
+    } else {
+      block_sample_num = (size_t) std::ceil(block_size * sample_fraction);
+    }
+
+    nonstd::uniform_int_distribution<size_t> start_dist(0, n_series - block_size);
+    for (size_t i = 0; i < block_sample_num; i++) {
+      size_t start_index = start_dist(random_number_generator);
+      std::vector<size_t> block(rows.begin() + start_index, rows.begin() + start_index + block_size);
+      samples.insert(samples.end(), block.begin(), block.end());
+      blocks.push_back(std::move(block));
+    }
+  }
+}
+
 void RandomSampler::sample(size_t num_samples,
                            double sample_fraction,
                            std::vector<size_t>& samples) {
@@ -279,7 +319,8 @@ void RandomSampler::subsample_sub3(const std::vector<size_t>& samples,
         if (window_size >= block.size()) {
             subsamples.insert(subsamples.end(), block.begin(), block.end());
         } else {
-            size_t start_index = rand() % (block.size() - window_size + 1);
+            nonstd::uniform_int_distribution<size_t> start_dist(0, block.size() - window_size);
+            size_t start_index = start_dist(random_number_generator);
 
             subsamples.insert(subsamples.end(), block.begin() + start_index, block.begin() + start_index + window_size);
 
@@ -393,8 +434,9 @@ void RandomSampler::block_and_split(std::vector<size_t>& samples,
   size_t block_sample_num  =(size_t) std::ceil(block_size * sample_fraction);
   samples.resize(block_sample_num * block_size);
   size_t index = 0;
+  nonstd::uniform_int_distribution<size_t> start_dist(0, n_all - block_size);
   for (size_t i = 0; i < block_sample_num; i++){
-    size_t start_index = rand() % (n_all - block_size + 1);
+    size_t start_index = start_dist(random_number_generator);
     std::vector<size_t> block(block_size);
     std::iota(block.begin(), block.end(), start_index);
     std::iota(samples.begin() + index, samples.begin() + index + block_size, start_index);
@@ -470,4 +512,9 @@ size_t RandomSampler::sample_poisson(size_t mean) {
   return distribution(random_number_generator);
 }
 
+double RandomSampler::sample_uniform(double min, double max) {
+  nonstd::uniform_real_distribution<double> distribution(min, max);
+  return distribution(random_number_generator);
+}
+
 } // namespace grf
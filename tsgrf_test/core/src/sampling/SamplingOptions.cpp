@@ -23,11 +23,18 @@ namespace grf {
 
 SamplingOptions::SamplingOptions():
     num_samples_per_cluster(0),
+    equal_series_allocation(false),
     clusters(0) {}
 
 SamplingOptions::SamplingOptions(uint samples_per_cluster,
                                  const std::vector<size_t>& sample_clusters):
-    num_samples_per_cluster(samples_per_cluster) {
+    SamplingOptions(samples_per_cluster, sample_clusters, false) {}
+
+SamplingOptions::SamplingOptions(uint samples_per_cluster,
+                                 const std::vector<size_t>& sample_clusters,
+                                 bool equal_series_allocation):
+    num_samples_per_cluster(samples_per_cluster),
+    equal_series_allocation(equal_series_allocation) {
 
   // Map the provided clusters to IDs in the range 0 ... num_clusters.
   // 为每个 cluster 分配一个唯一标识符
@@ -52,6 +59,10 @@ unsigned int SamplingOptions::get_samples_per_cluster() const {
   return num_samples_per_cluster;
 }
 
+bool SamplingOptions::get_equal_series_allocation() const {
+  return equal_series_allocation;
+}
+
 const std::vector<std::vector<size_t>>& SamplingOptions::get_clusters() const {
   return clusters;
 }
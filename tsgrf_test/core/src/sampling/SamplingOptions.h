@@ -31,6 +31,9 @@ public:
   SamplingOptions();
   SamplingOptions(uint samples_per_cluster,
                   const std::vector<size_t>& clusters);
+  SamplingOptions(uint samples_per_cluster,
+                  const std::vector<size_t>& clusters,
+                  bool equal_series_allocation);
 
   /**
    * A map from each cluster ID to the set of sample IDs it contains.
@@ -43,8 +46,16 @@ public:
    */
   uint get_samples_per_cluster() const;
 
+  /**
+   * For panel data (see Data::set_series_index): whether block sampling draws the
+   * same number of rows from every series, instead of a number proportional to
+   * the length of the series.
+   */
+  bool get_equal_series_allocation() const;
+
 private:
   uint num_samples_per_cluster;
+  bool equal_series_allocation;
   std::vector<std::vector<size_t>> clusters;
 };
 
@@ -28,7 +28,8 @@ CausalSurvivalSplittingRule::CausalSurvivalSplittingRule(size_t max_num_unique_v
                                                          double imbalance_penalty):
     min_node_size(min_node_size),
     alpha(alpha),
-    imbalance_penalty(imbalance_penalty) {
+    imbalance_penalty(imbalance_penalty),
+    scan(max_num_unique_values) {
   this->counter = new size_t[max_num_unique_values];
   this->weight_sums = new double[max_num_unique_values];
   this->sums = new double[max_num_unique_values];
@@ -149,7 +150,7 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
                                                         const std::vector<std::vector<size_t>>& samples) {
   std::vector<double> possible_split_values;
   std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  get_all_values(data, sorted_samples_cache, possible_split_values, sorted_samples, samples[node], var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -173,6 +174,8 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
   size_t num_small_z_missing = 0;
   size_t num_failures_missing = 0;
 
+  // Columns without NaN skip the missing value checks.
+  bool has_nan = data.has_nan(var);
   size_t split_index = 0;
   for (size_t i = 0; i < num_samples - 1; i++) {
     size_t sample = sorted_samples[i];
@@ -181,7 +184,7 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
     double z = data.get_instrument(sample);
     double sample_weight = data.get_weight(sample);
 
-    if (std::isnan(sample_value)) {
+    if (has_nan && std::isnan(sample_value)) {
       weight_sum_missing += sample_weight;
       sum_missing += sample_weight * responses_by_sample(sample, 0);
       ++n_missing;
@@ -212,7 +215,7 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
     double next_sample_value = data.get(next_sample, var);
     // if the next sample value is different, including the transition (..., NaN, Xij, ...)
     // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
+    if (sample_value != next_sample_value && (!has_nan || !std::isnan(next_sample_value))) {
       ++split_index;
     }
   }
@@ -243,6 +246,7 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
       num_failures_left = 0;
     }
 
+    scan.clear();
     for (size_t i = 0; i < num_splits; ++i) {
       // not necessary to evaluate sending right when splitting on NaN.
       if (i == 0 && !send_left) {
@@ -293,7 +297,6 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
 
       // Calculate relevant quantities for the left child.
       double weight_sum_right = weight_sum_node - weight_sum_left;
-      double sum_right = sum_node - sum_left;
       double sum_right_z_squared = sum_node_z_squared - sum_left_z_squared;
       double sum_right_z = sum_node_z - sum_left_z;
       double size_right = sum_right_z_squared - sum_right_z * sum_right_z / weight_sum_right;
@@ -303,18 +306,15 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
         continue;
       }
 
-      // Calculate the decrease in impurity.
-      double decrease = sum_left * sum_left / weight_sum_left + sum_right * sum_right / weight_sum_right;
-      // Penalize splits that are too close to the edges of the data.
-      decrease -= imbalance_penalty * (1.0 / size_left + 1.0 / size_right);
-
-      // Save this split if it is the best seen so far.
-      if (decrease > best_decrease) {
-        best_value = possible_split_values[i];
-        best_var = var;
-        best_decrease = decrease;
-        best_send_missing_left = send_left;
-      }
+      scan.add(i, sum_left, weight_sum_left, size_left, size_right);
+    }
+
+    // Save the best split of this direction if it is the best seen so far.
+    size_t best_split;
+    if (scan.find_best(sum_node, weight_sum_node, imbalance_penalty, best_decrease, best_split)) {
+      best_value = possible_split_values[best_split];
+      best_var = var;
+      best_send_missing_left = send_left;
     }
   }
 }
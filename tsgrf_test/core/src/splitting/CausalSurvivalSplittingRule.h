@@ -19,6 +19,7 @@
 #define GRF_CAUSALSURVIVALSPLITTINGRULE_H
 
 #include "commons/Data.h"
+#include "splitting/SplitScan.h"
 #include "splitting/SplittingRule.h"
 
 namespace grf {
@@ -78,6 +79,7 @@ private:
   uint min_node_size;
   double alpha;
   double imbalance_penalty;
+  SplitScan scan;
 
   DISALLOW_COPY_AND_ASSIGN(CausalSurvivalSplittingRule);
 };
@@ -28,7 +28,8 @@ InstrumentalSplittingRule::InstrumentalSplittingRule(size_t max_num_unique_value
                                                      double imbalance_penalty):
     min_node_size(min_node_size),
     alpha(alpha),
-    imbalance_penalty(imbalance_penalty) {
+    imbalance_penalty(imbalance_penalty),
+    scan(max_num_unique_values) {
   this->counter = new size_t[max_num_unique_values];
   this->weight_sums = new double[max_num_unique_values];
   this->sums = new double[max_num_unique_values];
@@ -66,6 +67,23 @@ bool InstrumentalSplittingRule::find_best_split(const Data& data,
                                                 std::vector<size_t>& split_vars,
                                                 std::vector<double>& split_values,
                                                 std::vector<bool>& send_missing_left) {
+  if (data.has_weights()) {
+    return find_best_split_internal<SampleWeights>(data, node, possible_split_vars, responses_by_sample, samples,
+                                                   split_vars, split_values, send_missing_left);
+  }
+  return find_best_split_internal<UnitWeights>(data, node, possible_split_vars, responses_by_sample, samples,
+                                               split_vars, split_values, send_missing_left);
+}
+
+template <class Weights>
+bool InstrumentalSplittingRule::find_best_split_internal(const Data& data,
+                                                         size_t node,
+                                                         const std::vector<size_t>& possible_split_vars,
+                                                         const Eigen::ArrayXXd& responses_by_sample,
+                                                         const std::vector<std::vector<size_t>>& samples,
+                                                         std::vector<size_t>& split_vars,
+                                                         std::vector<double>& split_values,
+                                                         std::vector<bool>& send_missing_left) {
   size_t num_samples = samples[node].size();
 
   // Precompute relevant quantities for this node.
@@ -74,7 +92,7 @@ bool InstrumentalSplittingRule::find_best_split(const Data& data,
   double sum_node_z = 0.0;
   double sum_node_z_squared = 0.0;
   for (auto& sample : samples[node]) {
-    double sample_weight = data.get_weight(sample);
+    double sample_weight = Weights::get(data, sample);
     weight_sum_node += sample_weight;
     sum_node += sample_weight * responses_by_sample(sample, 0);
 
@@ -102,9 +120,9 @@ bool InstrumentalSplittingRule::find_best_split(const Data& data,
   bool best_send_missing_left = true;
 
   for (auto& var : possible_split_vars) {
-    find_best_split_value(data, node, var, num_samples, weight_sum_node, sum_node, mean_z_node, num_node_small_z,
-                          sum_node_z, sum_node_z_squared, min_child_size, best_value,
-                          best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    find_best_split_value<Weights>(data, node, var, num_samples, weight_sum_node, sum_node, mean_z_node,
+                                   num_node_small_z, sum_node_z, sum_node_z_squared, min_child_size, best_value,
+                                   best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
   }
 
   // Stop if no good split found
@@ -119,6 +137,7 @@ bool InstrumentalSplittingRule::find_best_split(const Data& data,
   return false;
 }
 
+template <class Weights>
 void InstrumentalSplittingRule::find_best_split_value(const Data& data,
                                                       size_t node, size_t var,
                                                       size_t num_samples,
@@ -137,7 +156,7 @@ void InstrumentalSplittingRule::find_best_split_value(const Data& data,
                                                       const std::vector<std::vector<size_t>>& samples) {
   std::vector<double> possible_split_values;
   std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  get_all_values(data, sorted_samples_cache, possible_split_values, sorted_samples, samples[node], var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -159,15 +178,17 @@ void InstrumentalSplittingRule::find_best_split_value(const Data& data,
   double sum_z_squared_missing = 0;
   size_t num_small_z_missing = 0;
 
+  // Columns without NaN skip the missing value checks.
+  bool has_nan = data.has_nan(var);
   size_t split_index = 0;
   for (size_t i = 0; i < num_samples - 1; i++) {
     size_t sample = sorted_samples[i];
     size_t next_sample = sorted_samples[i + 1];
     double sample_value = data.get(sample, var);
     double z = data.get_instrument(sample);
-    double sample_weight = data.get_weight(sample);
+    double sample_weight = Weights::get(data, sample);
 
-    if (std::isnan(sample_value)) {
+    if (has_nan && std::isnan(sample_value)) {
       weight_sum_missing += sample_weight;
       sum_missing += sample_weight * responses_by_sample(sample, 0);
       ++n_missing;
@@ -192,7 +213,7 @@ void InstrumentalSplittingRule::find_best_split_value(const Data& data,
     double next_sample_value = data.get(next_sample, var);
     // if the next sample value is different, including the transition (..., NaN, Xij, ...)
     // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
+    if (sample_value != next_sample_value && (!has_nan || !std::isnan(next_sample_value))) {
       ++split_index;
     }
   }
@@ -221,6 +242,7 @@ void InstrumentalSplittingRule::find_best_split_value(const Data& data,
       num_left_small_z = 0;
     }
 
+    scan.clear();
     for (size_t i = 0; i < num_splits; ++i) {
       // not necessary to evaluate sending right when splitting on NaN.
       if (i == 0 && !send_left) {
@@ -259,7 +281,6 @@ void InstrumentalSplittingRule::find_best_split_value(const Data& data,
 
       // Calculate relevant quantities for the right child.
       double weight_sum_right = weight_sum_node - weight_sum_left;
-      double sum_right = sum_node - sum_left;
       double sum_right_z_squared = sum_node_z_squared - sum_left_z_squared;
       double sum_right_z = sum_node_z - sum_left_z;
       double size_right = sum_right_z_squared - sum_right_z * sum_right_z / weight_sum_right;
@@ -269,18 +290,15 @@ void InstrumentalSplittingRule::find_best_split_value(const Data& data,
         continue;
       }
 
-      // Calculate the decrease in impurity.
-      double decrease = sum_left * sum_left / weight_sum_left + sum_right * sum_right / weight_sum_right;
-      // Penalize splits that are too close to the edges of the data.
-      decrease -= imbalance_penalty * (1.0 / size_left + 1.0 / size_right);
-
-      // Save this split if it is the best seen so far.
-      if (decrease > best_decrease) {
-        best_value = possible_split_values[i];
-        best_var = var;
-        best_decrease = decrease;
-        best_send_missing_left = send_left;
-      }
+      scan.add(i, sum_left, weight_sum_left, size_left, size_right);
+    }
+
+    // Save the best split of this direction if it is the best seen so far.
+    size_t best_split;
+    if (scan.find_best(sum_node, weight_sum_node, imbalance_penalty, best_decrease, best_split)) {
+      best_value = possible_split_values[best_split];
+      best_var = var;
+      best_send_missing_left = send_left;
     }
   }
 }
@@ -19,6 +19,8 @@
 #define GRF_INSTRUMENTALSPLITTINGRULE_H
 
 #include "commons/Data.h"
+#include "commons/SampleWeights.h"
+#include "splitting/SplitScan.h"
 #include "splitting/SplittingRule.h"
 
 namespace grf {
@@ -41,6 +43,20 @@ public:
                        std::vector<bool>& send_missing_left);
 
 private:
+  /**
+   * Instantiated for weighted (SampleWeights) and unweighted (UnitWeights) data.
+   */
+  template <class Weights>
+  bool find_best_split_internal(const Data& data,
+                                size_t node,
+                                const std::vector<size_t>& possible_split_vars,
+                                const Eigen::ArrayXXd& responses_by_sample,
+                                const std::vector<std::vector<size_t>>& samples,
+                                std::vector<size_t>& split_vars,
+                                std::vector<double>& split_values,
+                                std::vector<bool>& send_missing_left);
+
+  template <class Weights>
   void find_best_split_value(const Data& data,
                              size_t node,
                              size_t var,
@@ -69,6 +85,7 @@ private:
   uint min_node_size;
   double alpha;
   double imbalance_penalty;
+  SplitScan scan;
 
   DISALLOW_COPY_AND_ASSIGN(InstrumentalSplittingRule);
 };
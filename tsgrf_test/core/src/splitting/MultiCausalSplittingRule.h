@@ -60,18 +60,34 @@ public:
                        std::vector<bool>& send_missing_left);
 
 private:
+  /**
+   * The split search is instantiated for 1 to 4 treatments, so that the per-treatment
+   * statistics are fixed-size Eigen arrays on the stack. NUM_TREATMENTS = Eigen::Dynamic
+   * is the fallback for any other number of treatments.
+   */
+  template <int NUM_TREATMENTS>
+  bool find_best_split_internal(const Data& data,
+                                size_t node,
+                                const std::vector<size_t>& possible_split_vars,
+                                const Eigen::ArrayXXd& responses_by_sample,
+                                const std::vector<std::vector<size_t>>& samples,
+                                std::vector<size_t>& split_vars,
+                                std::vector<double>& split_values,
+                                std::vector<bool>& send_missing_left);
+
+  template <int NUM_TREATMENTS>
   void find_best_split_value(const Data& data,
                              size_t node,
                              size_t var,
                              size_t num_samples,
                              double weight_sum_node,
                              const Eigen::ArrayXd& sum_node,
-                             const Eigen::ArrayXd& mean_node_w,
-                             const Eigen::ArrayXi& sum_node_small_w,
-                             const Eigen::ArrayXd& sum_node_w,
-                             const Eigen::ArrayXd& sum_node_w_squared,
-                             const Eigen::ArrayXd& min_child_size,
-                             const Eigen::ArrayXXd& treatments,
+                             const Eigen::Array<double, NUM_TREATMENTS, 1>& mean_node_w,
+                             const Eigen::Array<int, NUM_TREATMENTS, 1>& sum_node_small_w,
+                             const Eigen::Array<double, NUM_TREATMENTS, 1>& sum_node_w,
+                             const Eigen::Array<double, NUM_TREATMENTS, 1>& sum_node_w_squared,
+                             const Eigen::Array<double, NUM_TREATMENTS, 1>& min_child_size,
+                             const Eigen::Array<double, Eigen::Dynamic, NUM_TREATMENTS>& treatments,
                              double& best_value,
                              size_t& best_var,
                              double& best_decrease,
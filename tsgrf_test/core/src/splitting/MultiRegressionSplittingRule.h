@@ -19,6 +19,9 @@
 #define GRF_MULTIREGRESSIONSPLITTINGRULE_H
 
 #include "commons/Data.h"
+#include "commons/SampleWeights.h"
+#include "sampling/RandomSampler.h"
+#include "splitting/SplitValueOptions.h"
 #include "splitting/SplittingRule.h"
 #include "tree/Tree.h"
 
@@ -31,10 +34,13 @@ namespace grf {
  */
 class MultiRegressionSplittingRule final: public SplittingRule {
 public:
+  // `sampler` draws the random split values, and is required if `split_value_options` asks for them.
   MultiRegressionSplittingRule(size_t max_num_unique_values,
                                double alpha,
                                double imbalance_penalty,
-                               size_t num_outcomes);
+                               size_t num_outcomes,
+                               const SplitValueOptions& split_value_options = SplitValueOptions(),
+                               RandomSampler* sampler = nullptr);
 
   ~MultiRegressionSplittingRule();
 
@@ -48,11 +54,40 @@ public:
                        std::vector<bool>& send_missing_left);
 
 private:
+  /**
+   * Instantiated for weighted (SampleWeights) and unweighted (UnitWeights) data.
+   */
+  template <class Weights>
+  bool find_best_split_internal(const Data& data,
+                                size_t node,
+                                const std::vector<size_t>& possible_split_vars,
+                                const Eigen::ArrayXXd& responses_by_sample,
+                                const std::vector<std::vector<size_t>>& samples,
+                                std::vector<size_t>& split_vars,
+                                std::vector<double>& split_values,
+                                std::vector<bool>& send_missing_left);
+
+  /**
+   * The split search is instantiated for 1 to 4 outcomes, so that the outcome sums
+   * are fixed-size Eigen arrays on the stack. NUM_OUTCOMES = Eigen::Dynamic is the
+   * fallback for any other number of outcomes.
+   */
+  template <class Weights, int NUM_OUTCOMES>
+  bool find_best_split_values(const Data& data,
+                              size_t node,
+                              const std::vector<size_t>& possible_split_vars,
+                              const Eigen::ArrayXXd& responses_by_sample,
+                              const std::vector<std::vector<size_t>>& samples,
+                              std::vector<size_t>& split_vars,
+                              std::vector<double>& split_values,
+                              std::vector<bool>& send_missing_left);
+
+  template <class Weights, int NUM_OUTCOMES>
   void find_best_split_value(const Data& data,
                              size_t node,
                              size_t var,
                              double weight_sum_node,
-                             const Eigen::ArrayXd& sum_node,
+                             const Eigen::Array<double, NUM_OUTCOMES, 1>& sum_node,
                              size_t size_node,
                              size_t min_child_size,
                              double& best_value,
@@ -69,6 +104,8 @@ private:
   double alpha;
   double imbalance_penalty;
   size_t num_outcomes;
+  SplitValueOptions split_value_options;
+  RandomSampler* sampler;
 
   DISALLOW_COPY_AND_ASSIGN(MultiRegressionSplittingRule);
 };
@@ -17,22 +17,33 @@
 
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
 #include "ProbabilitySplittingRule.h"
+#include "splitting/SplitValues.h"
 
 namespace grf {
 
 ProbabilitySplittingRule::ProbabilitySplittingRule(size_t max_num_unique_values,
                                                    size_t num_classes,
                                                    double alpha,
-                                                   double imbalance_penalty) {
+                                                   double imbalance_penalty,
+                                                   const SplitValueOptions& split_value_options,
+                                                   RandomSampler* sampler) {
+  if (split_value_options.get_num_random_thresholds() > 0 && sampler == nullptr) {
+    throw std::runtime_error("Random split values need the tree's sampler.");
+  }
   this->num_classes = num_classes;
 
   this->alpha = alpha;
   this->imbalance_penalty = imbalance_penalty;
+  this->split_value_options = split_value_options;
+  this->sampler = sampler;
 
   this->counter = new size_t[max_num_unique_values];
   this->counter_per_class = new double[num_classes * max_num_unique_values];
+  this->class_counts.resize(num_classes);
+  this->class_counts_left.resize(num_classes);
 }
 
 ProbabilitySplittingRule::~ProbabilitySplittingRule() {
@@ -52,14 +63,31 @@ bool ProbabilitySplittingRule::find_best_split(const Data& data,
                                                std::vector<size_t>& split_vars,
                                                std::vector<double>& split_values,
                                                std::vector<bool>& send_missing_left) {
+  if (data.has_weights()) {
+    return find_best_split_internal<SampleWeights>(data, node, possible_split_vars, responses_by_sample, samples,
+                                                   split_vars, split_values, send_missing_left);
+  }
+  return find_best_split_internal<UnitWeights>(data, node, possible_split_vars, responses_by_sample, samples,
+                                               split_vars, split_values, send_missing_left);
+}
+
+template <class Weights>
+bool ProbabilitySplittingRule::find_best_split_internal(const Data& data,
+                                                        size_t node,
+                                                        const std::vector<size_t>& possible_split_vars,
+                                                        const Eigen::ArrayXXd& responses_by_sample,
+                                                        const std::vector<std::vector<size_t>>& samples,
+                                                        std::vector<size_t>& split_vars,
+                                                        std::vector<double>& split_values,
+                                                        std::vector<bool>& send_missing_left) {
   size_t size_node = samples[node].size();
   size_t min_child_size = std::max<size_t>(static_cast<size_t>(std::ceil(size_node * alpha)), 1uL);
 
-  double* class_counts = new double[num_classes]();
+  std::fill(class_counts.begin(), class_counts.end(), 0);
   for (size_t i = 0; i < size_node; ++i) {
     size_t sample = samples[node][i];
     uint sample_class = (uint) std::round(responses_by_sample(sample, 0));
-    double sample_weight = data.get_weight(sample);
+    double sample_weight = Weights::get(data, sample);
     class_counts[sample_class] += sample_weight;
   }
 
@@ -69,14 +97,29 @@ bool ProbabilitySplittingRule::find_best_split(const Data& data,
   double best_decrease = 0.0;
   bool best_send_missing_left = true;
 
-  // For all possible split variables
-  for (size_t var : possible_split_vars) {
-    find_best_split_value(data, node, var, num_classes, class_counts, size_node, min_child_size,
-                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+  switch (num_classes) {
+#define GRF_PROBABILITY_SPLIT_CASE(N) \
+    case N: \
+      find_best_split_values<Weights, N>(data, node, possible_split_vars, size_node, min_child_size, \
+                                         best_value, best_var, best_decrease, best_send_missing_left, \
+                                         responses_by_sample, samples); \
+      break;
+    GRF_PROBABILITY_SPLIT_CASE(2)
+    GRF_PROBABILITY_SPLIT_CASE(3)
+    GRF_PROBABILITY_SPLIT_CASE(4)
+    GRF_PROBABILITY_SPLIT_CASE(5)
+    GRF_PROBABILITY_SPLIT_CASE(6)
+    GRF_PROBABILITY_SPLIT_CASE(7)
+    GRF_PROBABILITY_SPLIT_CASE(8)
+    GRF_PROBABILITY_SPLIT_CASE(9)
+    GRF_PROBABILITY_SPLIT_CASE(10)
+#undef GRF_PROBABILITY_SPLIT_CASE
+    default:
+      find_best_split_values<Weights, 0>(data, node, possible_split_vars, size_node, min_child_size,
+                                         best_value, best_var, best_decrease, best_send_missing_left,
+                                         responses_by_sample, samples);
   }
 
-  delete[] class_counts;
-
   // Stop if no good split found
   if (best_decrease <= 0.0) {
     return true;
@@ -90,10 +133,29 @@ bool ProbabilitySplittingRule::find_best_split(const Data& data,
   return false;
 }
 
+template <class Weights, size_t NUM_CLASSES>
+void ProbabilitySplittingRule::find_best_split_values(const Data& data,
+                                                      size_t node,
+                                                      const std::vector<size_t>& possible_split_vars,
+                                                      size_t size_node,
+                                                      size_t min_child_size,
+                                                      double& best_value,
+                                                      size_t& best_var,
+                                                      double& best_decrease,
+                                                      bool& best_send_missing_left,
+                                                      const Eigen::ArrayXXd& responses_by_sample,
+                                                      const std::vector<std::vector<size_t>>& samples) {
+  // For all possible split variables
+  for (size_t var : possible_split_vars) {
+    find_best_split_value<Weights, NUM_CLASSES>(data, node, var, size_node, min_child_size,
+                                                best_value, best_var, best_decrease, best_send_missing_left,
+                                                responses_by_sample, samples);
+  }
+}
+
+template <class Weights, size_t NUM_CLASSES>
 void ProbabilitySplittingRule::find_best_split_value(const Data& data,
                                                      size_t node, size_t var,
-                                                     size_t num_classes,
-                                                     double* class_counts,
                                                      size_t size_node,
                                                      size_t min_child_size,
                                                      double& best_value,
@@ -104,7 +166,9 @@ void ProbabilitySplittingRule::find_best_split_value(const Data& data,
                                                      const std::vector<std::vector<size_t>>& samples) {
   std::vector<double> possible_split_values;
   std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  std::vector<size_t> buckets;
+  bool bucketed = get_split_values(data, samples[node], var, split_value_options, sampler, sorted_samples_cache,
+                                   possible_split_values, sorted_samples, buckets);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -112,38 +176,68 @@ void ProbabilitySplittingRule::find_best_split_value(const Data& data,
   }
 
   size_t num_splits = possible_split_values.size() - 1;
+  const size_t num_classes = NUM_CLASSES > 0 ? NUM_CLASSES : this->num_classes;
+
+  // The parent and left class counts, on the stack if the number of classes is fixed.
+  double stack_class_counts[NUM_CLASSES > 0 ? NUM_CLASSES : 1];
+  double stack_class_counts_left[NUM_CLASSES > 0 ? NUM_CLASSES : 1];
+  const double* class_counts = this->class_counts.data();
+  double* class_counts_left = this->class_counts_left.data();
+  if (NUM_CLASSES > 0) {
+    std::copy(class_counts, class_counts + num_classes, stack_class_counts);
+    class_counts = stack_class_counts;
+    class_counts_left = stack_class_counts_left;
+  }
 
   std::fill(counter_per_class, counter_per_class + num_splits * num_classes, 0);
   std::fill(counter, counter + num_splits, 0);
+  std::fill(class_counts_left, class_counts_left + num_classes, 0);
   size_t n_missing = 0;
-  double* class_counts_missing = new double[num_classes]();
-
-  size_t split_index = 0;
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
-    uint sample_class = static_cast<uint>(responses_by_sample(sample, 0));
-    double sample_weight = data.get_weight(sample);
-
-    if (std::isnan(sample_value)) {
-      class_counts_missing[sample_class] += sample_weight;
-      ++n_missing;
-    } else {
-      ++counter[split_index];
-      counter_per_class[split_index * num_classes + sample_class] += sample_weight;
+
+  if (bucketed) {
+    for (size_t i = 0; i < size_node; i++) {
+      size_t sample = samples[node][i];
+      size_t bucket = buckets[i];
+      uint sample_class = static_cast<uint>(responses_by_sample(sample, 0));
+      double sample_weight = Weights::get(data, sample);
+
+      if (bucket == MISSING_BUCKET) {
+        class_counts_left[sample_class] += sample_weight;
+        ++n_missing;
+      } else if (bucket < num_splits) {
+        ++counter[bucket];
+        counter_per_class[bucket * num_classes + sample_class] += sample_weight;
+      }
     }
+  } else {
+    // Columns without NaN skip the missing value checks.
+    bool has_nan = data.has_nan(var);
+    size_t split_index = 0;
+    for (size_t i = 0; i < size_node - 1; i++) {
+      size_t sample = sorted_samples[i];
+      size_t next_sample = sorted_samples[i + 1];
+      double sample_value = data.get(sample, var);
+      uint sample_class = static_cast<uint>(responses_by_sample(sample, 0));
+      double sample_weight = Weights::get(data, sample);
+
+      if (has_nan && std::isnan(sample_value)) {
+        class_counts_left[sample_class] += sample_weight;
+        ++n_missing;
+      } else {
+        ++counter[split_index];
+        counter_per_class[split_index * num_classes + sample_class] += sample_weight;
+      }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
+      double next_sample_value = data.get(next_sample, var);
+      // if the next sample value is different, including the transition (..., NaN, Xij, ...)
+      // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
+      if (sample_value != next_sample_value && (!has_nan || !std::isnan(next_sample_value))) {
+        ++split_index;
+      }
     }
   }
 
   size_t n_left = n_missing;
-  double* class_counts_left = class_counts_missing;
 
   // Compute decrease of impurity for each possible split
   for (bool send_left : {true, false}) {
@@ -206,7 +300,6 @@ void ProbabilitySplittingRule::find_best_split_value(const Data& data,
       }
     }
   }
-  delete[] class_counts_missing;
 }
 
 } // namespace grf
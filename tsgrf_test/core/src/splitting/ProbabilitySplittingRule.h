@@ -21,17 +21,23 @@
 #include <vector>
 
 #include "commons/Data.h"
+#include "commons/SampleWeights.h"
 #include "commons/globals.h"
+#include "sampling/RandomSampler.h"
+#include "splitting/SplitValueOptions.h"
 #include "splitting/SplittingRule.h"
 
 namespace grf {
 
 class ProbabilitySplittingRule final: public SplittingRule {
 public:
+  // `sampler` draws the random split values, and is required if `split_value_options` asks for them.
   ProbabilitySplittingRule(size_t max_num_unique_values,
                            size_t num_classes,
                            double alpha,
-                           double imbalance_penalty);
+                           double imbalance_penalty,
+                           const SplitValueOptions& split_value_options = SplitValueOptions(),
+                           RandomSampler* sampler = nullptr);
   ~ProbabilitySplittingRule();
 
   bool find_best_split(const Data& data,
@@ -44,8 +50,27 @@ public:
                        std::vector<bool>& send_missing_left);
 
 private:
+  /**
+   * Instantiated for weighted (SampleWeights) and unweighted (UnitWeights) data.
+   */
+  template <class Weights>
+  bool find_best_split_internal(const Data& data,
+                                size_t node,
+                                const std::vector<size_t>& possible_split_vars,
+                                const Eigen::ArrayXXd& responses_by_sample,
+                                const std::vector<std::vector<size_t>>& samples,
+                                std::vector<size_t>& split_vars,
+                                std::vector<double>& split_values,
+                                std::vector<bool>& send_missing_left);
+
+  /**
+   * Kernels are instantiated for small numbers of classes, so that the per-class counts
+   * live in stack arrays and the loops over classes are unrolled. NUM_CLASSES = 0 is the
+   * fallback for any other number of classes.
+   */
+  template <class Weights, size_t NUM_CLASSES>
   void find_best_split_value(const Data& data,
-                             size_t node, size_t var, size_t num_classes, double* class_counts,
+                             size_t node, size_t var,
                              size_t size_node,
                              size_t min_child_size,
                              double& best_value,
@@ -55,13 +80,30 @@ private:
                              const Eigen::ArrayXXd& responses_by_sample,
                              const std::vector<std::vector<size_t>>& samples);
 
+  template <class Weights, size_t NUM_CLASSES>
+  void find_best_split_values(const Data& data,
+                              size_t node,
+                              const std::vector<size_t>& possible_split_vars,
+                              size_t size_node,
+                              size_t min_child_size,
+                              double& best_value,
+                              size_t& best_var,
+                              double& best_decrease,
+                              bool& best_send_missing_left,
+                              const Eigen::ArrayXXd& responses_by_sample,
+                              const std::vector<std::vector<size_t>>& samples);
+
   size_t num_classes;
 
   double alpha;
   double imbalance_penalty;
+  SplitValueOptions split_value_options;
+  RandomSampler* sampler;
 
   size_t* counter;
   double* counter_per_class;
+  std::vector<double> class_counts;
+  std::vector<double> class_counts_left;
 
   DISALLOW_COPY_AND_ASSIGN(ProbabilitySplittingRule);
 };
@@ -16,16 +16,34 @@
  #-------------------------------------------------------------------------------*/
 
 #include <algorithm>
+#include <stdexcept>
 
 #include "RegressionSplittingRule.h"
+#include "splitting/SplitValues.h"
+#include "commons/ThreadPool.h"
+#include "commons/utility.h"
 
 namespace grf {
 
+// Nodes with fewer samples are split on the thread growing the tree, since
+// sorting a handful of columns is cheaper than handing them to other threads.
+static const size_t PARALLEL_SPLIT_MIN_NODE_SIZE = 10000;
+
 RegressionSplittingRule::RegressionSplittingRule(size_t max_num_unique_values,
                                                  double alpha,
-                                                 double imbalance_penalty):
+                                                 double imbalance_penalty,
+                                                 uint num_threads,
+                                                 const SplitValueOptions& split_value_options,
+                                                 RandomSampler* sampler):
     alpha(alpha),
-    imbalance_penalty(imbalance_penalty) {
+    imbalance_penalty(imbalance_penalty),
+    num_threads(num_threads),
+    split_value_options(split_value_options),
+    sampler(sampler),
+    scan(max_num_unique_values) {
+  if (split_value_options.get_num_random_thresholds() > 0 && sampler == nullptr) {
+    throw std::runtime_error("Random split values need the tree's sampler.");
+  }
   this->counter = new size_t[max_num_unique_values];
   this->sums = new double[max_num_unique_values];
   this->weight_sums = new double[max_num_unique_values];
@@ -51,7 +69,23 @@ bool RegressionSplittingRule::find_best_split(const Data& data,
                                               std::vector<size_t>& split_vars,
                                               std::vector<double>& split_values,
                                               std::vector<bool>& send_missing_left) {
+  if (data.has_weights()) {
+    return find_best_split_internal<SampleWeights>(data, node, possible_split_vars, responses_by_sample, samples,
+                                                   split_vars, split_values, send_missing_left);
+  }
+  return find_best_split_internal<UnitWeights>(data, node, possible_split_vars, responses_by_sample, samples,
+                                               split_vars, split_values, send_missing_left);
+}
 
+template <class Weights>
+bool RegressionSplittingRule::find_best_split_internal(const Data& data,
+                                                       size_t node,
+                                                       const std::vector<size_t>& possible_split_vars,
+                                                       const Eigen::ArrayXXd& responses_by_sample,
+                                                       const std::vector<std::vector<size_t>>& samples,
+                                                       std::vector<size_t>& split_vars,
+                                                       std::vector<double>& split_values,
+                                                       std::vector<bool>& send_missing_left) {
   size_t size_node = samples[node].size();
   size_t min_child_size = std::max<size_t>(static_cast<size_t>(std::ceil(size_node * alpha)), 1uL);
 
@@ -59,7 +93,7 @@ bool RegressionSplittingRule::find_best_split(const Data& data,
   double sum_node = 0.0;
   double weight_sum_node = 0.0;
   for (auto& sample : samples[node]) {
-    double sample_weight = data.get_weight(sample);
+    double sample_weight = Weights::get(data, sample);
     weight_sum_node += sample_weight;
     sum_node += sample_weight * responses_by_sample(sample, 0);
   }
@@ -70,10 +104,19 @@ bool RegressionSplittingRule::find_best_split(const Data& data,
   double best_decrease = 0.0;
   bool best_send_missing_left = true;
 
-  // For all possible split variables
-  for (auto& var : possible_split_vars) {
-    find_best_split_value(data, node, var, weight_sum_node, sum_node, size_node, min_child_size,
-                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+  // For all possible split variables. Random split values are drawn from the tree's
+  // sampler, so extremely randomized trees always evaluate the variables in order.
+  if (num_threads > 1 && split_value_options.get_num_random_thresholds() == 0 && possible_split_vars.size() > 1 &&
+      size_node >= PARALLEL_SPLIT_MIN_NODE_SIZE) {
+    find_best_split_parallel<Weights>(data, node, possible_split_vars, weight_sum_node, sum_node, size_node,
+                                      min_child_size, best_value, best_var, best_decrease, best_send_missing_left,
+                                      responses_by_sample, samples);
+  } else {
+    for (auto& var : possible_split_vars) {
+      find_best_split_value<Weights>(data, node, var, weight_sum_node, sum_node, size_node, min_child_size,
+                                     best_value, best_var, best_decrease, best_send_missing_left,
+                                     responses_by_sample, samples, counter, sums, weight_sums, scan);
+    }
   }
 
   // Stop if no good split found
@@ -88,6 +131,7 @@ bool RegressionSplittingRule::find_best_split(const Data& data,
   return false;
 }
 
+template <class Weights>
 void RegressionSplittingRule::find_best_split_value(const Data& data,
                                                     size_t node, size_t var,
                                                     double weight_sum_node,
@@ -97,11 +141,20 @@ void RegressionSplittingRule::find_best_split_value(const Data& data,
                                                     double& best_value, size_t& best_var,
                                                     double& best_decrease, bool& best_send_missing_left,
                                                     const Eigen::ArrayXXd& responses_by_sample,
-                                                    const std::vector<std::vector<size_t>>& samples) {
+                                                    const std::vector<std::vector<size_t>>& samples,
+                                                    size_t* counter,
+                                                    double* sums,
+                                                    double* weight_sums,
+                                                    SplitScan& scan) {
   // sorted_samples: the node samples in increasing order (may contain duplicated Xij). Length: size_node
   std::vector<double> possible_split_values;
   std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  std::vector<size_t> buckets;
+  size_t zero_bucket;
+  bool sparse = get_sparse_split_values(data, samples[node], var, split_value_options, sorted_samples_cache,
+                                        possible_split_values, sorted_samples, buckets, zero_bucket);
+  bool bucketed = !sparse && get_split_values(data, samples[node], var, split_value_options, sampler,
+                                              sorted_samples_cache, possible_split_values, sorted_samples, buckets);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -117,29 +170,77 @@ void RegressionSplittingRule::find_best_split_value(const Data& data,
   double sum_missing = 0;
 
   // Fill counter and sums buckets
-  size_t split_index = 0;
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
-    double response = responses_by_sample(sample, 0);
-    double sample_weight = data.get_weight(sample);
-
-    if (std::isnan(sample_value)) {
-      weight_sum_missing += sample_weight;
-      sum_missing += sample_weight * response;
-      ++n_missing;
-    } else {
-      weight_sums[split_index] += sample_weight;
-      sums[split_index] += sample_weight * response;
-      ++counter[split_index];
+  if (sparse) {
+    // Only the nonzeros are read: the zeros' bucket is what the nonzeros leave of the node.
+    double weight_sum_nonzero = 0;
+    double sum_nonzero = 0;
+    for (size_t i = 0; i < sorted_samples.size(); i++) {
+      size_t sample = sorted_samples[i];
+      size_t bucket = buckets[i];
+      double response = responses_by_sample(sample, 0);
+      double sample_weight = Weights::get(data, sample);
+      weight_sum_nonzero += sample_weight;
+      sum_nonzero += sample_weight * response;
+
+      if (bucket == MISSING_BUCKET) {
+        weight_sum_missing += sample_weight;
+        sum_missing += sample_weight * response;
+        ++n_missing;
+      } else if (bucket < num_splits) {
+        weight_sums[bucket] += sample_weight;
+        sums[bucket] += sample_weight * response;
+        ++counter[bucket];
+      }
+    }
+    if (zero_bucket < num_splits) {
+      weight_sums[zero_bucket] = weight_sum_node - weight_sum_nonzero;
+      sums[zero_bucket] = sum_node - sum_nonzero;
+      counter[zero_bucket] = size_node - sorted_samples.size();
+    }
+  } else if (bucketed) {
+    for (size_t i = 0; i < size_node; i++) {
+      size_t sample = samples[node][i];
+      size_t bucket = buckets[i];
+      double response = responses_by_sample(sample, 0);
+      double sample_weight = Weights::get(data, sample);
+
+      if (bucket == MISSING_BUCKET) {
+        weight_sum_missing += sample_weight;
+        sum_missing += sample_weight * response;
+        ++n_missing;
+      } else if (bucket < num_splits) {
+        weight_sums[bucket] += sample_weight;
+        sums[bucket] += sample_weight * response;
+        ++counter[bucket];
+      }
     }
+  } else {
+    // Columns without NaN skip the missing value checks.
+    bool has_nan = data.has_nan(var);
+    size_t split_index = 0;
+    for (size_t i = 0; i < size_node - 1; i++) {
+      size_t sample = sorted_samples[i];
+      size_t next_sample = sorted_samples[i + 1];
+      double sample_value = data.get(sample, var);
+      double response = responses_by_sample(sample, 0);
+      double sample_weight = Weights::get(data, sample);
+
+      if (has_nan && std::isnan(sample_value)) {
+        weight_sum_missing += sample_weight;
+        sum_missing += sample_weight * response;
+        ++n_missing;
+      } else {
+        weight_sums[split_index] += sample_weight;
+        sums[split_index] += sample_weight * response;
+        ++counter[split_index];
+      }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
+      double next_sample_value = data.get(next_sample, var);
+      // if the next sample value is different, including the transition (..., NaN, Xij, ...)
+      // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
+      if (sample_value != next_sample_value && (!has_nan || !std::isnan(next_sample_value))) {
+        ++split_index;
+      }
     }
   }
 
@@ -161,6 +262,7 @@ void RegressionSplittingRule::find_best_split_value(const Data& data,
       sum_left = 0;
     }
 
+    scan.clear();
     for (size_t i = 0; i < num_splits; ++i) {
       // not necessary to evaluate sending right when splitting on NaN.
       if (i == 0 && !send_left) {
@@ -182,22 +284,64 @@ void RegressionSplittingRule::find_best_split_value(const Data& data,
         break;
       }
 
-      double weight_sum_right = weight_sum_node - weight_sum_left;
-      double sum_right = sum_node - sum_left;
-      double decrease = sum_left * sum_left / weight_sum_left + sum_right * sum_right / weight_sum_right;
-
-      // Penalize splits that are too close to the edges of the data.
-      double penalty = imbalance_penalty * (1.0 / n_left + 1.0 / n_right);
-      decrease -= penalty;
+      scan.add(i, sum_left, weight_sum_left, n_left, n_right);
+    }
 
+    // If better than before, use this
+    size_t best_split;
+    if (scan.find_best(sum_node, weight_sum_node, imbalance_penalty, best_decrease, best_split)) {
+      best_value = possible_split_values[best_split];
+      best_var = var;
+      best_send_missing_left = send_left;
+    }
+  }
+}
 
-      // If better than before, use this
-      if (decrease > best_decrease) {
-        best_value = possible_split_values[i];
-        best_var = var;
-        best_decrease = decrease;
-        best_send_missing_left = send_left;
-      }
+template <class Weights>
+void RegressionSplittingRule::find_best_split_parallel(const Data& data,
+                                                       size_t node,
+                                                       const std::vector<size_t>& possible_split_vars,
+                                                       double weight_sum_node,
+                                                       double sum_node,
+                                                       size_t size_node,
+                                                       size_t min_child_size,
+                                                       double& best_value,
+                                                       size_t& best_var,
+                                                       double& best_decrease,
+                                                       bool& best_send_missing_left,
+                                                       const Eigen::ArrayXXd& responses_by_sample,
+                                                       const std::vector<std::vector<size_t>>& samples) {
+  size_t num_vars = possible_split_vars.size();
+  std::vector<double> var_best_values(num_vars, 0);
+  std::vector<size_t> var_best_vars(num_vars, 0);
+  std::vector<double> var_best_decreases(num_vars, 0.0);
+  std::vector<char> var_best_send_missing_left(num_vars, true);
+
+  std::vector<uint> var_ranges;
+  split_sequence(var_ranges, 0, static_cast<uint>(num_vars - 1), num_threads);
+
+  // Each chunk of variables gets its own buckets, which never need more than one slot per sample.
+  ThreadPool::get_instance().parallel_for(var_ranges.size() - 1, num_threads, [&](size_t chunk) {
+    std::vector<size_t> chunk_counter(size_node);
+    std::vector<double> chunk_sums(size_node);
+    std::vector<double> chunk_weight_sums(size_node);
+    SplitScan chunk_scan(size_node);
+    for (size_t i = var_ranges[chunk]; i < var_ranges[chunk + 1]; ++i) {
+      bool send_missing_left = true;
+      find_best_split_value<Weights>(data, node, possible_split_vars[i], weight_sum_node, sum_node, size_node,
+                                     min_child_size, var_best_values[i], var_best_vars[i], var_best_decreases[i],
+                                     send_missing_left, responses_by_sample, samples,
+                                     chunk_counter.data(), chunk_sums.data(), chunk_weight_sums.data(), chunk_scan);
+      var_best_send_missing_left[i] = send_missing_left;
+    }
+  });
+
+  for (size_t i = 0; i < num_vars; ++i) {
+    if (var_best_decreases[i] > best_decrease) {
+      best_value = var_best_values[i];
+      best_var = var_best_vars[i];
+      best_decrease = var_best_decreases[i];
+      best_send_missing_left = var_best_send_missing_left[i];
     }
   }
 }
@@ -0,0 +1,206 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "splitting/SortedSamplesCache.h"
+
+namespace grf {
+
+const size_t SortedSamplesCache::NO_NODE;
+const size_t SortedSamplesCache::DEFAULT_MAX_CACHED_SAMPLES;
+
+SortedSamplesCache::SortedSamplesCache(size_t num_rows, size_t max_cached_samples) :
+    sample_nodes(num_rows, NO_NODE),
+    sample_positions(num_rows),
+    sample_counts(num_rows),
+    node(0),
+    node_samples(nullptr),
+    parent_orders(nullptr),
+    max_cached_samples(max_cached_samples),
+    num_pending_samples(0),
+    num_node_samples(0) {}
+
+void SortedSamplesCache::begin_node(size_t node,
+                                    const std::vector<size_t>& samples,
+                                    const std::vector<size_t>& possible_split_vars) {
+  // Nodes are searched in increasing order, and so are the children of the pending
+  // orders, so the parent of `node`, if it has one, is the first one still needed.
+  while (!pending_orders.empty() && pending_orders.front().right_child < node) {
+    num_pending_samples -= pending_orders.front().num_samples;
+    pending_orders.pop_front();
+  }
+  parent_orders = nullptr;
+  if (!pending_orders.empty() &&
+      (pending_orders.front().left_child == node || pending_orders.front().right_child == node)) {
+    parent_orders = &pending_orders.front();
+  }
+
+  this->node = node;
+  node_samples = &samples;
+  // Overlapping blocks can draw a sample more than once.
+  for (size_t i = 0; i < samples.size(); i++) {
+    size_t sample = samples[i];
+    if (sample_nodes[sample] == node) {
+      sample_counts[sample]++;
+    } else {
+      sample_nodes[sample] = node;
+      sample_positions[sample] = i;
+      sample_counts[sample] = 1;
+    }
+  }
+
+  orders.vars = possible_split_vars;
+  orders.sorted_samples.clear();
+  orders.sorted_samples.resize(possible_split_vars.size());
+  num_node_samples = 0;
+}
+
+void SortedSamplesCache::end_node() {
+  node_samples = nullptr;
+}
+
+void SortedSamplesCache::keep_for_children(size_t left_child, size_t right_child) {
+  orders.left_child = left_child;
+  orders.right_child = right_child;
+  orders.num_samples = num_node_samples;
+  num_pending_samples += orders.num_samples;
+  num_node_samples = 0;
+  pending_orders.push_back(std::move(orders));
+  orders = NodeOrders();
+}
+
+std::vector<size_t> SortedSamplesCache::get_all_values(const Data& data,
+                                                       std::vector<double>& all_values,
+                                                       std::vector<size_t>& sorted_samples,
+                                                       const std::vector<size_t>& samples,
+                                                       size_t var) {
+  if (&samples != node_samples) {
+    return data.get_all_values(all_values, sorted_samples, samples, var);
+  }
+  std::vector<double> node_values;
+  bool sparse = read_sparse_values(data, var, node_values);
+  size_t slot = std::find(orders.vars.begin(), orders.vars.end(), var) - orders.vars.begin();
+  if (slot == orders.vars.size()) {
+    if (sparse) {
+      all_values.swap(node_values);
+      return data.sort_all_values(all_values, sorted_samples, samples, var);
+    }
+    return data.get_all_values(all_values, sorted_samples, samples, var);
+  }
+
+  const std::vector<size_t>* parent_order = nullptr;
+  if (parent_orders != nullptr) {
+    const std::vector<size_t>& parent_vars = parent_orders->vars;
+    size_t parent_slot = std::find(parent_vars.begin(), parent_vars.end(), var) - parent_vars.begin();
+    if (parent_slot < parent_vars.size() && !parent_orders->sorted_samples[parent_slot].empty()) {
+      parent_order = &parent_orders->sorted_samples[parent_slot];
+    }
+  }
+
+  // Filtering reads all of the parent's samples, so a small child of a large parent is cheaper to sort.
+  std::vector<size_t> index;
+  double sort_cost = samples.size() * std::log2(static_cast<double>(samples.size()));
+  if (parent_order != nullptr && parent_order->size() < sort_cost) {
+    filter_parent_order(data, *parent_order, var, node_values, all_values, sorted_samples, index);
+  } else if (sparse) {
+    all_values.swap(node_values);
+    index = data.sort_all_values(all_values, sorted_samples, samples, var);
+  } else {
+    index = data.get_all_values(all_values, sorted_samples, samples, var);
+  }
+
+  size_t num_cached = num_pending_samples + (num_node_samples += sorted_samples.size());
+  if (num_cached <= max_cached_samples) {
+    orders.sorted_samples[slot] = sorted_samples;
+  } else {
+    num_node_samples -= sorted_samples.size();
+  }
+  return index;
+}
+
+void SortedSamplesCache::filter_parent_order(const Data& data,
+                                             const std::vector<size_t>& parent_order,
+                                             size_t var,
+                                             const std::vector<double>& node_values,
+                                             std::vector<double>& all_values,
+                                             std::vector<size_t>& sorted_samples,
+                                             std::vector<size_t>& index) const {
+  sorted_samples.resize(node_samples->size());
+  index.resize(node_samples->size());
+  size_t num_sorted = 0;
+  for (size_t sample : parent_order) {
+    if (sample_nodes[sample] == node) {
+      sorted_samples[num_sorted] = sample;
+      index[num_sorted] = sample_positions[sample];
+      num_sorted++;
+    }
+  }
+
+  // The unique values, with the same comparison as Data#get_all_values.
+  bool may_have_nan = data.has_nan(var);
+  all_values.clear();
+  for (size_t i = 0; i < sorted_samples.size(); i++) {
+    double value = node_values.empty() ? data.get(sorted_samples[i], var) : node_values[index[i]];
+    if (all_values.empty() ||
+        !(value == all_values.back() || (may_have_nan && std::isnan(value) && std::isnan(all_values.back())))) {
+      all_values.push_back(value);
+    }
+  }
+}
+
+bool SortedSamplesCache::read_sparse_values(const Data& data,
+                                            size_t var,
+                                            std::vector<double>& node_values) const {
+  if (!data.is_sparse(var)) {
+    return false;
+  }
+  // Walking the nonzeros reads all of them, and a binary search per sample reads log2 of them per sample.
+  const std::vector<size_t>& samples = *node_samples;
+  double num_nonzero = static_cast<double>(data.get_num_nonzero(var));
+  if (num_nonzero > samples.size() * std::log2(num_nonzero + 2)) {
+    return false;
+  }
+
+  // The nonzeros are written at the first position of their sample, and copied to the
+  // later positions of samples drawn more than once.
+  node_values.assign(samples.size(), 0.0);
+  data.for_each_nonzero(var, [&](size_t sample, double value) {
+    if (sample_nodes[sample] == node) {
+      node_values[sample_positions[sample]] = value;
+    }
+  });
+  for (size_t i = 0; i < samples.size(); i++) {
+    node_values[i] = node_values[sample_positions[samples[i]]];
+  }
+  return true;
+}
+
+std::vector<size_t> get_all_values(const Data& data,
+                                   SortedSamplesCache* cache,
+                                   std::vector<double>& all_values,
+                                   std::vector<size_t>& sorted_samples,
+                                   const std::vector<size_t>& samples,
+                                   size_t var) {
+  if (cache == nullptr) {
+    return data.get_all_values(all_values, sorted_samples, samples, var);
+  }
+  return cache->get_all_values(data, all_values, sorted_samples, samples, var);
+}
+
+} // namespace grf
@@ -0,0 +1,178 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SORTEDSAMPLESCACHE_H
+#define GRF_SORTEDSAMPLESCACHE_H
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#include "commons/Data.h"
+#include "commons/globals.h"
+
+namespace grf {
+
+/**
+ * The sorted orders a tree computes while searching its nodes for splits.
+ *
+ * The samples of a child are a subsequence of the samples of its parent, so the
+ * child's order on a variable the parent has already sorted is the parent's order
+ * restricted to the child. Data#get_all_values breaks ties by sample order, so this
+ * stable filter gives exactly the same order as sorting the child again.
+ *
+ * The trainer grows the tree breadth-first, and calls begin_node and end_node
+ * around the split search of every node, and keep_for_children once the node has
+ * been split. The orders of a node are kept until both its children are searched.
+ *
+ * While a node is searched, the cache also tells which samples are in the node, so
+ * that sparse columns can be split by walking their nonzeros. get_all_values reads the
+ * values of the node on a sparse column the same way, rather than by a binary search
+ * over the nonzeros per sample.
+ *
+ * A node keeps one order of its samples per variable it sorts, so the orders of a
+ * level of the tree take up to mtry * n sample indices, for n samples in the tree,
+ * and those of two levels are held at once. Orders that would take the cache beyond
+ * `max_cached_samples` indices are not kept, and the children sort these variables
+ * again. The default caps each tree at 32 MB (on 64-bit platforms).
+ */
+class SortedSamplesCache {
+public:
+  static const size_t DEFAULT_MAX_CACHED_SAMPLES = 4 * 1024 * 1024;
+
+  explicit SortedSamplesCache(size_t num_rows, size_t max_cached_samples = DEFAULT_MAX_CACHED_SAMPLES);
+
+  /**
+   * Prepares the split search of `node`, whose samples are `samples`. Only the
+   * orders of `possible_split_vars` are kept.
+   */
+  void begin_node(size_t node,
+                  const std::vector<size_t>& samples,
+                  const std::vector<size_t>& possible_split_vars);
+
+  void end_node();
+
+  /**
+   * Keeps the orders of the last node searched, which was split into the given children.
+   */
+  void keep_for_children(size_t left_child, size_t right_child);
+
+  /**
+   * Same as Data#get_all_values. When `samples` are the samples of the node being
+   * searched, the order is derived from the parent's if the parent sorted `var`.
+   * Different variables can be sorted concurrently.
+   */
+  std::vector<size_t> get_all_values(const Data& data,
+                                     std::vector<double>& all_values,
+                                     std::vector<size_t>& sorted_samples,
+                                     const std::vector<size_t>& samples,
+                                     size_t var);
+
+  /**
+   * The number of sample indices in the orders kept.
+   */
+  size_t get_num_cached_samples() const {
+    return num_pending_samples + num_node_samples;
+  }
+
+  /**
+   * Whether `samples` are the samples of the node being searched.
+   */
+  bool is_searching(const std::vector<size_t>& samples) const {
+    return &samples == node_samples;
+  }
+
+  /**
+   * Whether `sample` is in the node being searched.
+   */
+  bool contains(size_t sample) const {
+    return sample_nodes[sample] == node;
+  }
+
+  /**
+   * The first position of `sample` in the samples of the node being searched, which must contain it.
+   */
+  size_t get_position(size_t sample) const {
+    return sample_positions[sample];
+  }
+
+  /**
+   * The number of times `sample` is drawn in the node being searched, which must contain it.
+   */
+  size_t get_count(size_t sample) const {
+    return sample_counts[sample];
+  }
+
+private:
+  struct NodeOrders {
+    size_t left_child;
+    size_t right_child;
+    std::vector<size_t> vars;
+    // The samples in increasing order of each variable in `vars`, empty if it was not kept.
+    std::vector<std::vector<size_t>> sorted_samples;
+    size_t num_samples;
+  };
+
+  void filter_parent_order(const Data& data,
+                           const std::vector<size_t>& parent_order,
+                           size_t var,
+                           const std::vector<double>& node_values,
+                           std::vector<double>& all_values,
+                           std::vector<size_t>& sorted_samples,
+                           std::vector<size_t>& index) const;
+
+  // Reads the value of each sample of the node being searched on a sparse variable from
+  // its nonzeros, if that is cheaper than a binary search per sample.
+  bool read_sparse_values(const Data& data, size_t var, std::vector<double>& node_values) const;
+
+  // For each sample, the last node searched that contains it (NO_NODE if none), its first
+  // position in that node and the number of times it is drawn there.
+  std::vector<size_t> sample_nodes;
+  std::vector<size_t> sample_positions;
+  std::vector<size_t> sample_counts;
+
+  static const size_t NO_NODE = static_cast<size_t>(-1);
+
+  size_t node;
+  const std::vector<size_t>* node_samples;
+  NodeOrders orders;
+  const NodeOrders* parent_orders;
+
+  // The orders of the split nodes whose children have not all been searched, in node order.
+  std::deque<NodeOrders> pending_orders;
+
+  size_t max_cached_samples;
+  // The number of sample indices in `pending_orders`, and in `orders` (which are kept concurrently).
+  size_t num_pending_samples;
+  std::atomic<size_t> num_node_samples;
+
+  DISALLOW_COPY_AND_ASSIGN(SortedSamplesCache);
+};
+
+/**
+ * Data#get_all_values, through `cache` if it is not null.
+ */
+std::vector<size_t> get_all_values(const Data& data,
+                                   SortedSamplesCache* cache,
+                                   std::vector<double>& all_values,
+                                   std::vector<size_t>& sorted_samples,
+                                   const std::vector<size_t>& samples,
+                                   size_t var);
+
+} // namespace grf
+
+#endif //GRF_SORTEDSAMPLESCACHE_H
@@ -0,0 +1,274 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "splitting/SplitScan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GRF_SPLIT_SCAN_X86
+#include <immintrin.h>
+
+// GCC enables FMA along with AVX-512 and would contract the penalty into a fused
+// multiply-add, which rounds differently from the scalar loop.
+#if defined(__clang__)
+#define GRF_AVX2_KERNEL __attribute__((target("avx2")))
+#define GRF_AVX512_KERNEL __attribute__((target("avx512f")))
+#else
+#define GRF_AVX2_KERNEL __attribute__((target("avx2"), optimize("fp-contract=off")))
+#define GRF_AVX512_KERNEL __attribute__((target("avx512f"), optimize("fp-contract=off")))
+#endif
+#endif
+
+namespace grf {
+
+namespace {
+
+bool find_best_scalar(const double* sums_left,
+                      const double* weight_sums_left,
+                      const double* sizes_left,
+                      const double* sizes_right,
+                      size_t begin,
+                      size_t end,
+                      double sum_node,
+                      double weight_sum_node,
+                      double imbalance_penalty,
+                      double& best_decrease,
+                      size_t& best_index) {
+  bool found = false;
+  for (size_t i = begin; i < end; ++i) {
+    double sum_left = sums_left[i];
+    double sum_right = sum_node - sum_left;
+    double weight_sum_left = weight_sums_left[i];
+    double weight_sum_right = weight_sum_node - weight_sum_left;
+    double decrease = sum_left * sum_left / weight_sum_left + sum_right * sum_right / weight_sum_right;
+    decrease -= imbalance_penalty * (1.0 / sizes_left[i] + 1.0 / sizes_right[i]);
+    if (decrease > best_decrease) {
+      best_decrease = decrease;
+      best_index = i;
+      found = true;
+    }
+  }
+  return found;
+}
+
+#ifdef GRF_SPLIT_SCAN_X86
+
+// Reduces the per-lane maxima: the largest decrease wins, and ties go to the
+// earliest split, which is the one the scalar loop would have kept.
+bool reduce_lanes(const double* lane_decreases,
+                  const double* lane_indices,
+                  size_t num_lanes,
+                  double& best_decrease,
+                  size_t& best_index) {
+  bool found = false;
+  for (size_t lane = 0; lane < num_lanes; ++lane) {
+    if (lane_indices[lane] < 0) {
+      continue;
+    }
+    size_t index = static_cast<size_t>(lane_indices[lane]);
+    if (lane_decreases[lane] > best_decrease || (found && lane_decreases[lane] == best_decrease && index < best_index)) {
+      best_decrease = lane_decreases[lane];
+      best_index = index;
+      found = true;
+    }
+  }
+  return found;
+}
+
+GRF_AVX2_KERNEL
+bool find_best_avx2(const double* sums_left,
+                    const double* weight_sums_left,
+                    const double* sizes_left,
+                    const double* sizes_right,
+                    size_t num_candidates,
+                    double sum_node,
+                    double weight_sum_node,
+                    double imbalance_penalty,
+                    double& best_decrease,
+                    size_t& best_index) {
+  const __m256d node_sum = _mm256_set1_pd(sum_node);
+  const __m256d node_weight_sum = _mm256_set1_pd(weight_sum_node);
+  const __m256d penalty = _mm256_set1_pd(imbalance_penalty);
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d step = _mm256_set1_pd(4.0);
+  __m256d index = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+  __m256d lane_best = _mm256_set1_pd(best_decrease);
+  __m256d lane_index = _mm256_set1_pd(-1.0);
+
+  size_t i = 0;
+  for (; i + 4 <= num_candidates; i += 4) {
+    __m256d sum_left = _mm256_loadu_pd(sums_left + i);
+    __m256d weight_sum_left = _mm256_loadu_pd(weight_sums_left + i);
+    __m256d sum_right = _mm256_sub_pd(node_sum, sum_left);
+    __m256d weight_sum_right = _mm256_sub_pd(node_weight_sum, weight_sum_left);
+    __m256d decrease = _mm256_add_pd(_mm256_div_pd(_mm256_mul_pd(sum_left, sum_left), weight_sum_left),
+                                     _mm256_div_pd(_mm256_mul_pd(sum_right, sum_right), weight_sum_right));
+    __m256d inverse_sizes = _mm256_add_pd(_mm256_div_pd(one, _mm256_loadu_pd(sizes_left + i)),
+                                          _mm256_div_pd(one, _mm256_loadu_pd(sizes_right + i)));
+    decrease = _mm256_sub_pd(decrease, _mm256_mul_pd(penalty, inverse_sizes));
+
+    __m256d better = _mm256_cmp_pd(decrease, lane_best, _CMP_GT_OQ);
+    lane_best = _mm256_blendv_pd(lane_best, decrease, better);
+    lane_index = _mm256_blendv_pd(lane_index, index, better);
+    index = _mm256_add_pd(index, step);
+  }
+
+  double lane_decreases[4];
+  double lane_indices[4];
+  _mm256_storeu_pd(lane_decreases, lane_best);
+  _mm256_storeu_pd(lane_indices, lane_index);
+  bool found = reduce_lanes(lane_decreases, lane_indices, 4, best_decrease, best_index);
+
+  // The remaining candidates all come after the vectorized ones.
+  found |= find_best_scalar(sums_left, weight_sums_left, sizes_left, sizes_right, i, num_candidates,
+                            sum_node, weight_sum_node, imbalance_penalty, best_decrease, best_index);
+  return found;
+}
+
+GRF_AVX512_KERNEL
+bool find_best_avx512(const double* sums_left,
+                      const double* weight_sums_left,
+                      const double* sizes_left,
+                      const double* sizes_right,
+                      size_t num_candidates,
+                      double sum_node,
+                      double weight_sum_node,
+                      double imbalance_penalty,
+                      double& best_decrease,
+                      size_t& best_index) {
+  const __m512d node_sum = _mm512_set1_pd(sum_node);
+  const __m512d node_weight_sum = _mm512_set1_pd(weight_sum_node);
+  const __m512d penalty = _mm512_set1_pd(imbalance_penalty);
+  const __m512d one = _mm512_set1_pd(1.0);
+  const __m512d step = _mm512_set1_pd(8.0);
+  __m512d index = _mm512_setr_pd(0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0);
+  __m512d lane_best = _mm512_set1_pd(best_decrease);
+  __m512d lane_index = _mm512_set1_pd(-1.0);
+
+  // The last partial block is handled with masked loads; inactive lanes never compare as better.
+  for (size_t i = 0; i < num_candidates; i += 8) {
+    size_t remaining = num_candidates - i;
+    __mmask8 active = remaining >= 8 ? static_cast<__mmask8>(0xFF) : static_cast<__mmask8>((1u << remaining) - 1);
+    __m512d sum_left = _mm512_maskz_loadu_pd(active, sums_left + i);
+    __m512d weight_sum_left = _mm512_mask_loadu_pd(one, active, weight_sums_left + i);
+    __m512d size_left = _mm512_mask_loadu_pd(one, active, sizes_left + i);
+    __m512d size_right = _mm512_mask_loadu_pd(one, active, sizes_right + i);
+    __m512d sum_right = _mm512_sub_pd(node_sum, sum_left);
+    __m512d weight_sum_right = _mm512_sub_pd(node_weight_sum, weight_sum_left);
+    __m512d decrease = _mm512_add_pd(_mm512_div_pd(_mm512_mul_pd(sum_left, sum_left), weight_sum_left),
+                                     _mm512_div_pd(_mm512_mul_pd(sum_right, sum_right), weight_sum_right));
+    __m512d inverse_sizes = _mm512_add_pd(_mm512_div_pd(one, size_left), _mm512_div_pd(one, size_right));
+    decrease = _mm512_sub_pd(decrease, _mm512_mul_pd(penalty, inverse_sizes));
+
+    __mmask8 better = _mm512_mask_cmp_pd_mask(active, decrease, lane_best, _CMP_GT_OQ);
+    lane_best = _mm512_mask_blend_pd(better, lane_best, decrease);
+    lane_index = _mm512_mask_blend_pd(better, lane_index, index);
+    index = _mm512_add_pd(index, step);
+  }
+
+  double lane_decreases[8];
+  double lane_indices[8];
+  _mm512_storeu_pd(lane_decreases, lane_best);
+  _mm512_storeu_pd(lane_indices, lane_index);
+  return reduce_lanes(lane_decreases, lane_indices, 8, best_decrease, best_index);
+}
+
+bool cpu_supports(SplitScanKernel kernel) {
+  __builtin_cpu_init();
+  switch (kernel) {
+    case SCAN_AVX512:
+      return __builtin_cpu_supports("avx512f");
+    case SCAN_AVX2:
+      return __builtin_cpu_supports("avx2");
+    default:
+      return true;
+  }
+}
+
+#else
+
+bool cpu_supports(SplitScanKernel kernel) {
+  return kernel == SCAN_SCALAR;
+}
+
+#endif
+
+SplitScanKernel detect_kernel() {
+  if (cpu_supports(SCAN_AVX512)) {
+    return SCAN_AVX512;
+  }
+  if (cpu_supports(SCAN_AVX2)) {
+    return SCAN_AVX2;
+  }
+  return SCAN_SCALAR;
+}
+
+} // namespace
+
+SplitScan::SplitScan(size_t max_num_splits):
+    sums_left(max_num_splits),
+    weight_sums_left(max_num_splits),
+    sizes_left(max_num_splits),
+    sizes_right(max_num_splits),
+    splits(max_num_splits),
+    num_candidates(0) {}
+
+void SplitScan::clear() {
+  num_candidates = 0;
+}
+
+bool SplitScan::find_best(double sum_node,
+                          double weight_sum_node,
+                          double imbalance_penalty,
+                          double& best_decrease,
+                          size_t& best_split,
+                          SplitScanKernel kernel) const {
+  size_t best_index = 0;
+  bool found;
+#ifdef GRF_SPLIT_SCAN_X86
+  if (kernel == SCAN_AVX512) {
+    found = find_best_avx512(sums_left.data(), weight_sums_left.data(), sizes_left.data(), sizes_right.data(),
+                             num_candidates, sum_node, weight_sum_node, imbalance_penalty, best_decrease, best_index);
+  } else if (kernel == SCAN_AVX2) {
+    found = find_best_avx2(sums_left.data(), weight_sums_left.data(), sizes_left.data(), sizes_right.data(),
+                           num_candidates, sum_node, weight_sum_node, imbalance_penalty, best_decrease, best_index);
+  } else
+#endif
+  {
+    found = find_best_scalar(sums_left.data(), weight_sums_left.data(), sizes_left.data(), sizes_right.data(),
+                             0, num_candidates, sum_node, weight_sum_node, imbalance_penalty, best_decrease, best_index);
+  }
+
+  if (found) {
+    best_split = splits[best_index];
+  }
+  return found;
+}
+
+size_t SplitScan::size() const {
+  return num_candidates;
+}
+
+SplitScanKernel SplitScan::get_kernel() {
+  static const SplitScanKernel kernel = detect_kernel();
+  return kernel;
+}
+
+bool SplitScan::is_supported(SplitScanKernel kernel) {
+  return cpu_supports(kernel);
+}
+
+} // namespace grf
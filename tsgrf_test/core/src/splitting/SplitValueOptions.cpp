@@ -0,0 +1,46 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "splitting/SplitValueOptions.h"
+
+namespace grf {
+
+SplitValueOptions::SplitValueOptions():
+  num_random_thresholds(0),
+  max_num_thresholds(0),
+  min_quantile_node_size(0) {}
+
+SplitValueOptions::SplitValueOptions(uint num_random_thresholds,
+                                     uint max_num_thresholds,
+                                     size_t min_quantile_node_size):
+  num_random_thresholds(num_random_thresholds),
+  max_num_thresholds(max_num_thresholds),
+  min_quantile_node_size(min_quantile_node_size) {}
+
+uint SplitValueOptions::get_num_random_thresholds() const {
+  return num_random_thresholds;
+}
+
+uint SplitValueOptions::get_max_num_thresholds() const {
+  return max_num_thresholds;
+}
+
+size_t SplitValueOptions::get_min_quantile_node_size() const {
+  return min_quantile_node_size;
+}
+
+} // namespace grf
@@ -0,0 +1,64 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SPLITVALUEOPTIONS_H
+#define GRF_SPLITVALUEOPTIONS_H
+
+#include <cstddef>
+
+#include "commons/globals.h"
+
+namespace grf {
+
+/**
+ * How a splitting rule chooses the candidate split values of a variable.
+ *
+ * By default every distinct value in the node is a candidate, which requires
+ * sorting the node. For large nodes the candidates can instead be capped.
+ */
+class SplitValueOptions {
+public:
+  SplitValueOptions();
+
+  SplitValueOptions(uint num_random_thresholds,
+                    uint max_num_thresholds,
+                    size_t min_quantile_node_size);
+
+  /**
+   * If positive, the trees are extremely randomized: each variable is only split
+   * at this many thresholds drawn uniformly between its smallest and largest
+   * value in the node.
+   */
+  uint get_num_random_thresholds() const;
+
+  /**
+   * If positive, nodes with at least `min_quantile_node_size` samples are only
+   * split at this many evenly spaced quantiles of each variable. Smaller nodes
+   * are split at every distinct value.
+   */
+  uint get_max_num_thresholds() const;
+  size_t get_min_quantile_node_size() const;
+
+private:
+  uint num_random_thresholds;
+  uint max_num_thresholds;
+  size_t min_quantile_node_size;
+};
+
+} // namespace grf
+
+#endif //GRF_SPLITVALUEOPTIONS_H
@@ -0,0 +1,130 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SPLITVALUES_H
+#define GRF_SPLITVALUES_H
+
+#include <vector>
+
+#include "commons/Data.h"
+#include "commons/globals.h"
+#include "sampling/RandomSampler.h"
+#include "splitting/SortedSamplesCache.h"
+#include "splitting/SplitValueOptions.h"
+
+namespace grf {
+
+/**
+ * The bucket of a sample whose split variable is missing.
+ */
+static const size_t MISSING_BUCKET = static_cast<size_t>(-1);
+
+/**
+ * The candidate split values of a variable in a node, chosen according to `options`.
+ *
+ * Unless all distinct values are candidates, the split values follow the layout
+ * of Data#get_all_values, so the rules can evaluate them with their usual loop:
+ * a leading NaN if the node has missing values, the thresholds in increasing
+ * order, and then the largest value, which is not a split. Each sample is then
+ * assigned to the bucket of the first threshold at or above its value in a
+ * single pass over the node, without sorting it.
+ *
+ * @param data: the data.
+ * @param samples: the samples in the node.
+ * @param var: the split variable.
+ * @param options: how to choose the candidates.
+ * @param sampler: the tree's sampler, which random thresholds are drawn from. Only
+ * read if `options` asks for them.
+ * @param sorted_samples_cache: the tree's sorted orders, if any, which all distinct
+ * values are sorted through.
+ * @param split_values: the candidate split values.
+ * @param sorted_samples: if every distinct value is a candidate, the samples in
+ * increasing order of their values, as returned by Data#get_all_values.
+ * @param buckets: otherwise, for each sample in `samples`, the index of its
+ * split value, or MISSING_BUCKET if its value is missing. Samples above every
+ * threshold get the index of the largest value.
+ * @return true if the samples were assigned to buckets.
+ */
+bool get_split_values(const Data& data,
+                      const std::vector<size_t>& samples,
+                      size_t var,
+                      const SplitValueOptions& options,
+                      RandomSampler* sampler,
+                      SortedSamplesCache* sorted_samples_cache,
+                      std::vector<double>& split_values,
+                      std::vector<size_t>& sorted_samples,
+                      std::vector<size_t>& buckets);
+
+/**
+ * The candidate split values of a sparse variable, found from the nonzeros of the node
+ * without reading its zeros.
+ *
+ * The stored nonzeros of the column are walked once and matched against the node with
+ * `sorted_samples_cache`, and only the nonzeros in the node are sorted. The split values
+ * are every distinct value, in the layout of Data#get_all_values. The zeros of the node
+ * all fall into one bucket, whose sums the rules derive as the node totals minus the sums
+ * of the nonzeros.
+ *
+ * This is only done if every distinct value is a candidate under `options`, the cache is
+ * searching `samples`, and the column has few enough nonzeros for the walk to be cheaper
+ * than reading every sample of the node.
+ *
+ * @param nonzero_samples: the samples of the node with a nonzero value (possibly NaN), in
+ * increasing order of their values, as many times as they are drawn in the node.
+ * @param nonzero_buckets: for each of them, the index of its split value, or MISSING_BUCKET
+ * if its value is missing.
+ * @param zero_bucket: the index of the split value zero, or MISSING_BUCKET if no sample
+ * in the node is zero.
+ * @return true if the split values were found this way, otherwise nothing is filled.
+ */
+bool get_sparse_split_values(const Data& data,
+                             const std::vector<size_t>& samples,
+                             size_t var,
+                             const SplitValueOptions& options,
+                             const SortedSamplesCache* sorted_samples_cache,
+                             std::vector<double>& split_values,
+                             std::vector<size_t>& nonzero_samples,
+                             std::vector<size_t>& nonzero_buckets,
+                             size_t& zero_bucket);
+
+/**
+ * Candidate split values for extremely randomized trees: `num_thresholds`
+ * thresholds drawn uniformly between the smallest and largest value in the node.
+ */
+void draw_random_split_values(const Data& data,
+                              const std::vector<size_t>& samples,
+                              size_t var,
+                              uint num_thresholds,
+                              RandomSampler& sampler,
+                              std::vector<double>& split_values,
+                              std::vector<size_t>& buckets);
+
+/**
+ * Candidate split values for large nodes: at most `max_num_thresholds` evenly
+ * spaced quantiles of the values in the node, found by selection rather than
+ * sorting in O(n log max_num_thresholds).
+ */
+void get_quantile_split_values(const Data& data,
+                               const std::vector<size_t>& samples,
+                               size_t var,
+                               uint max_num_thresholds,
+                               std::vector<double>& split_values,
+                               std::vector<size_t>& buckets);
+
+} // namespace grf
+
+#endif //GRF_SPLITVALUES_H
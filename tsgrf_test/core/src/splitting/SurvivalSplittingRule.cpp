@@ -100,9 +100,6 @@ void SurvivalSplittingRule::find_best_split_internal(const Data& data,
   // allocating an N-sized (full data set size) array is faster than a hash table
   std::vector<size_t> relabeled_failures(data.get_num_rows());
 
-  std::vector<double> numerator_weights(num_failures + 1);
-  std::vector<double> denominator_weights(num_failures + 1);
-
   // Relabel the failure values to range from 0 to the number of failures in this node
   for (auto& sample : samples) {
     double failure_value = responses_by_sample(sample, 0);
@@ -118,23 +115,13 @@ void SurvivalSplittingRule::find_best_split_internal(const Data& data,
 
   for (size_t time = 1; time < num_failures + 1; time++) {
     at_risk[time] = at_risk[time - 1] - count_failure[time - 1] - count_censor[time - 1];
-
-    /* The logrank statistic is (using the notation in Ishwaran et al. (2008))
-     * sum over all k: dk,l - Yk,l * dk/Yk divided by:
-     *  Yk,l / Yk * (1 - Yk,l / Yk) * (Yk - dk) / (Yk - 1) dk
-     * All terms involving only Yk or dk remain unchanged for each split
-     * and can be precomputed here.
-    */
-    double Yk = at_risk[time];
-    double dk = count_failure[time];
-    numerator_weights[time] = dk / Yk;
-    denominator_weights[time] = (Yk - dk) / (Yk - 1) * dk / (Yk * Yk);
   }
 
+  LogrankStatistic logrank(count_failure, at_risk);
   for (auto& var : possible_split_vars) {
-    find_best_split_value(data, var, size_node, min_child_size, num_failures_node, num_failures,
+    find_best_split_value(data, var, size_node, min_child_size, num_failures_node,
                           best_value, best_var, best_logrank, best_send_missing_left, samples, relabeled_failures,
-                          count_failure, at_risk, numerator_weights, denominator_weights);
+                          logrank);
   }
 }
 
@@ -143,55 +130,48 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
                                                   size_t size_node,
                                                   size_t min_child_size,
                                                   size_t num_failures_node,
-                                                  size_t num_failures,
                                                   double& best_value,
                                                   size_t& best_var,
                                                   double& best_logrank,
                                                   bool& best_send_missing_left,
                                                   const std::vector<size_t>& samples,
                                                   const std::vector<size_t>& relabeled_failures,
-                                                  const std::vector<double>& count_failure,
-                                                  const std::vector<double>& at_risk,
-                                                  const std::vector<double>& numerator_weights,
-                                                  const std::vector<double>& denominator_weights) {
+                                                  LogrankStatistic& logrank) {
   // possible_split_values contains all the unique split values for this variable in increasing order
   // sorted_samples contains the samples in this node in increasing order
   // if there are missing values, these are placed first
   // (if all Xij's are continuous, these two vectors have the same length)
   std::vector<double> possible_split_values;
   std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples, var);
+  get_all_values(data, sorted_samples_cache, possible_split_values, sorted_samples, samples, var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
     return;
   }
 
-  std::vector<double> left_count_failure(num_failures + 1);
-  std::vector<double> left_count_censor(num_failures + 1);
-  std::vector<double> cum_sums(num_failures + 1);
+  logrank.clear();
   size_t n_missing = 0;
   size_t num_failures_missing = 0;
 
-  // Loop through all samples to scan for missing values
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    double sample_value = data.get(sample, var);
-    size_t sample_time = relabeled_failures[sample];
-
-    if (std::isnan(sample_value)) {
-      if (data.is_failure(sample)) {
-        ++left_count_failure[sample_time];
-        ++num_failures_missing;
-      } else {
-        ++left_count_censor[sample_time];
+  // Loop through all samples to scan for missing values (columns without NaN have none)
+  if (data.has_nan(var)) {
+    for (size_t i = 0; i < size_node - 1; i++) {
+      size_t sample = sorted_samples[i];
+      double sample_value = data.get(sample, var);
+
+      if (std::isnan(sample_value)) {
+        bool failure = data.is_failure(sample);
+        logrank.add(relabeled_failures[sample], failure);
+        if (failure) {
+          ++num_failures_missing;
+        }
+        ++n_missing;
       }
-      ++n_missing;
     }
   }
 
   size_t num_splits = possible_split_values.size() - 1;
-  size_t n_left = n_missing;
   size_t num_failures_left = num_failures_missing;
   size_t split_index = 0;
   size_t start_sample = n_missing > 0 ? n_missing - 1 : 0;
@@ -203,9 +183,7 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
        break;
      }
      // Else, send all missing right
-     std::fill(left_count_failure.begin(), left_count_failure.end(), 0.0);
-     std::fill(left_count_censor.begin(), left_count_censor.end(), 0.0);
-     n_left = 0;
+     logrank.clear();
      num_failures_left = 0;
      // Not necessary to evaluate splitting on NaN when sending right.
      split_index = 1;
@@ -217,22 +195,16 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
       size_t next_sample = sorted_samples[i + 1];
       double sample_value = data.get(sample, var);
       double next_sample_value = data.get(next_sample, var);
-      size_t sample_time = relabeled_failures[sample];
 
       // If there are missing values, we evaluate splitting on NaN when send_left is true
       // and i = n_missing - 1, which is why we need to check for missing below.
       bool split_on_missing = std::isnan(sample_value);
 
       if (!split_on_missing) {
-        ++n_left;
-      }
-
-      if (!split_on_missing) {
-        if (data.is_failure(sample)) {
-          ++left_count_failure[sample_time];
+        bool failure = data.is_failure(sample);
+        logrank.add(relabeled_failures[sample], failure);
+        if (failure) {
           ++num_failures_left;
-        } else {
-          ++left_count_censor[sample_time];
         }
       }
 
@@ -252,12 +224,11 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
 
       // If the next sample value is different we can evaluate a split here
       if (sample_value != next_sample_value) {
-        double logrank = compute_logrank(num_failures, n_left, cum_sums, left_count_failure, left_count_censor,
-                                         at_risk, numerator_weights, denominator_weights);
-        if (logrank > best_logrank) {
+        double value = logrank.compute();
+        if (value > best_logrank) {
           best_value = possible_split_values[split_index];
           best_var = var;
-          best_logrank = logrank;
+          best_logrank = value;
           best_send_missing_left = send_left;
         }
         ++split_index;
@@ -270,38 +241,97 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
   }
 }
 
-inline double SurvivalSplittingRule::compute_logrank(size_t num_failures,
-                                                     size_t n_left,
-                                                     std::vector<double>& cum_sums,
-                                                     const std::vector<double>& left_count_failure,
-                                                     const std::vector<double>& left_count_censor,
-                                                     const std::vector<double>& at_risk,
-                                                     const std::vector<double>& numerator_weights,
-                                                     const std::vector<double>& denominator_weights) {
-  double numerator = 0;
-  double denominator = 0;
-  double logrank = 0;
-  for (size_t time = 1; time < num_failures + 1; time++) {
-    cum_sums[time] = cum_sums[time - 1] + left_count_failure[time - 1] + left_count_censor[time - 1];
-    double Yl = n_left - cum_sums[time];
-    if (Yl == 0) {
-      break;
-    }
-    double Y = at_risk[time];
-    // The logrank denominator requires at least two at risk
-    if (Y < 2) {
-      break;
-    }
-    double dl = left_count_failure[time];
-    numerator = numerator + dl - Yl * numerator_weights[time];
-    denominator = denominator + Yl * (Y - Yl) * denominator_weights[time];
+SurvivalSplittingRule::LogrankStatistic::LogrankStatistic(const std::vector<double>& count_failure,
+                                                          const std::vector<double>& at_risk):
+    n_left(0),
+    numerator(0),
+    denominator(0) {
+  size_t num_failures = at_risk.size() - 1;
+
+  // The logrank denominator requires at least two at risk, so the statistic only sums over
+  // times 1, ..., last_time (the at risk counts are decreasing).
+  size_t last_time = 0;
+  while (last_time < num_failures && at_risk[last_time + 1] >= 2) {
+    last_time++;
+  }
+
+  /* The logrank statistic is (using the notation in Ishwaran et al. (2008))
+   * sum over all k: dk,l - Yk,l * dk/Yk divided by:
+   *  Yk,l / Yk * (1 - Yk,l / Yk) * (Yk - dk) / (Yk - 1) dk
+   * All terms involving only Yk or dk remain unchanged for each split. A sample with
+   * relabeled time s is in the left risk set Yk,l for every k <= s, so its contribution
+   * to these sums only depends on the prefix sums of the weights up to time s.
+  */
+  numerator_weight_sums.resize(last_time + 1);
+  denominator_weight_sums.resize(last_time + 1);
+  at_risk_weight_sums.resize(last_time + 1);
+  for (size_t time = 1; time < last_time + 1; time++) {
+    double Yk = at_risk[time];
+    double dk = count_failure[time];
+    double denominator_weight = (Yk - dk) / (Yk - 1) * dk / (Yk * Yk);
+    numerator_weight_sums[time] = numerator_weight_sums[time - 1] + dk / Yk;
+    denominator_weight_sums[time] = denominator_weight_sums[time - 1] + denominator_weight;
+    at_risk_weight_sums[time] = at_risk_weight_sums[time - 1] + Yk * denominator_weight;
+  }
+
+  left_counts.resize(last_time + 2);
+  left_weight_sums.resize(last_time + 2);
+}
+
+void SurvivalSplittingRule::LogrankStatistic::clear() {
+  std::fill(left_counts.begin(), left_counts.end(), 0.0);
+  std::fill(left_weight_sums.begin(), left_weight_sums.end(), 0.0);
+  n_left = 0;
+  numerator = 0;
+  denominator = 0;
+}
+
+void SurvivalSplittingRule::LogrankStatistic::add(size_t sample_time, bool failure) {
+  size_t last_time = numerator_weight_sums.size() - 1;
+  size_t time = std::min(sample_time, last_time);
+
+  // The sample adds dl = 1 at its own time, and one to Yl at the times 1, ..., time.
+  if (failure && sample_time >= 1 && sample_time <= last_time) {
+    numerator += 1;
+  }
+  numerator -= numerator_weight_sums[time];
+
+  // Yl * (Y - Yl) changes by Y - 2 Yl - 1 at each of these times, where the sum of
+  // Yl * denominator_weights up to `time` is, for each left sample with (clipped) time s,
+  // the denominator weight sum up to min(s, time).
+  double n_left_before = left_counts_before(time);
+  double left_weighted = left_weight_sums_before(time)
+    + denominator_weight_sums[time] * (n_left - n_left_before);
+  denominator += at_risk_weight_sums[time] - denominator_weight_sums[time] - 2 * left_weighted;
+
+  for (size_t i = time + 1; i < left_counts.size(); i += i & (~i + 1)) {
+    left_counts[i] += 1;
+    left_weight_sums[i] += denominator_weight_sums[time];
   }
+  ++n_left;
+}
 
+double SurvivalSplittingRule::LogrankStatistic::compute() const {
   if (denominator > 0) {
-    logrank = numerator * numerator / denominator;
+    return numerator * numerator / denominator;
+  }
+  return 0;
+}
+
+double SurvivalSplittingRule::LogrankStatistic::left_counts_before(size_t time) const {
+  double sum = 0;
+  for (size_t i = time; i > 0; i -= i & (~i + 1)) {
+    sum += left_counts[i];
   }
+  return sum;
+}
 
-  return logrank;
+double SurvivalSplittingRule::LogrankStatistic::left_weight_sums_before(size_t time) const {
+  double sum = 0;
+  for (size_t i = time; i > 0; i -= i & (~i + 1)) {
+    sum += left_weight_sums[i];
+  }
+  return sum;
 }
 
 } // namespace grf
@@ -52,32 +52,62 @@ public:
                                bool& best_send_missing_left,
                                double& best_logrank);
 
+  /**
+   * The logrank statistic of the left child, updated as samples are moved into it.
+   *
+   * Adding a sample costs O(log m) for m failure times (using two Fenwick trees over
+   * the times of the left samples) and the statistic itself is available in O(1),
+   * instead of an O(m) pass over the left risk sets at every candidate split.
+   *
+   * This class is public for unit testing purposes.
+   */
+  class LogrankStatistic {
+  public:
+    /**
+     * `count_failure` and `at_risk` are the number of failures and the number at risk
+     * in the node at each relabeled time 0, ..., m (time 0 is before the first failure).
+     */
+    LogrankStatistic(const std::vector<double>& count_failure,
+                     const std::vector<double>& at_risk);
+
+    void clear();
+
+    /**
+     * Moves a sample with relabeled time `sample_time` into the left child.
+     */
+    void add(size_t sample_time, bool failure);
+
+    double compute() const;
+
+  private:
+    double left_counts_before(size_t time) const;
+
+    double left_weight_sums_before(size_t time) const;
+
+    std::vector<double> numerator_weight_sums;
+    std::vector<double> denominator_weight_sums;
+    std::vector<double> at_risk_weight_sums;
+
+    std::vector<double> left_counts;
+    std::vector<double> left_weight_sums;
+    size_t n_left;
+    double numerator;
+    double denominator;
+  };
+
 private:
   void find_best_split_value(const Data& data,
                              size_t var,
                              size_t size_node,
                              size_t min_child_size,
                              size_t num_failures_node,
-                             size_t num_failures,
                              double& best_value,
                              size_t& best_var,
                              double& best_logrank,
                              bool& best_send_missing_left,
                              const std::vector<size_t>& samples,
                              const std::vector<size_t>& relabeled_failures,
-                             const std::vector<double>& count_failure,
-                             const std::vector<double>& at_risk,
-                             const std::vector<double>& numerator_weights,
-                             const std::vector<double>& denominator_weights);
-
-  inline double compute_logrank(size_t num_failures,
-                                size_t n_left,
-                                std::vector<double>& cum_sums,
-                                const std::vector<double>& left_count_failure,
-                                const std::vector<double>& left_count_censor,
-                                const std::vector<double>& at_risk,
-                                const std::vector<double>& numerator_weights,
-                                const std::vector<double>& denominator_weights);
+                             LogrankStatistic& logrank);
 
   double alpha;
 
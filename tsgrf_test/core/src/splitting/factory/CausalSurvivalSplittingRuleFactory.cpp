@@ -21,7 +21,8 @@
 namespace grf {
 
 std::unique_ptr<SplittingRule> CausalSurvivalSplittingRuleFactory::create(size_t max_num_unique_values,
-                                                                        const TreeOptions& options) const {
+                                                                        const TreeOptions& options,
+                                                                        RandomSampler& sampler) const {
   return std::unique_ptr<SplittingRule>(new CausalSurvivalSplittingRule(
       max_num_unique_values,
       options.get_min_node_size(),
@@ -26,7 +26,8 @@ MultiCausalSplittingRuleFactory::MultiCausalSplittingRuleFactory(size_t response
   num_treatments(num_treatments) {}
 
 std::unique_ptr<SplittingRule> MultiCausalSplittingRuleFactory::create(size_t max_num_unique_values,
-                                                                       const TreeOptions& options) const {
+                                                                       const TreeOptions& options,
+                                                                       RandomSampler& sampler) const {
   return std::unique_ptr<SplittingRule>(new MultiCausalSplittingRule(
       max_num_unique_values,
       options.get_min_node_size(),
@@ -28,7 +28,8 @@ public:
                                   size_t num_treatments);
 
   std::unique_ptr<SplittingRule> create(size_t max_num_unique_values,
-                                        const TreeOptions& options) const;
+                                        const TreeOptions& options,
+                                        RandomSampler& sampler) const;
 private:
   size_t response_length;
   size_t num_treatments;
@@ -21,6 +21,7 @@
 #include <memory>
 
 #include "commons/Data.h"
+#include "sampling/RandomSampler.h"
 #include "splitting/SplittingRule.h"
 #include "tree/TreeOptions.h"
 
@@ -31,8 +32,16 @@ public:
 
   virtual ~SplittingRuleFactory() = default;
 
+  /**
+   * Creates the splitting rule of one tree.
+   *
+   * @param max_num_unique_values: the number of samples the tree is grown on.
+   * @param options: the tree options.
+   * @param sampler: the tree's sampler, for rules that draw random split values.
+   */
   virtual std::unique_ptr<SplittingRule> create(size_t max_num_unique_values,
-                                                const TreeOptions& options) const = 0;
+                                                const TreeOptions& options,
+                                                RandomSampler& sampler) const = 0;
 };
 
 } // namespace grf
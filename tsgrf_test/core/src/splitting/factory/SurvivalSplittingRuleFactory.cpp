@@ -21,7 +21,8 @@
 namespace grf {
 
 std::unique_ptr<SplittingRule> SurvivalSplittingRuleFactory::create(size_t max_num_unique_values,
-                                                                    const TreeOptions& options) const {
+                                                                    const TreeOptions& options,
+                                                                    RandomSampler& sampler) const {
   return std::unique_ptr<SplittingRule>(new SurvivalSplittingRule(
       options.get_alpha()));
 }
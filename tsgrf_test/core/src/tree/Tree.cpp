@@ -124,11 +124,11 @@ size_t Tree::find_leaf_node(const Data& data,
     size_t split_var = get_split_vars()[node];
     double split_val = get_split_values()[node];
     double value = data.get(sample, split_var);
-    bool send_na_left = get_send_missing_left()[node];
     if (
         (value <= split_val) || // ordinary split
-        (send_na_left && std::isnan(value)) || // are we sending NaN left
-        (std::isnan(split_val) && std::isnan(value)) // are we splitting on NaN
+        (data.has_nan(split_var) && std::isnan(value) && // skipped for columns without NaN
+         (get_send_missing_left()[node] || // are we sending NaN left
+          std::isnan(split_val))) // are we splitting on NaN
       ) {
       // Move to left child
       node = child_nodes[0][node];
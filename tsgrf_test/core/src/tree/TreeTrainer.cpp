@@ -65,7 +65,9 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
 
   // nodes[0].size() is the number of samples subsampled for this tree.
   std::unique_ptr<SplittingRule> splitting_rule = splitting_rule_factory->create(
-      nodes[0].size(), options);
+      nodes[0].size(), options, sampler);
+  SortedSamplesCache sorted_samples_cache(data.get_num_rows());
+  splitting_rule->set_sorted_samples_cache(&sorted_samples_cache);
 
   size_t num_open_nodes = 1;
   size_t i = 0;
@@ -74,6 +76,7 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
     bool is_leaf_node = split_node(i,
                                    data,
                                    splitting_rule,
+                                   sorted_samples_cache,
                                    sampler,
                                    child_nodes,
                                    nodes,
@@ -148,7 +151,9 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
 
   // nodes[0].size() is the number of samples subsampled for this tree.
   std::unique_ptr<SplittingRule> splitting_rule = splitting_rule_factory->create(
-      nodes[0].size(), options);
+      nodes[0].size(), options, sampler);
+  SortedSamplesCache sorted_samples_cache(data.get_num_rows());
+  splitting_rule->set_sorted_samples_cache(&sorted_samples_cache);
 
   size_t num_open_nodes = 1;
   size_t i = 0;
@@ -157,6 +162,7 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
     bool is_leaf_node = split_node(i,
                                    data,
                                    splitting_rule,
+                                   sorted_samples_cache,
                                    sampler,
                                    child_nodes,
                                    nodes,
@@ -230,6 +236,7 @@ void TreeTrainer::create_split_variable_subset(std::vector<size_t>& result,
 bool TreeTrainer::split_node(size_t node,
                              const Data& data,
                              const std::unique_ptr<SplittingRule>& splitting_rule,
+                             SortedSamplesCache& sorted_samples_cache,
                              RandomSampler& sampler,
                              std::vector<std::vector<size_t>>& child_nodes,
                              std::vector<std::vector<size_t>>& samples,
@@ -245,6 +252,7 @@ bool TreeTrainer::split_node(size_t node,
   bool stop = split_node_internal(node,
                                   data,
                                   splitting_rule,
+                                  sorted_samples_cache,
                                   possible_split_vars,
                                   samples,
                                   split_vars,
@@ -267,16 +275,17 @@ bool TreeTrainer::split_node(size_t node,
   size_t right_child_node = samples.size();
   child_nodes[1][node] = right_child_node;
   create_empty_node(child_nodes, samples, split_vars, split_values, send_missing_left);
+  sorted_samples_cache.keep_for_children(left_child_node, right_child_node);
+
+  // NaNs go left if we are sending NaN left, or splitting on NaN. Columns
+  // without NaN skip this check.
+  bool nan_left = data.has_nan(split_var) && (send_na_left || std::isnan(split_value));
 
   // For each sample in node, assign to left or right child
   // Ordered: left is <= splitval and right is > splitval
   for (auto& sample : samples[node]) {
-  double value = data.get(sample, split_var);
-    if (
-        (value <= split_value) || // ordinary split
-        (send_na_left && std::isnan(value)) || // are we sending NaN left
-        (std::isnan(split_value) && std::isnan(value)) // are we splitting on NaN, then always send NaNs left
-      ) {
+    double value = data.get(sample, split_var);
+    if (value <= split_value || (nan_left && std::isnan(value))) {
       samples[left_child_node].push_back(sample);
     } else {
       samples[right_child_node].push_back(sample);
@@ -290,6 +299,7 @@ bool TreeTrainer::split_node(size_t node,
 bool TreeTrainer::split_node_internal(size_t node,
                                       const Data& data,
                                       const std::unique_ptr<SplittingRule>& splitting_rule,
+                                      SortedSamplesCache& sorted_samples_cache,
                                       const std::vector<size_t>& possible_split_vars,
                                       const std::vector<std::vector<size_t>>& samples,
                                       std::vector<size_t>& split_vars,
@@ -305,14 +315,20 @@ bool TreeTrainer::split_node_internal(size_t node,
 
   bool stop = relabeling_strategy->relabel(samples[node], data, responses_by_sample);
 
-  if (stop || splitting_rule->find_best_split(data,
-                                              node,
-                                              possible_split_vars,
-                                              responses_by_sample,
-                                              samples,
-                                              split_vars,
-                                              split_values,
-                                              send_missing_left)) {
+  if (!stop) {
+    sorted_samples_cache.begin_node(node, samples[node], possible_split_vars);
+    stop = splitting_rule->find_best_split(data,
+                                           node,
+                                           possible_split_vars,
+                                           responses_by_sample,
+                                           samples,
+                                           split_vars,
+                                           split_values,
+                                           send_missing_left);
+    sorted_samples_cache.end_node();
+  }
+
+  if (stop) {
     split_values[node] = -1.0;
     return true;
   }
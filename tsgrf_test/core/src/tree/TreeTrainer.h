@@ -25,6 +25,7 @@
 #include "prediction/OptimizedPredictionStrategy.h"
 #include "relabeling/RelabelingStrategy.h"
 #include "sampling/RandomSampler.h"
+#include "splitting/SortedSamplesCache.h"
 #include "splitting/factory/SplittingRuleFactory.h"
 #include "tree/Tree.h"
 #include "tree/TreeOptions.h"
@@ -68,6 +69,7 @@ private:
   bool split_node(size_t node,
                   const Data& data,
                   const std::unique_ptr<SplittingRule>& splitting_rule,
+                  SortedSamplesCache& sorted_samples_cache,
                   RandomSampler& sampler,
                   std::vector<std::vector<size_t>>& child_nodes,
                   std::vector<std::vector<size_t>>& samples,
@@ -80,6 +82,7 @@ private:
   bool split_node_internal(size_t node,
                            const Data& data,
                            const std::unique_ptr<SplittingRule>& splitting_rule,
+                           SortedSamplesCache& sorted_samples_cache,
                            const std::vector<size_t>& possible_split_vars,
                            const std::vector<std::vector<size_t>>& samples,
                            std::vector<size_t>& split_vars,
@@ -0,0 +1,137 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "commons/ColumnFile.h"
+#include "commons/utility.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("column files round trip data and column names", "[data]") {
+  std::vector<double> data_vec = {1, 2, 3, 0.1, 0.2, 0.3, 7, 8, NAN};
+  Data data(data_vec, 3, 3);
+  std::string file_name = "column_file_test.bin";
+  write_column_file(file_name, data, {"x1", "x2", "y"}, {COLUMN_FLOAT64, COLUMN_FLOAT32, COLUMN_FLOAT64});
+
+  {
+    ColumnFile file(file_name);
+    REQUIRE(file.get_num_rows() == 3);
+    REQUIRE(file.get_num_cols() == 3);
+    REQUIRE(file.get_column_names() == std::vector<std::string>({"x1", "x2", "y"}));
+    REQUIRE(file.get_column_index("y") == 2);
+    REQUIRE_THROWS_AS(file.get_column_index("z"), std::runtime_error);
+
+    Data mapped = file.get_data();
+    mapped.set_outcome_index(file.get_column_index("y"));
+    REQUIRE(mapped.get_num_cols() == 3);
+    for (size_t row = 0; row < 3; row++) {
+      REQUIRE(mapped.get(row, 0) == data.get(row, 0));
+      REQUIRE(mapped.get(row, 1) == static_cast<float>(data.get(row, 1)));
+    }
+    REQUIRE(mapped.get_outcome(1) == 8);
+    REQUIRE(std::isnan(mapped.get_outcome(2)));
+  }
+
+  std::remove(file_name.c_str());
+}
+
+TEST_CASE("column files store which columns contain NaN", "[data]") {
+  std::vector<double> data_vec = {1, 2, 3, NAN, 0.2, 0.3, 7, 8, 9};
+  Data data(data_vec, 3, 3);
+  std::string file_name = "column_file_test.bin";
+  write_column_file(file_name, data, {}, {COLUMN_FLOAT64, COLUMN_FLOAT32, COLUMN_FLOAT64});
+
+  {
+    ColumnFile file(file_name);
+    Data mapped = file.get_data();
+    REQUIRE_FALSE(mapped.has_nan(0));
+    REQUIRE(mapped.has_nan(1));
+    REQUIRE_FALSE(mapped.has_nan(2));
+  }
+
+  // The flags come from the header, not from reading the columns: overwrite the 7 of the
+  // last column with NaN behind the header's back.
+  std::string contents;
+  {
+    std::ifstream input_file(file_name, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(input_file), std::istreambuf_iterator<char>());
+  }
+  double seven = 7;
+  double nan = NAN;
+  size_t position = contents.find(std::string(reinterpret_cast<const char*>(&seven), sizeof(double)));
+  REQUIRE(position != std::string::npos);
+  contents.replace(position, sizeof(double), reinterpret_cast<const char*>(&nan), sizeof(double));
+  {
+    std::ofstream output_file(file_name, std::ios::binary | std::ios::trunc);
+    output_file.write(contents.data(), contents.size());
+  }
+  {
+    ColumnFile file(file_name);
+    Data mapped = file.get_data();
+    REQUIRE(std::isnan(mapped.get(0, 2)));
+    REQUIRE_FALSE(mapped.has_nan(2));
+  }
+
+  std::remove(file_name.c_str());
+}
+
+TEST_CASE("column files reject files in another format", "[data]") {
+  std::string file_name = "column_file_test.bin";
+  {
+    std::ofstream output_file(file_name);
+    output_file << "1.0 2.0 3.0\n4.0 5.0 6.0\n";
+  }
+  REQUIRE_THROWS_AS(ColumnFile(file_name), std::runtime_error);
+  std::remove(file_name.c_str());
+
+  REQUIRE_THROWS_AS(ColumnFile("test/forest/resources/missing_file.bin"), std::runtime_error);
+}
+
+TEST_CASE("forests on a mapped column file match forests on the loaded text file", "[data], [forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  std::string file_name = "column_file_test.bin";
+  write_column_file(file_name, data, {}, {});
+
+  ColumnFile file(file_name);
+  Data mapped = file.get_data();
+  mapped.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(2);
+  ForestOptions options(50, 1, 0.5, 3, 5, true, 0.5, true, 0.05, 0, 2, 42, std::vector<size_t>(), 0);
+
+  Forest forest = trainer.train(data, options);
+  Forest mapped_forest = trainer.train(mapped, options);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> mapped_predictions = predictor.predict_oob(mapped_forest, mapped, false);
+  for (size_t row = 0; row < data.get_num_rows(); row++) {
+    REQUIRE(predictions[row].get_predictions()[0] == mapped_predictions[row].get_predictions()[0]);
+  }
+
+  std::remove(file_name.c_str());
+}
@@ -0,0 +1,353 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+#include "commons/Data.h"
+#include "commons/utility.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+static bool same_value(double lhs, double rhs) {
+  return lhs == rhs || (std::isnan(lhs) && std::isnan(rhs));
+}
+
+TEST_CASE("data over column buffers reads like a contiguous array", "[data]") {
+  std::vector<double> X = {1, 2, 3, 4, 5, 6};
+  std::vector<double> Y = {7, 8, 9};
+  std::vector<double> weights = {0.5, 1, 2};
+  std::vector<double> data_vec = {1, 2, 3, 4, 5, 6, 7, 8, 9, 0.5, 1, 2};
+
+  Data data(data_vec, 3, 4);
+  Data buffer_data({X.data(), X.data() + 3, Y.data(), weights.data()}, 3);
+  for (Data* d : {&data, &buffer_data}) {
+    d->set_outcome_index(2);
+    d->set_weight_index(3);
+  }
+
+  REQUIRE(buffer_data.get_num_rows() == 3);
+  REQUIRE(buffer_data.get_num_cols() == 4);
+  for (size_t row = 0; row < 3; row++) {
+    for (size_t col = 0; col < 4; col++) {
+      REQUIRE(buffer_data.get(row, col) == data.get(row, col));
+    }
+    REQUIRE(buffer_data.get_outcome(row) == Y[row]);
+    REQUIRE(buffer_data.get_weight(row) == weights[row]);
+  }
+
+  Data range = buffer_data.get_row_range(1, 3);
+  REQUIRE(range.get_num_rows() == 2);
+  REQUIRE(range.get_outcome(0) == 8);
+  REQUIRE(range.get(1, 1) == 6);
+
+  REQUIRE_THROWS_AS(Data({X.data(), nullptr}, 3), std::runtime_error);
+}
+
+TEST_CASE("external columns must come before virtual columns", "[data]") {
+  std::vector<double> data_vec = {1, 2, 3, 4, 5, 6};
+  std::vector<double> column = {7, 8, 9};
+  Data data(data_vec, 3, 2);
+  size_t lag_index = data.add_virtual_column(0, 1, 1, ROLLING_MEAN);
+  REQUIRE(lag_index == 2);
+  REQUIRE_THROWS_AS(data.add_external_column(column.data()), std::runtime_error);
+}
+
+TEST_CASE("columns are flagged if they contain NaN", "[data], [NaN]") {
+  std::vector<double> data_vec = {1, 2, 3, 4, NAN, 6};
+  std::vector<float> float_column = {NAN, 1, 2};
+  std::vector<int> column_starts = {0, 1};
+  std::vector<int> row_indices = {2};
+  std::vector<double> sparse_values = {NAN};
+  Data data(data_vec, 3, 2);
+  data.add_external_column(float_column.data());
+  data.add_sparse_columns(column_starts.data(), row_indices.data(), sparse_values.data(), 1);
+  size_t lag_index = data.add_virtual_column(0, 1, 1, ROLLING_MEAN);
+
+  REQUIRE_FALSE(data.has_nan(0));
+  REQUIRE(data.has_nan(1));
+  REQUIRE(data.has_nan(2));
+  REQUIRE(data.has_nan(3));
+  REQUIRE(data.has_nan(lag_index));
+  // A row range keeps the flags of the full data.
+  REQUIRE(data.get_row_range(0, 1).has_nan(1));
+}
+
+TEST_CASE("NaN flags can be refreshed after the storage is modified", "[data], [NaN]") {
+  std::vector<double> data_vec = {1, 2, 3, 4, 5, 6};
+  std::vector<float> float_column = {0, 1, 2};
+  std::vector<int> column_starts = {0, 1};
+  std::vector<int> row_indices = {2};
+  std::vector<double> sparse_values = {7};
+  Data data(data_vec, 3, 2);
+  data.add_external_column(float_column.data());
+  data.add_sparse_columns(column_starts.data(), row_indices.data(), sparse_values.data(), 1);
+  Data range = data.get_row_range(1, 3);
+
+  data_vec[0] = NAN;
+  float_column[2] = NAN;
+  sparse_values[0] = NAN;
+  REQUIRE_FALSE(data.has_nan(0));
+
+  data.refresh_nan_flags();
+  REQUIRE(data.has_nan(0));
+  REQUIRE_FALSE(data.has_nan(1));
+  REQUIRE(data.has_nan(2));
+  REQUIRE(data.has_nan(3));
+
+  // A row range rescans the full data, so the NaN in row 0 is flagged as well.
+  range.refresh_nan_flags();
+  REQUIRE(range.has_nan(0));
+  REQUIRE(range.has_nan(2));
+  REQUIRE(range.has_nan(3));
+}
+
+TEST_CASE("sorting values is stable for every node size", "[data], [NaN]") {
+  size_t num_rows = 3000;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> coarse(-5, 5);
+  std::normal_distribution<double> normal(0, 1e3);
+  std::vector<double> specials = {NAN, 0.0, -0.0, INFINITY, -INFINITY, 4.9e-324, -4.9e-324, -1e300};
+
+  // Column-major: ties, special values and missing values, and then continuous values.
+  std::vector<double> data_vec(2 * num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    data_vec[row] = row % 7 == 0 ? specials[row % specials.size()] : coarse(gen);
+    data_vec[num_rows + row] = normal(gen);
+  }
+  Data data(data_vec, num_rows, 2);
+
+  std::vector<size_t> rows(num_rows);
+  std::iota(rows.begin(), rows.end(), 0);
+  std::shuffle(rows.begin(), rows.end(), gen);
+
+  // Node sizes around the insertion sort and radix sort cutoffs.
+  for (size_t size : {1, 2, 15, 16, 17, 100, 511, 512, 3000}) {
+    std::vector<size_t> samples(rows.begin(), rows.begin() + size);
+    for (size_t col = 0; col < 2; col++) {
+      std::vector<size_t> expected_index(size);
+      std::iota(expected_index.begin(), expected_index.end(), 0);
+      std::stable_sort(expected_index.begin(), expected_index.end(), [&](size_t lhs, size_t rhs) {
+        double left = data.get(samples[lhs], col);
+        double right = data.get(samples[rhs], col);
+        return left < right || (std::isnan(left) && !std::isnan(right));
+      });
+      std::vector<double> expected_values;
+      for (size_t i : expected_index) {
+        double value = data.get(samples[i], col);
+        if (expected_values.empty() || !same_value(value, expected_values.back())) {
+          expected_values.push_back(value);
+        }
+      }
+
+      std::vector<double> all_values;
+      std::vector<size_t> sorted_samples;
+      std::vector<size_t> index = data.get_all_values(all_values, sorted_samples, samples, col);
+      REQUIRE(index == expected_index);
+      for (size_t i = 0; i < size; i++) {
+        REQUIRE(sorted_samples[i] == samples[expected_index[i]]);
+      }
+      REQUIRE(all_values.size() == expected_values.size());
+      for (size_t i = 0; i < all_values.size(); i++) {
+        REQUIRE(same_value(all_values[i], expected_values[i]));
+        REQUIRE(std::signbit(all_values[i]) == std::signbit(expected_values[i]));
+      }
+    }
+  }
+}
+
+TEST_CASE("forests on column buffers match forests on a contiguous array", "[data], [forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  size_t num_rows = data_vec.second[0];
+  size_t num_cols = data_vec.second[1];
+
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  // The same columns, with the outcome in its own buffer.
+  std::vector<double> Y(data_vec.first.begin() + 10 * num_rows, data_vec.first.begin() + 11 * num_rows);
+  std::vector<const double*> columns;
+  for (size_t col = 0; col < num_cols; col++) {
+    columns.push_back(col == 10 ? Y.data() : data_vec.first.data() + col * num_rows);
+  }
+  Data buffer_data(columns, num_rows);
+  buffer_data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(2);
+  ForestOptions options(50, 2, 0.35, 3, 5, true, 0.5, true, 0.05, 0, 2, 42, std::vector<size_t>(), 0);
+
+  Forest forest = trainer.train(data, options);
+  Forest buffer_forest = trainer.train(buffer_data, options);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> buffer_predictions = predictor.predict_oob(buffer_forest, buffer_data, false);
+
+  for (size_t row = 0; row < num_rows; row++) {
+    REQUIRE(predictions[row].get_predictions()[0] == buffer_predictions[row].get_predictions()[0]);
+  }
+}
+
+TEST_CASE("forests on single precision covariates match forests on the rounded doubles", "[data], [forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  size_t num_rows = data_vec.second[0];
+  size_t num_features = 10;
+
+  // X in single precision, and the same values widened back to double.
+  std::vector<float> X(data_vec.first.begin(), data_vec.first.begin() + num_features * num_rows);
+  std::vector<double> rounded_vec(X.begin(), X.end());
+  rounded_vec.insert(rounded_vec.end(), data_vec.first.begin() + num_features * num_rows,
+                     data_vec.first.begin() + (num_features + 1) * num_rows);
+  std::vector<double> Y(rounded_vec.begin() + num_features * num_rows, rounded_vec.end());
+
+  Data rounded_data(rounded_vec, num_rows, num_features + 1);
+  rounded_data.set_outcome_index(num_features);
+  Data float_data(X.data(), num_rows, num_features);
+  float_data.set_outcome_index(float_data.add_external_column(Y.data()));
+
+  REQUIRE(float_data.get_num_cols() == num_features + 1);
+  REQUIRE(float_data.get(3, 2) == rounded_data.get(3, 2));
+  REQUIRE(float_data.get_row_range(5, 10).get(1, 4) == rounded_data.get(6, 4));
+  REQUIRE_THROWS_AS(float_data.add_virtual_column(0, 1, 1, ROLLING_MEAN), std::runtime_error);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(2);
+  ForestOptions options(50, 2, 0.35, 3, 5, true, 0.5, true, 0.05, 0, 2, 42, std::vector<size_t>(), 0);
+
+  Forest rounded_forest = trainer.train(rounded_data, options);
+  Forest float_forest = trainer.train(float_data, options);
+  std::vector<Prediction> rounded_predictions = predictor.predict_oob(rounded_forest, rounded_data, false);
+  std::vector<Prediction> float_predictions = predictor.predict_oob(float_forest, float_data, false);
+
+  for (size_t row = 0; row < num_rows; row++) {
+    REQUIRE(float_predictions[row].get_predictions()[0] == rounded_predictions[row].get_predictions()[0]);
+  }
+}
+
+// Sparse copies of the first `num_cols` columns of a dense column major array.
+static void to_sparse(const std::vector<double>& dense, size_t num_rows, size_t num_cols,
+                      std::vector<int>& column_starts, std::vector<int>& row_indices, std::vector<double>& values) {
+  column_starts = {0};
+  for (size_t col = 0; col < num_cols; col++) {
+    for (size_t row = 0; row < num_rows; row++) {
+      double value = dense[col * num_rows + row];
+      if (value != 0) {
+        row_indices.push_back(static_cast<int>(row));
+        values.push_back(value);
+      }
+    }
+    column_starts.push_back(static_cast<int>(values.size()));
+  }
+}
+
+TEST_CASE("sparse columns read and sort like dense columns", "[data]") {
+  size_t num_rows = 400;
+  size_t num_cols = 4;
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> uniform(-1, 1);
+  std::vector<double> dense(num_cols * num_rows);
+  for (size_t col = 0; col < num_cols; col++) {
+    for (size_t row = 0; row < num_rows; row++) {
+      double u = uniform(gen);
+      // Mostly zeros, a few ties, and missing values in one column.
+      double value = std::abs(u) < 0.8 ? 0 : std::round(u * 10) / 10;
+      if (col == 3 && row % 50 == 0) {
+        value = NAN;
+      }
+      dense[col * num_rows + row] = value;
+    }
+  }
+  std::vector<int> column_starts;
+  std::vector<int> row_indices;
+  std::vector<double> values;
+  to_sparse(dense, num_rows, num_cols, column_starts, row_indices, values);
+
+  Data data(dense, num_rows, num_cols);
+  Data sparse_data(std::vector<const double*>(), num_rows);
+  REQUIRE(sparse_data.add_sparse_columns(column_starts.data(), row_indices.data(), values.data(), num_cols) == 0);
+  REQUIRE(sparse_data.get_num_cols() == num_cols);
+
+  std::vector<size_t> samples;
+  for (size_t row = 0; row < num_rows; row += 3) {
+    samples.push_back(num_rows - 1 - row);
+  }
+  Data range = data.get_row_range(100, 300);
+  Data sparse_range = sparse_data.get_row_range(100, 300);
+  for (size_t col = 0; col < num_cols; col++) {
+    for (size_t row = 0; row < num_rows; row++) {
+      REQUIRE(same_value(sparse_data.get(row, col), data.get(row, col)));
+    }
+    REQUIRE(same_value(sparse_range.get(7, col), range.get(7, col)));
+
+    std::vector<double> all_values, sparse_all_values;
+    std::vector<size_t> sorted_samples, sparse_sorted_samples;
+    std::vector<size_t> index = data.get_all_values(all_values, sorted_samples, samples, col);
+    std::vector<size_t> sparse_index = sparse_data.get_all_values(sparse_all_values, sparse_sorted_samples, samples, col);
+    REQUIRE(sparse_index == index);
+    REQUIRE(sparse_sorted_samples == sorted_samples);
+    REQUIRE(sparse_all_values.size() == all_values.size());
+    for (size_t i = 0; i < all_values.size(); i++) {
+      REQUIRE(same_value(sparse_all_values[i], all_values[i]));
+    }
+  }
+
+  std::vector<int> unsorted_rows = {2, 1};
+  std::vector<int> starts = {0, 2};
+  REQUIRE_THROWS_AS(sparse_data.add_sparse_columns(starts.data(), unsorted_rows.data(), values.data(), 1),
+                    std::runtime_error);
+}
+
+TEST_CASE("forests on sparse columns match forests on dense columns", "[data], [forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  size_t num_rows = data_vec.second[0];
+  size_t num_features = 10;
+  // Zero out most of the covariates.
+  std::vector<double> dense = data_vec.first;
+  for (size_t i = 0; i < num_features * num_rows; i++) {
+    if (std::abs(dense[i]) < 1) {
+      dense[i] = 0;
+    }
+  }
+  std::vector<int> column_starts;
+  std::vector<int> row_indices;
+  std::vector<double> values;
+  to_sparse(dense, num_rows, num_features, column_starts, row_indices, values);
+  std::vector<double> Y(dense.begin() + num_features * num_rows, dense.begin() + (num_features + 1) * num_rows);
+
+  Data data(dense, num_rows, num_features + 1);
+  data.set_outcome_index(num_features);
+  Data sparse_data(std::vector<const double*>(), num_rows);
+  sparse_data.add_sparse_columns(column_starts.data(), row_indices.data(), values.data(), num_features);
+  sparse_data.set_outcome_index(sparse_data.add_external_column(Y.data()));
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(2);
+  ForestOptions options(50, 2, 0.35, 3, 5, true, 0.5, true, 0.05, 0, 2, 42, std::vector<size_t>(), 0);
+
+  Forest forest = trainer.train(data, options);
+  Forest sparse_forest = trainer.train(sparse_data, options);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> sparse_predictions = predictor.predict_oob(sparse_forest, sparse_data, false);
+  for (size_t row = 0; row < num_rows; row++) {
+    REQUIRE(predictions[row].get_predictions()[0] == sparse_predictions[row].get_predictions()[0]);
+  }
+}
@@ -0,0 +1,81 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+#include "commons/TextDataLoader.h"
+#include "commons/utility.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+static void write_file(const std::string& file_name, const std::string& contents) {
+  std::ofstream output_file(file_name, std::ios::binary);
+  output_file << contents;
+}
+
+TEST_CASE("the text loader reads whitespace delimited files like load_data", "[data]") {
+  auto expected = load_data("test/forest/resources/gaussian_data.csv");
+  std::vector<std::string> column_names;
+
+  for (uint num_threads : {1, 4}) {
+    auto data = load_text_data("test/forest/resources/gaussian_data.csv", ' ', false, num_threads, column_names);
+    REQUIRE(data.second == expected.second);
+    REQUIRE(data.first == expected.first);
+    REQUIRE(column_names.empty());
+  }
+}
+
+TEST_CASE("the text loader handles headers, missing values and blank lines", "[data]") {
+  std::string file_name = "text_loader_test.csv";
+  write_file(file_name, "\"x\", y,z\r\n1.5,NA,3\r\n\r\n-2, , 1e-3\n4,NaN,\"5\"");
+  std::vector<std::string> column_names;
+
+  auto data = load_text_data(file_name, ',', true, 2, column_names);
+  REQUIRE(column_names == std::vector<std::string>({"x", "y", "z"}));
+  REQUIRE(data.second == std::vector<size_t>({3, 3}));
+  std::vector<double>& values = data.first;
+  REQUIRE(values[0] == 1.5);
+  REQUIRE(values[1] == -2);
+  REQUIRE(values[2] == 4);
+  REQUIRE(std::isnan(values[3]));
+  REQUIRE(std::isnan(values[4]));
+  REQUIRE(std::isnan(values[5]));
+  REQUIRE(values[6] == 3);
+  REQUIRE(values[7] == 0.001);
+  REQUIRE(values[8] == 5);
+
+  std::remove(file_name.c_str());
+}
+
+TEST_CASE("the text loader reports the first malformed line", "[data]") {
+  std::string file_name = "text_loader_test.csv";
+  std::vector<std::string> column_names;
+
+  write_file(file_name, "1 2 3\n4 5 6\n7 8\n9 x 1\n");
+  REQUIRE_THROWS_WITH(load_text_data(file_name, ' ', false, 2, column_names),
+                      "Malformed row on line 3: expected 3 values but found 2.");
+
+  write_file(file_name, "a,b\n1,2\n3,abc\n");
+  REQUIRE_THROWS_WITH(load_text_data(file_name, ',', true, 1, column_names),
+                      "Could not parse the value 'abc' on line 3.");
+
+  std::remove(file_name.c_str());
+}
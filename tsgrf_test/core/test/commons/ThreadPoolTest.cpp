@@ -0,0 +1,138 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "catch.hpp"
+#include "commons/ThreadPool.h"
+#include "commons/utility.h"
+#include "forest/ForestTrainers.h"
+#include "forest/TrainingControl.h"
+#include "utilities/ForestTestUtilities.h"
+
+using namespace grf;
+
+TEST_CASE("parallel for runs every task exactly once", "[threadPool]") {
+  std::vector<int> counts(1000, 0);
+  ThreadPool::get_instance().parallel_for(counts.size(), 4, [&](size_t i) {
+    counts[i]++;
+  });
+
+  REQUIRE(std::vector<int>(1000, 1) == counts);
+}
+
+TEST_CASE("parallel for handles empty and single task loops", "[threadPool]") {
+  size_t num_calls = 0;
+  ThreadPool::get_instance().parallel_for(0, 4, [&](size_t i) { num_calls++; });
+  REQUIRE(num_calls == 0);
+
+  ThreadPool::get_instance().parallel_for(1, 4, [&](size_t i) { num_calls++; });
+  REQUIRE(num_calls == 1);
+}
+
+TEST_CASE("nested parallel for loops do not deadlock", "[threadPool]") {
+  std::atomic<size_t> total(0);
+  ThreadPool::get_instance().parallel_for(8, 4, [&](size_t i) {
+    ThreadPool::get_instance().parallel_for(100, 4, [&](size_t j) {
+      total += j;
+    });
+  });
+
+  REQUIRE(total == 8 * 4950);
+}
+
+TEST_CASE("parallel for rethrows the exception of a failing task", "[threadPool]") {
+  std::atomic<size_t> num_calls(0);
+  REQUIRE_THROWS_AS(ThreadPool::get_instance().parallel_for(50, 4, [&](size_t i) {
+    num_calls++;
+    if (i == 3) {
+      throw std::runtime_error("task failed");
+    }
+  }), std::runtime_error);
+  REQUIRE(num_calls <= 50);
+}
+
+TEST_CASE("async parallel for completes on pool workers", "[threadPool]") {
+  std::vector<int> counts(100, 0);
+  std::future<void> done = ThreadPool::get_instance().parallel_for_async(counts.size(), 3, [&](size_t i) {
+    counts[i]++;
+  });
+  done.get();
+
+  REQUIRE(std::vector<int>(100, 1) == counts);
+}
+
+TEST_CASE("bounding the number of threads keeps loops working", "[threadPool]") {
+  uint old_max_num_threads = ThreadPool::get_max_num_threads();
+  ThreadPool::set_max_num_threads(1);
+  REQUIRE(ThreadPool::get_max_num_threads() == 1);
+
+  std::vector<int> counts(100, 0);
+  ThreadPool::get_instance().parallel_for(counts.size(), 8, [&](size_t i) { counts[i]++; });
+  ThreadPool::get_instance().parallel_for_async(counts.size(), 8, [&](size_t i) { counts[i]++; }).get();
+  REQUIRE(std::vector<int>(100, 2) == counts);
+
+  ThreadPool::set_max_num_threads(old_max_num_threads);
+}
+
+#ifndef _WIN32
+TEST_CASE("a forked child trains forests on a fresh pool", "[threadPool]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options();
+
+  // Start the pool's workers in the parent.
+  Forest forest = trainer.train(data, options);
+  REQUIRE(forest.get_trees().size() == options.get_num_trees());
+
+  pid_t pid = fork();
+  REQUIRE(pid >= 0);
+  if (pid == 0) {
+    // Without a fresh pool, the loops below would wait forever for the parent's workers.
+    alarm(60);
+    int status = 1;
+    try {
+      TrainingControl control;
+      control.set_progress_callback([](size_t, size_t, double) { return true; }, 0.01);
+      Forest child_forest = trainer.train(data, options, control);
+      Forest blocking_forest = trainer.train(data, options);
+      if (child_forest.get_trees().size() == options.get_num_trees() &&
+          blocking_forest.get_trees().size() == options.get_num_trees()) {
+        status = 0;
+      }
+    } catch (...) {}
+    _exit(status);
+  }
+
+  int status = 0;
+  REQUIRE(waitpid(pid, &status, 0) == pid);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 0);
+
+  // The parent's pool is unaffected.
+  Forest parent_forest = trainer.train(data, options);
+  REQUIRE(parent_forest.get_trees().size() == options.get_num_trees());
+}
+#endif
@@ -0,0 +1,190 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <random>
+
+#include "commons/Data.h"
+#include "commons/ThreadPool.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+static bool same_value(double lhs, double rhs) {
+  return (std::isnan(lhs) && std::isnan(rhs)) || std::abs(lhs - rhs) < 1e-12;
+}
+
+// The feature of `series` at `row` computed directly from its definition.
+static double expected_feature(const std::vector<double>& series, size_t row, size_t lag, size_t window,
+                               RollingStatistic statistic) {
+  if (row + 1 < lag + window) {
+    return NAN;
+  }
+  std::vector<double> values(series.begin() + row - lag + 1 - window, series.begin() + row - lag + 1);
+  double mean = 0;
+  for (double value : values) {
+    if (std::isnan(value)) {
+      return NAN;
+    }
+    mean += value;
+  }
+  mean /= window;
+  if (window == 1 || statistic == ROLLING_MEAN) {
+    return window == 1 ? values[0] : mean;
+  } else if (statistic == ROLLING_MIN) {
+    return *std::min_element(values.begin(), values.end());
+  } else if (statistic == ROLLING_MAX) {
+    return *std::max_element(values.begin(), values.end());
+  }
+  double sum_squares = 0;
+  for (double value : values) {
+    sum_squares += (value - mean) * (value - mean);
+  }
+  return std::sqrt(sum_squares / (window - 1));
+}
+
+TEST_CASE("virtual columns match their definition across blocks", "[data]") {
+  size_t num_rows = 3000;
+  std::mt19937 gen(42);
+  std::normal_distribution<double> normal(0, 1);
+  std::vector<double> data_vec(2 * num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    data_vec[row] = row == 1500 ? NAN : normal(gen);
+    data_vec[num_rows + row] = normal(gen);
+  }
+  std::vector<double> series(data_vec.begin(), data_vec.begin() + num_rows);
+  Data data(data_vec, num_rows, 2);
+  data.set_outcome_index(1);
+
+  struct Feature { size_t lag; size_t window; RollingStatistic statistic; };
+  std::vector<Feature> features = {{1, 1, ROLLING_MEAN}, {12, 1, ROLLING_MEAN}, {0, 5, ROLLING_MEAN},
+                                   {1, 30, ROLLING_MIN}, {2, 7, ROLLING_MAX}, {0, 20, ROLLING_SD}};
+  for (const Feature& feature : features) {
+    size_t col = data.add_virtual_column(0, feature.lag, feature.window, feature.statistic);
+    REQUIRE(col == data.get_num_cols() - 1);
+  }
+  REQUIRE(data.get_num_cols() == 2 + features.size());
+
+  // Read the columns concurrently, so that several threads race to fill the same blocks.
+  std::vector<double> values(features.size() * num_rows);
+  ThreadPool::get_instance().parallel_for(values.size(), 4, [&](size_t i) {
+    values[i] = data.get((i * 7919) % num_rows, 2 + i / num_rows);
+  });
+
+  for (size_t i = 0; i < values.size(); i++) {
+    const Feature& feature = features[i / num_rows];
+    double expected = expected_feature(series, (i * 7919) % num_rows, feature.lag, feature.window, feature.statistic);
+    REQUIRE(same_value(values[i], expected));
+  }
+}
+
+TEST_CASE("virtual columns of row ranges reach back before the range", "[data]") {
+  std::vector<double> data_vec = {1, 2, 3, 4, 5, 6, 0, 0, 0, 0, 0, 0};
+  Data data(data_vec, 6, 2);
+  data.set_outcome_index(1);
+  size_t lag_col = data.add_virtual_column(0, 2, 1, ROLLING_MEAN);
+  size_t mean_col = data.add_virtual_column(0, 0, 3, ROLLING_MEAN);
+
+  Data range = data.get_row_range(3, 6);
+  REQUIRE(range.get(0, lag_col) == 2);
+  REQUIRE(range.get(2, lag_col) == 4);
+  REQUIRE(range.get(0, mean_col) == 3);
+  REQUIRE(std::isnan(data.get(1, lag_col)));
+
+  REQUIRE_THROWS_AS(data.add_virtual_column(lag_col, 1, 1, ROLLING_MEAN), std::runtime_error);
+  REQUIRE_THROWS_AS(data.add_virtual_column(0, 0, 1, ROLLING_SD), std::runtime_error);
+}
+
+TEST_CASE("virtual columns of interleaved series lag within each series", "[data]") {
+  // [x, series]: two interleaved series 0 and 1.
+  std::vector<double> x = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<double> series = {0, 0, 1, 0, 1, 1, 0, 1};
+  std::vector<double> data_vec(x);
+  data_vec.insert(data_vec.end(), series.begin(), series.end());
+
+  // The series index can be set before or after the virtual columns are added.
+  for (bool series_first : {true, false}) {
+    Data data(data_vec, x.size(), 2);
+    if (series_first) {
+      data.set_series_index(1);
+    }
+    size_t lag_col = data.add_virtual_column(0, 1, 1, ROLLING_MEAN);
+    size_t mean_col = data.add_virtual_column(0, 0, 2, ROLLING_MEAN);
+    if (!series_first) {
+      data.set_series_index(1);
+    }
+
+    // Series 0 holds rows 0, 1, 3, 6 and series 1 holds rows 2, 4, 5, 7.
+    std::vector<double> expected_lags = {NAN, 1, NAN, 2, 3, 5, 4, 6};
+    std::vector<double> expected_means = {NAN, 1.5, NAN, 3, 4, 5.5, 5.5, 7};
+    for (size_t row = 0; row < x.size(); row++) {
+      double lag = data.get(row, lag_col);
+      double mean = data.get(row, mean_col);
+      REQUIRE((lag == expected_lags[row] || (std::isnan(lag) && std::isnan(expected_lags[row]))));
+      REQUIRE((mean == expected_means[row] || (std::isnan(mean) && std::isnan(expected_means[row]))));
+    }
+
+    Data range = data.get_row_range(4, 8);
+    REQUIRE(range.get(0, lag_col) == 3);
+    REQUIRE(range.get(2, lag_col) == 4);
+    REQUIRE_THROWS_AS(range.set_series_index(1), std::runtime_error);
+  }
+}
+
+TEST_CASE("forests on virtual columns match forests on materialized columns", "[data], [forest]") {
+  size_t num_rows = 500;
+  std::mt19937 gen(7);
+  std::normal_distribution<double> normal(0, 1);
+  std::vector<double> x(num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    x[row] = normal(gen);
+  }
+
+  // [x, y, lag(x, 1), rolling mean of x over 4 rows], with y depending on the lag.
+  std::vector<double> materialized(4 * num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    materialized[row] = x[row];
+    materialized[2 * num_rows + row] = expected_feature(x, row, 1, 1, ROLLING_MEAN);
+    materialized[3 * num_rows + row] = expected_feature(x, row, 0, 4, ROLLING_MEAN);
+    double lag = row > 0 ? x[row - 1] : 0;
+    materialized[num_rows + row] = lag + 0.1 * normal(gen);
+  }
+  std::vector<double> data_vec(materialized.begin(), materialized.begin() + 2 * num_rows);
+
+  Data full_data(materialized, num_rows, 4);
+  full_data.set_outcome_index(1);
+  Data virtual_data(data_vec, num_rows, 2);
+  virtual_data.set_outcome_index(1);
+  virtual_data.add_virtual_column(0, 1, 1, ROLLING_MEAN);
+  virtual_data.add_virtual_column(0, 0, 4, ROLLING_MEAN);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(1);
+  ForestOptions options(50, 1, 0.5, 3, 5, true, 0.5, true, 0.05, 0, 2, 42, std::vector<size_t>(), 0);
+
+  Forest full_forest = trainer.train(full_data, options);
+  Forest virtual_forest = trainer.train(virtual_data, options);
+  std::vector<Prediction> full_predictions = predictor.predict_oob(full_forest, full_data, false);
+  std::vector<Prediction> virtual_predictions = predictor.predict_oob(virtual_forest, virtual_data, false);
+
+  for (size_t row = 0; row < num_rows; row++) {
+    REQUIRE(same_value(full_predictions[row].get_predictions()[0], virtual_predictions[row].get_predictions()[0]));
+  }
+}
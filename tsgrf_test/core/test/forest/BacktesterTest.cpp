@@ -0,0 +1,114 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <stdexcept>
+
+#include "commons/utility.h"
+#include "forest/Backtester.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+// Copies rows [begin, end) of the column-major data into a new column-major array.
+static std::vector<double> copy_rows(const std::pair<std::vector<double>, std::vector<size_t>>& data_vec,
+                                     size_t begin, size_t end) {
+  size_t num_rows = data_vec.second[0];
+  size_t num_cols = data_vec.second[1];
+  std::vector<double> rows;
+  for (size_t col = 0; col < num_cols; col++) {
+    for (size_t row = begin; row < end; row++) {
+      rows.push_back(data_vec.first[col * num_rows + row]);
+    }
+  }
+  return rows;
+}
+
+TEST_CASE("row range views share the data of the full series", "[data]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  Data range = data.get_row_range(100, 150);
+  REQUIRE(range.get_num_rows() == 50);
+  REQUIRE(range.get_num_cols() == data.get_num_cols());
+  REQUIRE(range.get_disallowed_split_variables() == data.get_disallowed_split_variables());
+  for (size_t row = 0; row < 50; row++) {
+    REQUIRE(range.get(row, 3) == data.get(100 + row, 3));
+    REQUIRE(range.get_outcome(row) == data.get_outcome(100 + row));
+  }
+
+  REQUIRE_THROWS_AS(data.get_row_range(10, 501), std::runtime_error);
+}
+
+TEST_CASE("backtest folds match forests trained on the window alone", "[forest, backtest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(1);
+  Backtester backtester(trainer, predictor);
+  ForestOptions options(50, 1, 0.5, 3, 5, true, 0.5, true, 0.05, 0, 4, 42, std::vector<size_t>(), 0);
+
+  std::vector<std::pair<size_t, size_t>> origins = Backtester::rolling_origins(300, 50, 100, 500);
+  REQUIRE(origins.size() == 2);
+
+  std::vector<BacktestFold> expanding = backtester.backtest(data, origins, options, 0);
+  std::vector<BacktestFold> sliding = backtester.backtest(data, origins, options, 200);
+  REQUIRE(expanding.size() == 2);
+  REQUIRE(expanding[1].get_train_start() == 0);
+  REQUIRE(sliding[1].get_train_start() == 200);
+  REQUIRE(sliding[1].get_train_end() == 400);
+  REQUIRE(sliding[1].get_test_end() == 450);
+
+  for (const BacktestFold& fold : sliding) {
+    std::vector<double> train_vec = copy_rows(data_vec, fold.get_train_start(), fold.get_train_end());
+    std::vector<double> test_vec = copy_rows(data_vec, fold.get_train_end(), fold.get_test_end());
+    Data train_data(train_vec, fold.get_train_end() - fold.get_train_start(), 11);
+    train_data.set_outcome_index(10);
+    Data test_data(test_vec, fold.get_test_end() - fold.get_train_end(), 11);
+
+    Forest forest = trainer.train(train_data, options);
+    std::vector<Prediction> expected = predictor.predict(forest, train_data, test_data, false);
+
+    REQUIRE(fold.get_predictions().size() == 50);
+    for (size_t row = 0; row < expected.size(); row++) {
+      double prediction = fold.get_predictions()[row].get_predictions()[0];
+      REQUIRE(prediction == expected[row].get_predictions()[0]);
+      REQUIRE(fold.get_errors()[row] == test_data.get(row, 10) - prediction);
+    }
+  }
+}
+
+TEST_CASE("backtest rejects origins outside the series", "[forest, backtest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(1);
+  Backtester backtester(trainer, predictor);
+  ForestOptions options(50, 1, 0.5, 3, 5, true, 0.5, true, 0.05, 0, 1, 42, std::vector<size_t>(), 0);
+
+  std::vector<std::pair<size_t, size_t>> origins = {{450, 100}};
+  REQUIRE_THROWS_AS(backtester.backtest(data, origins, options, 0), std::runtime_error);
+  REQUIRE_THROWS_AS(Backtester::rolling_origins(100, 10, 0, 500), std::runtime_error);
+}
@@ -0,0 +1,160 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "commons/utility.h"
+#include "forest/CausalPipeline.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("the causal pipeline matches training the nuisance and causal forests in turn", "[causal, forest]") {
+  auto data_vec = load_data("test/forest/resources/causal_data.csv");
+  size_t num_rows = data_vec.second[0];
+  Data data(data_vec);
+
+  ForestTrainer nuisance_trainer = regression_trainer();
+  ForestPredictor nuisance_predictor = regression_predictor(4);
+  ForestTrainer trainer = instrumental_trainer(0, true);
+  ForestPredictor predictor = instrumental_predictor(4);
+
+  ForestOptions nuisance_options(50, 2, 0.5, 3, 5, true, 0.5, true, 0.05, 0, 4, 42,
+                                 std::vector<size_t>(), 0, 4, false, 1);
+  ForestOptions options(50, 2, 0.35, 3, 5, true, 0.5, true, 0.05, 0, 4, 42, std::vector<size_t>(), 0);
+
+  CausalPipeline pipeline(nuisance_trainer, nuisance_predictor, trainer, predictor);
+  std::vector<double> Y_hat;
+  std::vector<double> W_hat;
+  std::vector<Prediction> predictions;
+  Forest forest = pipeline.train(data, 10, 11, nuisance_options, options, true, Y_hat, W_hat, predictions);
+  REQUIRE(Y_hat.size() == num_rows);
+  REQUIRE(W_hat.size() == num_rows);
+  REQUIRE(predictions.size() == num_rows);
+  REQUIRE(forest.get_num_variables() == 10);
+
+  // The same chain, one forest at a time.
+  Data outcome_data(data);
+  outcome_data.set_treatment_index(11);
+  outcome_data.set_outcome_index(10);
+  Data treatment_data(outcome_data);
+  treatment_data.set_outcome_index(11);
+
+  Forest forest_Y = nuisance_trainer.train(outcome_data, nuisance_options);
+  std::vector<Prediction> predictions_Y = nuisance_predictor.predict_oob(forest_Y, outcome_data, false);
+  Forest forest_W = nuisance_trainer.train(treatment_data, nuisance_options);
+  std::vector<Prediction> predictions_W = nuisance_predictor.predict_oob(forest_W, treatment_data, false);
+
+  std::vector<double> centered_vec(data_vec.first.begin(), data_vec.first.begin() + 10 * num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    REQUIRE(Y_hat[row] == predictions_Y[row].get_predictions()[0]);
+    REQUIRE(W_hat[row] == predictions_W[row].get_predictions()[0]);
+  }
+  for (size_t row = 0; row < num_rows; row++) {
+    centered_vec.push_back(data.get(row, 10) - Y_hat[row]);
+  }
+  for (size_t row = 0; row < num_rows; row++) {
+    centered_vec.push_back(data.get(row, 11) - W_hat[row]);
+  }
+  Data centered_data(centered_vec, num_rows, 12);
+  centered_data.set_outcome_index(10);
+  centered_data.set_treatment_index(11);
+  centered_data.set_instrument_index(11);
+
+  Forest expected = trainer.train(centered_data, options);
+  std::vector<Prediction> expected_predictions = predictor.predict_oob(expected, centered_data, false);
+  for (size_t row = 0; row < num_rows; row++) {
+    REQUIRE(predictions[row].get_predictions()[0] == expected_predictions[row].get_predictions()[0]);
+  }
+}
+
+TEST_CASE("the causal pipeline reports progress and can be stopped in either stage", "[causal, forest]") {
+  auto data_vec = load_data("test/forest/resources/causal_data.csv");
+  size_t num_rows = data_vec.second[0];
+  Data data(data_vec);
+
+  ForestTrainer nuisance_trainer = regression_trainer();
+  ForestPredictor nuisance_predictor = regression_predictor(4);
+  ForestTrainer trainer = instrumental_trainer(0, true);
+  ForestPredictor predictor = instrumental_predictor(4);
+
+  ForestOptions nuisance_options(50, 2, 0.5, 3, 5, true, 0.5, true, 0.05, 0, 4, 42,
+                                 std::vector<size_t>(), 0, 4, false, 1);
+  ForestOptions options(50, 2, 0.35, 3, 5, true, 0.5, true, 0.05, 0, 4, 42, std::vector<size_t>(), 0);
+  CausalPipeline pipeline(nuisance_trainer, nuisance_predictor, trainer, predictor);
+
+  std::vector<double> Y_hat, W_hat;
+  std::vector<Prediction> predictions;
+  Forest expected = pipeline.train(data, 10, 11, nuisance_options, options, true, Y_hat, W_hat, predictions);
+
+  // A callback that never stops training does not change the forest.
+  std::vector<size_t> totals;
+  TrainingControl control;
+  control.set_progress_callback([&](size_t done, size_t total, double eta) {
+    totals.push_back(total);
+    return true;
+  }, 0.001);
+  std::vector<double> Y_hat_control, W_hat_control;
+  std::vector<Prediction> predictions_control;
+  Forest forest = pipeline.train(data, 10, 11, nuisance_options, options, true,
+                                 Y_hat_control, W_hat_control, predictions_control, control);
+  REQUIRE_FALSE(control.stopped_early());
+  REQUIRE(Y_hat_control == Y_hat);
+  REQUIRE(W_hat_control == W_hat);
+  REQUIRE(forest.get_trees().size() == expected.get_trees().size());
+  for (size_t row = 0; row < num_rows; row++) {
+    REQUIRE(predictions_control[row].get_predictions()[0] == predictions[row].get_predictions()[0]);
+  }
+  // Progress is reported for both nuisance forests, then for the causal forest.
+  REQUIRE(totals.front() == 100);
+  REQUIRE(totals.back() == 50);
+
+  // Stopping in the nuisance stage skips the causal forest.
+  TrainingControl nuisance_stop;
+  nuisance_stop.set_progress_callback([](size_t done, size_t total, double eta) { return false; }, 0.001);
+  Forest stopped = pipeline.train(data, 10, 11, nuisance_options, options, true,
+                                  Y_hat_control, W_hat_control, predictions_control, nuisance_stop);
+  REQUIRE(nuisance_stop.stopped_early());
+  REQUIRE(stopped.get_trees().empty());
+  REQUIRE(Y_hat_control.empty());
+
+  // Stopping in the causal stage keeps the nuisance estimates.
+  TrainingControl causal_stop;
+  causal_stop.set_progress_callback([](size_t done, size_t total, double eta) { return total != 1000; }, 0.001);
+  ForestOptions large_options(1000, 2, 0.35, 3, 5, true, 0.5, true, 0.05, 0, 4, 42, std::vector<size_t>(), 0);
+  Y_hat_control.clear();
+  Forest partial = pipeline.train(data, 10, 11, nuisance_options, large_options, false,
+                                  Y_hat_control, W_hat_control, predictions_control, causal_stop);
+  REQUIRE(causal_stop.stopped_early());
+  REQUIRE(Y_hat_control == Y_hat);
+  REQUIRE(partial.get_trees().size() < 1000);
+}
+
+TEST_CASE("external columns are read like columns of the data array", "[data]") {
+  std::vector<double> data_vec = {1, 2, 3, 4, 5, 6};
+  std::vector<double> column = {7, 8, 9};
+  Data data(data_vec, 3, 2);
+  size_t index = data.add_external_column(column.data());
+
+  REQUIRE(index == 2);
+  REQUIRE(data.get_num_cols() == 3);
+  for (size_t row = 0; row < 3; row++) {
+    REQUIRE(data.get(row, index) == column[row]);
+  }
+  REQUIRE_THROWS_AS(data.get_row_range(1, 3).add_external_column(column.data()), std::runtime_error);
+}
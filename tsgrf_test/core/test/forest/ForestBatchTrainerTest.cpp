@@ -0,0 +1,91 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+
+#include "commons/utility.h"
+#include "forest/ForestBatchTrainer.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+static ForestOptions batch_options(uint min_node_size) {
+  return ForestOptions(20, 1, 0.5, 3, min_node_size, true, 0.5, true, 0.05, 0,
+                       1, 42, std::vector<size_t>(), 0);
+}
+
+TEST_CASE("batched forests match forests trained on each row range", "[forest, batch]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(1);
+  ForestBatchTrainer batch_trainer(trainer);
+
+  std::vector<std::pair<size_t, size_t>> row_ranges = {{0, 100}, {100, 250}, {250, 500}, {50, 450}};
+  std::vector<ForestOptions> options;
+  options.push_back(batch_options(5));
+  options.push_back(batch_options(10));
+  options.push_back(batch_options(1));
+  options.push_back(batch_options(20));
+
+  std::vector<Forest> forests = batch_trainer.train(data, row_ranges, options, 4);
+  REQUIRE(forests.size() == row_ranges.size());
+
+  for (size_t i = 0; i < row_ranges.size(); i++) {
+    Data range = data.get_row_range(row_ranges[i].first, row_ranges[i].second);
+    Forest expected = trainer.train(range, options[i]);
+    REQUIRE(forests[i].get_trees().size() == expected.get_trees().size());
+
+    std::vector<Prediction> batch_predictions = predictor.predict_oob(forests[i], range, false);
+    std::vector<Prediction> expected_predictions = predictor.predict_oob(expected, range, false);
+    for (size_t row = 0; row < batch_predictions.size(); row++) {
+      REQUIRE(batch_predictions[row].get_predictions() == expected_predictions[row].get_predictions());
+    }
+  }
+}
+
+TEST_CASE("a batch of forests can share one set of options", "[forest, batch]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestBatchTrainer batch_trainer(trainer);
+
+  std::vector<std::pair<size_t, size_t>> row_ranges;
+  for (size_t begin = 0; begin < 500; begin += 50) {
+    row_ranges.emplace_back(begin, begin + 50);
+  }
+  std::vector<ForestOptions> options;
+  options.push_back(batch_options(5));
+
+  std::vector<Forest> forests = batch_trainer.train(data, row_ranges, options, 3);
+  REQUIRE(forests.size() == 10);
+  for (const Forest& forest : forests) {
+    REQUIRE(forest.get_trees().size() == 20);
+  }
+
+  REQUIRE_THROWS_AS(batch_trainer.train(data, {{10, 10}}, options, 1), std::runtime_error);
+  REQUIRE_THROWS_AS(batch_trainer.train(data, {{400, 501}}, options, 1), std::runtime_error);
+  options.push_back(batch_options(5));
+  REQUIRE_THROWS_AS(batch_trainer.train(data, row_ranges, options, 1), std::runtime_error);
+}
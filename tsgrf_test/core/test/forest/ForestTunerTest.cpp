@@ -0,0 +1,78 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+
+#include "commons/utility.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+#include "forest/ForestTuner.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+static ForestOptions tuning_options(double sample_fraction, uint min_node_size) {
+  return ForestOptions(50, 1, sample_fraction, 3, min_node_size, true, 0.5, true, 0.05, 0,
+                       1, 42, std::vector<size_t>(), 0);
+}
+
+TEST_CASE("forest tuner scores candidates like individually trained forests", "[forest, tuning]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(1);
+  ForestTuner tuner(trainer, predictor);
+
+  std::vector<ForestOptions> candidates;
+  candidates.push_back(tuning_options(0.5, 5));
+  candidates.push_back(tuning_options(0.3, 20));
+  candidates.push_back(tuning_options(0.8, 1));
+
+  std::vector<double> errors = tuner.compute_errors(data, candidates, 4);
+  REQUIRE(errors.size() == candidates.size());
+
+  for (size_t i = 0; i < candidates.size(); i++) {
+    Forest forest = trainer.train(data, candidates[i]);
+    std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+    double expected = ForestTuner::mean_debiased_error(predictions);
+    REQUIRE(std::isfinite(expected));
+    REQUIRE(errors[i] == expected);
+  }
+
+  REQUIRE(errors == tuner.compute_errors(data, candidates, 1));
+}
+
+TEST_CASE("forest tuner gives a missing error for inadmissible candidates", "[forest, tuning]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestPredictor predictor = regression_predictor(1);
+  ForestTuner tuner(trainer, predictor);
+
+  std::vector<ForestOptions> candidates;
+  candidates.push_back(tuning_options(0.5, 5));
+  candidates.push_back(tuning_options(1e-6, 5));
+
+  std::vector<double> errors = tuner.compute_errors(data, candidates, 2);
+  REQUIRE(std::isfinite(errors[0]));
+  REQUIRE(std::isnan(errors[1]));
+}
@@ -125,3 +125,63 @@ TEST_CASE("regression error estimates are shift invariant", "[regression, forest
 
   REQUIRE(equal_doubles(delta / predictions.size(), 0, 1e-1));
 }
+
+TEST_CASE("block regression forests grow confidence interval groups", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options(50, 2, 0.35, 3, 5, true, 0.5, true, 0.05, 0, 4, 42,
+                        std::vector<size_t>(), 0, 4, false, 2);
+  Forest forest = trainer.train(data, options);
+  REQUIRE(forest.get_trees().size() == 50);
+  REQUIRE(forest.get_ci_group_size() == 2);
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, true);
+  size_t num_variance_estimates = 0;
+  for (const Prediction& prediction : predictions) {
+    REQUIRE(prediction.contains_variance_estimates());
+    if (std::isfinite(prediction.get_variance_estimates()[0])) {
+      REQUIRE(prediction.get_variance_estimates()[0] >= 0);
+      num_variance_estimates++;
+    }
+  }
+  REQUIRE(num_variance_estimates > 0);
+
+  REQUIRE_THROWS_AS(ForestOptions(50, 2, 0.7, 3, 5, true, 0.5, true, 0.05, 0, 4, 42,
+                                  std::vector<size_t>(), 0, 4, false, 2), std::runtime_error);
+}
+
+TEST_CASE("extremely randomized regression forests are reproducible and accurate", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  ForestOptions options(50, 2, 0.5, 3, 5, false, 0.5, true, 0.05, 0, 4, 42,
+                        std::vector<size_t>(), 0, 4, false, 1);
+  ForestPredictor predictor = regression_predictor(4);
+
+  auto oob_mse = [&](const ForestTrainer& trainer, std::vector<double>& values) {
+    Forest forest = trainer.train(data, options);
+    std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+    double mse = 0;
+    for (size_t i = 0; i < predictions.size(); i++) {
+      double prediction = predictions[i].get_predictions()[0];
+      values.push_back(prediction);
+      mse += (prediction - data.get_outcome(i)) * (prediction - data.get_outcome(i));
+    }
+    return mse / predictions.size();
+  };
+
+  std::vector<double> exhaustive;
+  double exhaustive_mse = oob_mse(regression_trainer(), exhaustive);
+  std::vector<double> randomized;
+  double randomized_mse = oob_mse(regression_trainer(SplitValueOptions(5, 0, 0)), randomized);
+  std::vector<double> randomized_again;
+  oob_mse(regression_trainer(SplitValueOptions(5, 0, 0)), randomized_again);
+
+  REQUIRE(randomized == randomized_again);
+  REQUIRE(randomized != exhaustive);
+  REQUIRE(randomized_mse < 1.25 * exhaustive_mse);
+}
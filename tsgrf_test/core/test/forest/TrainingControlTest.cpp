@@ -0,0 +1,116 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+
+#include "commons/utility.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainer.h"
+#include "forest/ForestTrainers.h"
+#include "forest/TrainingControl.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("training without stopping grows all trees and reports progress", "[forest, control]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options();
+
+  size_t last_done = 0;
+  size_t last_total = 0;
+  TrainingControl control;
+  control.set_progress_callback([&](size_t done, size_t total, double eta) {
+    REQUIRE(done >= last_done);
+    last_done = done;
+    last_total = total;
+    return true;
+  }, 0.001);
+
+  Forest forest = trainer.train(data, options, control);
+
+  REQUIRE(forest.get_trees().size() == options.get_num_trees());
+  REQUIRE(last_done == options.get_num_trees());
+  REQUIRE(last_total == options.get_num_trees());
+  REQUIRE_FALSE(control.stopped_early());
+}
+
+TEST_CASE("a cancelled control returns an empty but valid forest", "[forest, control]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options();
+
+  TrainingControl control;
+  control.cancel();
+  Forest forest = trainer.train(data, options, control);
+
+  REQUIRE(forest.get_trees().empty());
+  REQUIRE(control.stopped_early());
+}
+
+TEST_CASE("stopping from the progress callback keeps the completed trees", "[forest, control]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options();
+  ForestOptions big_options(5000, 1, options.get_sample_fraction(), 3, 1, false, 0.5, true, 0, 0,
+                            4, 42, std::vector<size_t>(), 0);
+
+  TrainingControl control;
+  control.set_progress_callback([](size_t done, size_t total, double eta) {
+    return done < 20;
+  }, 0.001);
+  Forest forest = trainer.train(data, big_options, control);
+
+  size_t num_trees = forest.get_trees().size();
+  REQUIRE(num_trees >= 20);
+  REQUIRE(num_trees < 5000);
+  REQUIRE(num_trees == control.get_num_trees_done());
+  REQUIRE(control.stopped_early());
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  REQUIRE(predictions.size() == data.get_num_rows());
+}
+
+TEST_CASE("training stops once the time budget is exhausted", "[forest, control]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options(100000, 1, 0.5, 3, 1, false, 0.5, true, 0, 0,
+                        4, 42, std::vector<size_t>(), 0);
+
+  TrainingControl control;
+  control.set_time_budget(0.2);
+  Forest forest = trainer.train(data, options, control);
+
+  REQUIRE(forest.get_trees().size() < 100000);
+  REQUIRE(control.stopped_early());
+}
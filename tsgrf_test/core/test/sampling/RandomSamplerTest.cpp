@@ -242,3 +242,53 @@ TEST_CASE("sample multilevel 1", "[sampleMultilevel]") {
   }
   REQUIRE(actual_oob_subsampled_clusters == expected_oob_subsampled_clusters);
 }
+
+TEST_CASE("panel block sampling keeps blocks within a series", "[sampleSeriesBlocks]") {
+  // Two interleaved series of 400 and 100 rows: rows 0..199 alternate between them,
+  // the remaining 300 rows all belong to the first series.
+  size_t num_rows = 500;
+  std::vector<double> data_vec(num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    data_vec[row] = (row < 200 && row % 2 == 1) ? 7 : 3;
+  }
+  Data data(data_vec, num_rows, 1);
+  data.set_series_index(0);
+
+  const std::vector<std::vector<size_t>>& series = data.get_series_rows();
+  REQUIRE(series.size() == 2);
+  REQUIRE(series[0].size() == 400);
+  REQUIRE(series[1].size() == 100);
+  REQUIRE(data.get_disallowed_split_variables().count(0) == 1);
+
+  for (bool equal_allocation : {false, true}) {
+    SamplingOptions sampling_options(1, std::vector<size_t>(), equal_allocation);
+    RandomSampler sampler(42, sampling_options);
+
+    std::vector<size_t> samples;
+    std::vector<std::vector<size_t>> blocks;
+    sampler.sample_series_blocks(series, 0.5, samples, blocks, 2);
+
+    size_t rows_per_series[2] = {0, 0};
+    for (const auto& block : blocks) {
+      REQUIRE(!block.empty());
+      double id = data.get(block[0], 0);
+      for (size_t row : block) {
+        REQUIRE(data.get(row, 0) == id);
+      }
+      rows_per_series[id == 3 ? 0 : 1] += block.size();
+    }
+
+    if (equal_allocation) {
+      // Each series contributes about half of the 250 rows per series.
+      REQUIRE(absolute_difference(rows_per_series[0], rows_per_series[1]) <= 20);
+    } else {
+      REQUIRE(rows_per_series[0] > 2 * rows_per_series[1]);
+    }
+  }
+}
+
+TEST_CASE("a missing series ID is rejected", "[sampleSeriesBlocks]") {
+  std::vector<double> data_vec = {1, 1, NAN, 2};
+  Data data(data_vec, 4, 1);
+  REQUIRE_THROWS_AS(data.set_series_index(0), std::runtime_error);
+}
@@ -76,7 +76,8 @@ TEST_CASE("multi regression splitting with one outcome is identical to regressio
   auto reg_splitting_rule = std::unique_ptr<SplittingRule>(new RegressionSplittingRule(
       data.get_num_rows(),
       options.get_alpha(),
-      options.get_imbalance_penalty()));
+      options.get_imbalance_penalty(),
+      options.get_num_threads()));
   auto multi_reg_splitting_rule = std::unique_ptr<SplittingRule>(new MultiRegressionSplittingRule(
       data.get_num_rows(),
       options.get_alpha(),
@@ -104,7 +105,8 @@ TEST_CASE("multi regression splitting with one outcome on NaN data is identical
   auto reg_splitting_rule = std::unique_ptr<SplittingRule>(new RegressionSplittingRule(
       data.get_num_rows(),
       options.get_alpha(),
-      options.get_imbalance_penalty()));
+      options.get_imbalance_penalty(),
+      options.get_num_threads()));
   auto multi_reg_splitting_rule = std::unique_ptr<SplittingRule>(new MultiRegressionSplittingRule(
       data.get_num_rows(),
       options.get_alpha(),
@@ -0,0 +1,86 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <random>
+
+#include "splitting/ProbabilitySplittingRule.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+// Splits the root node on all features and returns the split variable, value and missing direction.
+static std::vector<double> split_root_node(const Data& data,
+                                           size_t num_features,
+                                           size_t num_classes) {
+  size_t size_node = data.get_num_rows();
+  ProbabilitySplittingRule splitting_rule(size_node, num_classes, 0.05, 0);
+
+  size_t node = 0;
+  Eigen::ArrayXXd responses_by_sample(size_node, 1);
+  std::vector<std::vector<size_t>> samples(1);
+  for (size_t sample = 0; sample < size_node; ++sample) {
+    samples[node].push_back(sample);
+    responses_by_sample(sample, 0) = data.get_outcome(sample);
+  }
+
+  std::vector<size_t> possible_split_vars;
+  for (size_t j = 0; j < num_features; j++) {
+    possible_split_vars.push_back(j);
+  }
+  std::vector<size_t> split_vars(1);
+  std::vector<double> split_values(1);
+  std::vector<bool> send_missing_left(1);
+
+  bool stop = splitting_rule.find_best_split(data, node, possible_split_vars, responses_by_sample, samples,
+                                             split_vars, split_values, send_missing_left);
+  REQUIRE_FALSE(stop);
+
+  return {(double) split_vars[0], split_values[0], (double) send_missing_left[0]};
+}
+
+TEST_CASE("probability splitting with a fixed number of classes agrees with the general case", "[probability], [splitting]") {
+  size_t num_rows = 1000;
+  size_t num_features = 4;
+  size_t num_classes = 4;
+  std::mt19937 gen(42);
+  std::normal_distribution<double> normal(0, 1);
+  std::uniform_int_distribution<int> noise(0, 9);
+
+  // Column-major [X, Y], with some missing values in the informative covariate.
+  std::vector<double> data_vec((num_features + 1) * num_rows);
+  for (size_t col = 0; col < num_features; col++) {
+    for (size_t row = 0; row < num_rows; row++) {
+      data_vec[col * num_rows + row] = (col == 2 && row % 9 == 0) ? NAN : normal(gen);
+    }
+  }
+  for (size_t row = 0; row < num_rows; row++) {
+    double x = data_vec[2 * num_rows + row];
+    size_t label = std::isnan(x) ? 3 : (x > 0.5 ? 2 : 0);
+    data_vec[num_features * num_rows + row] = noise(gen) == 0 ? 1 : label;
+  }
+  Data data(data_vec, num_rows, num_features + 1);
+  data.set_outcome_index(num_features);
+
+  // Unused classes do not change the split, but 12 classes take the runtime fallback.
+  std::vector<double> fixed = split_root_node(data, num_features, num_classes);
+  std::vector<double> fallback = split_root_node(data, num_features, 12);
+
+  REQUIRE(fixed[0] == 2);
+  REQUIRE(fixed == fallback);
+}
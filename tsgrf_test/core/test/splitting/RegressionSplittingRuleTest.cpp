@@ -0,0 +1,213 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <random>
+
+#include "splitting/RegressionSplittingRule.h"
+#include "splitting/SortedSamplesCache.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+// Splits the root node (all samples) on all features and returns the
+// best split variable, best split value, and missing direction.
+static std::vector<double> split_root_node(const Data& data,
+                                           size_t num_features,
+                                           uint num_threads,
+                                           const SplitValueOptions& split_value_options = SplitValueOptions()) {
+  RegressionSplittingRule splitting_rule(data.get_num_rows(), 0.05, 0, num_threads, split_value_options);
+
+  size_t node = 0;
+  size_t size_node = data.get_num_rows();
+  Eigen::ArrayXXd responses_by_sample(size_node, 1);
+  std::vector<std::vector<size_t>> samples(1);
+  for (size_t sample = 0; sample < size_node; ++sample) {
+    samples[node].push_back(sample);
+    responses_by_sample(sample, 0) = data.get_outcome(sample);
+  }
+
+  std::vector<size_t> possible_split_vars;
+  for (size_t j = 0; j < num_features; j++) {
+    possible_split_vars.push_back(j);
+  }
+  std::vector<size_t> split_vars(1);
+  std::vector<double> split_values(1);
+  std::vector<bool> send_missing_left(1);
+
+  bool stop = splitting_rule.find_best_split(data, node, possible_split_vars, responses_by_sample, samples,
+                                             split_vars, split_values, send_missing_left);
+  REQUIRE_FALSE(stop);
+
+  return {(double) split_vars[0], split_values[0], (double) send_missing_left[0]};
+}
+
+TEST_CASE("regression splitting of a large node does not depend on the number of threads", "[regression], [splitting]") {
+  size_t num_rows = 30000;
+  size_t num_features = 8;
+  std::mt19937 gen(42);
+  std::normal_distribution<double> normal(0, 1);
+  std::uniform_int_distribution<int> coarse(0, 20);
+
+  // Column-major [X, Y]: a mix of continuous, heavily tied and partially missing covariates.
+  std::vector<double> data_vec((num_features + 1) * num_rows);
+  for (size_t col = 0; col < num_features; col++) {
+    for (size_t row = 0; row < num_rows; row++) {
+      double value = col % 2 == 0 ? normal(gen) : coarse(gen);
+      if (col == 3 && row % 7 == 0) {
+        value = NAN;
+      }
+      data_vec[col * num_rows + row] = value;
+    }
+  }
+  for (size_t row = 0; row < num_rows; row++) {
+    double x = data_vec[5 * num_rows + row];
+    data_vec[num_features * num_rows + row] = (x > 12 ? 1.0 : 0.0) + normal(gen);
+  }
+  Data data(data_vec, num_rows, num_features + 1);
+  data.set_outcome_index(num_features);
+
+  std::vector<double> serial = split_root_node(data, num_features, 1);
+  std::vector<double> parallel = split_root_node(data, num_features, 4);
+  std::vector<double> oversubscribed = split_root_node(data, num_features, 16);
+
+  REQUIRE(serial[0] == 5);
+  REQUIRE(serial == parallel);
+  REQUIRE(serial == oversubscribed);
+
+  // Every value of the coarse covariate is among 256 quantiles, so the split stays the same.
+  SplitValueOptions quantiles(0, 256, 10000);
+  REQUIRE(split_root_node(data, num_features, 1, quantiles) == serial);
+  REQUIRE(split_root_node(data, num_features, 4, quantiles) == serial);
+}
+
+TEST_CASE("regression splitting with unit sample weights is identical to unweighted splitting", "[regression], [splitting]") {
+  size_t num_rows = 500;
+  size_t num_features = 4;
+  std::mt19937 gen(42);
+  std::normal_distribution<double> normal(0, 1);
+
+  // Column-major [X, Y, weights].
+  std::vector<double> data_vec((num_features + 2) * num_rows);
+  for (size_t i = 0; i < (num_features + 1) * num_rows; i++) {
+    data_vec[i] = normal(gen);
+  }
+  for (size_t row = 0; row < num_rows; row++) {
+    data_vec[num_features * num_rows + row] += data_vec[num_rows + row] > 0 ? 2 : 0;
+    data_vec[(num_features + 1) * num_rows + row] = 1.0;
+  }
+  Data data(data_vec, num_rows, num_features + 2);
+  data.set_outcome_index(num_features);
+  Data weighted_data(data_vec, num_rows, num_features + 2);
+  weighted_data.set_outcome_index(num_features);
+  weighted_data.set_weight_index(num_features + 1);
+
+  std::vector<double> unweighted = split_root_node(data, num_features, 1);
+  REQUIRE(unweighted[0] == 1);
+  REQUIRE(split_root_node(weighted_data, num_features, 1) == unweighted);
+}
+
+TEST_CASE("regression splitting with random split values requires a sampler", "[regression], [splitting]") {
+  SplitValueOptions random_thresholds(4, 0, 0);
+  REQUIRE_THROWS_AS(RegressionSplittingRule(100, 0.05, 0, 1, random_thresholds), std::runtime_error);
+
+  RandomSampler sampler(42, SamplingOptions());
+  RegressionSplittingRule splitting_rule(100, 0.05, 0, 1, random_thresholds, &sampler);
+}
+
+TEST_CASE("regression splitting of sparse columns from their nonzeros matches dense columns", "[regression], [splitting]") {
+  size_t num_rows = 2000;
+  size_t num_features = 3;
+  std::mt19937 gen(7);
+  std::normal_distribution<double> normal(0, 1);
+  std::uniform_real_distribution<double> uniform(0, 1);
+
+  // Column-major [X, Y]: mostly zero covariates with negative and positive values, and
+  // missing values in the last one. The outcome depends on the sign of the first.
+  std::vector<double> dense((num_features + 1) * num_rows);
+  for (size_t col = 0; col < num_features; col++) {
+    for (size_t row = 0; row < num_rows; row++) {
+      double u = uniform(gen);
+      double value = u < 0.7 ? 0 : std::round(normal(gen) * 4) / 4;
+      if (col == 2 && u > 0.97) {
+        value = NAN;
+      }
+      dense[col * num_rows + row] = value;
+    }
+  }
+  for (size_t row = 0; row < num_rows; row++) {
+    dense[num_features * num_rows + row] = (dense[row] > 0 ? 3.0 : 0.0) + normal(gen);
+  }
+  Data data(dense, num_rows, num_features + 1);
+  data.set_outcome_index(num_features);
+
+  std::vector<int> column_starts = {0};
+  std::vector<int> row_indices;
+  std::vector<double> values;
+  for (size_t col = 0; col < num_features; col++) {
+    for (size_t row = 0; row < num_rows; row++) {
+      double value = dense[col * num_rows + row];
+      if (value != 0) {
+        row_indices.push_back(static_cast<int>(row));
+        values.push_back(value);
+      }
+    }
+    column_starts.push_back(static_cast<int>(values.size()));
+  }
+  Data sparse_data(std::vector<const double*>(), num_rows);
+  sparse_data.add_sparse_columns(column_starts.data(), row_indices.data(), values.data(), num_features);
+  sparse_data.set_outcome_index(sparse_data.add_external_column(dense.data() + num_features * num_rows));
+
+  Eigen::ArrayXXd responses_by_sample(num_rows, 1);
+  for (size_t row = 0; row < num_rows; row++) {
+    responses_by_sample(row, 0) = data.get_outcome(row);
+  }
+  std::vector<size_t> possible_split_vars = {0, 1, 2};
+  SortedSamplesCache cache(num_rows);
+
+  // Nodes of a few rows drawn with replacement, as overlapping blocks draw some rows twice.
+  std::uniform_int_distribution<size_t> row_dist(0, num_rows - 1);
+  for (size_t node = 0; node < 4; node++) {
+    std::vector<std::vector<size_t>> samples(node + 1);
+    for (size_t i = 0; i < 1500; i++) {
+      samples[node].push_back(row_dist(gen));
+    }
+    std::vector<size_t> split_vars(node + 1), sparse_split_vars(node + 1);
+    std::vector<double> split_values(node + 1), sparse_split_values(node + 1);
+    std::vector<bool> send_missing_left(node + 1), sparse_send_missing_left(node + 1);
+
+    RegressionSplittingRule splitting_rule(samples[node].size(), 0.05, 0, 1);
+    bool stop = splitting_rule.find_best_split(data, node, possible_split_vars, responses_by_sample, samples,
+                                               split_vars, split_values, send_missing_left);
+
+    RegressionSplittingRule sparse_splitting_rule(samples[node].size(), 0.05, 0, 1);
+    sparse_splitting_rule.set_sorted_samples_cache(&cache);
+    cache.begin_node(node, samples[node], possible_split_vars);
+    bool sparse_stop = sparse_splitting_rule.find_best_split(sparse_data, node, possible_split_vars,
+                                                             responses_by_sample, samples, sparse_split_vars,
+                                                             sparse_split_values, sparse_send_missing_left);
+    cache.end_node();
+
+    REQUIRE_FALSE(stop);
+    REQUIRE(sparse_stop == stop);
+    REQUIRE(split_vars[node] == 0);
+    REQUIRE(sparse_split_vars[node] == split_vars[node]);
+    REQUIRE(sparse_split_values[node] == split_values[node]);
+    REQUIRE(sparse_send_missing_left[node] == send_missing_left[node]);
+  }
+}
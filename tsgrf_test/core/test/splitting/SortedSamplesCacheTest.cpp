@@ -0,0 +1,237 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "splitting/SortedSamplesCache.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+// Checks that the cache sorts the samples of the node being searched like Data#get_all_values.
+static void check_sorted_values(const Data& data,
+                                SortedSamplesCache& cache,
+                                const std::vector<size_t>& samples,
+                                size_t var) {
+  std::vector<double> all_values, expected_values;
+  std::vector<size_t> sorted_samples, expected_sorted_samples;
+  std::vector<size_t> index = cache.get_all_values(data, all_values, sorted_samples, samples, var);
+  std::vector<size_t> expected_index = data.get_all_values(expected_values, expected_sorted_samples, samples, var);
+
+  REQUIRE(sorted_samples == expected_sorted_samples);
+  REQUIRE(index == expected_index);
+  REQUIRE(all_values.size() == expected_values.size());
+  for (size_t i = 0; i < all_values.size(); i++) {
+    REQUIRE((all_values[i] == expected_values[i] || (std::isnan(all_values[i]) && std::isnan(expected_values[i]))));
+  }
+}
+
+TEST_CASE("sorted samples derived from the parent are the same as sorting the child", "[splitting]") {
+  size_t num_rows = 2000;
+  std::mt19937 gen(42);
+  std::normal_distribution<double> normal(0, 1);
+  std::uniform_int_distribution<int> coarse(0, 9);
+
+  // Column-major: a heavily tied covariate with missing values, a continuous one, and the split variable.
+  std::vector<double> data_vec(3 * num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    data_vec[row] = row % 11 == 0 ? NAN : coarse(gen);
+    data_vec[num_rows + row] = normal(gen);
+    data_vec[2 * num_rows + row] = coarse(gen);
+  }
+  Data data(data_vec, num_rows, 3);
+
+  // The root holds a shuffled subset of the rows, so that ties are broken by sample order.
+  std::vector<size_t> root;
+  for (size_t row = 0; row < num_rows; row += 2) {
+    root.push_back(row);
+  }
+  std::shuffle(root.begin(), root.end(), gen);
+
+  // Splits a node on the last column, keeping the order of its samples like the trainer.
+  auto split = [&](const std::vector<size_t>& samples, double value,
+                   std::vector<size_t>& left, std::vector<size_t>& right) {
+    for (size_t sample : samples) {
+      if (data.get(sample, 2) <= value) {
+        left.push_back(sample);
+      } else {
+        right.push_back(sample);
+      }
+    }
+  };
+
+  SortedSamplesCache cache(num_rows);
+  cache.begin_node(0, root, {0, 1});
+  check_sorted_values(data, cache, root, 0);
+  check_sorted_values(data, cache, root, 1);
+  cache.end_node();
+  cache.keep_for_children(1, 2);
+
+  std::vector<size_t> left, right;
+  split(root, 4, left, right);
+
+  // The children reuse the orders of the variables the root sorted, and sort the others.
+  cache.begin_node(1, left, {0, 2});
+  check_sorted_values(data, cache, left, 0);
+  check_sorted_values(data, cache, left, 2);
+  cache.end_node();
+  cache.keep_for_children(3, 4);
+
+  cache.begin_node(2, right, {1, 0});
+  check_sorted_values(data, cache, right, 1);
+  check_sorted_values(data, cache, right, 0);
+  cache.end_node();
+  cache.keep_for_children(5, 6);
+
+  std::vector<size_t> left_left, left_right, right_left, right_right;
+  split(left, 1, left_left, left_right);
+  split(right, 7, right_left, right_right);
+
+  cache.begin_node(3, left_left, {0, 2});
+  check_sorted_values(data, cache, left_left, 0);
+  check_sorted_values(data, cache, left_left, 2);
+  cache.end_node();
+
+  cache.begin_node(4, left_right, {2});
+  check_sorted_values(data, cache, left_right, 2);
+  cache.end_node();
+
+  cache.begin_node(6, right_right, {0, 1});
+  check_sorted_values(data, cache, right_right, 0);
+  check_sorted_values(data, cache, right_right, 1);
+  // Samples other than the node's, and variables it does not search, are sorted directly.
+  check_sorted_values(data, cache, left, 0);
+  check_sorted_values(data, cache, right_right, 2);
+  cache.end_node();
+}
+
+TEST_CASE("sorted samples cache keeps orders within its budget", "[splitting]") {
+  size_t num_rows = 1000;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> coarse(0, 9);
+
+  std::vector<double> data_vec(3 * num_rows);
+  for (size_t i = 0; i < data_vec.size(); i++) {
+    data_vec[i] = coarse(gen);
+  }
+  Data data(data_vec, num_rows, 3);
+
+  std::vector<size_t> root(num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    root[row] = row;
+  }
+  std::shuffle(root.begin(), root.end(), gen);
+  std::vector<size_t> left, right;
+  for (size_t sample : root) {
+    (data.get(sample, 2) <= 4 ? left : right).push_back(sample);
+  }
+
+  for (size_t max_cached_samples : {0, 1500, 2500}) {
+    SortedSamplesCache cache(num_rows, max_cached_samples);
+    cache.begin_node(0, root, {0, 1, 2});
+    check_sorted_values(data, cache, root, 0);
+    check_sorted_values(data, cache, root, 1);
+    check_sorted_values(data, cache, root, 2);
+    // Only the orders that fit in the budget are kept.
+    REQUIRE(cache.get_num_cached_samples() == max_cached_samples / num_rows * num_rows);
+    cache.end_node();
+    cache.keep_for_children(1, 2);
+
+    // The children sort again the variables whose orders were dropped.
+    cache.begin_node(1, left, {0, 1, 2});
+    check_sorted_values(data, cache, left, 0);
+    check_sorted_values(data, cache, left, 1);
+    check_sorted_values(data, cache, left, 2);
+    REQUIRE(cache.get_num_cached_samples() <= max_cached_samples);
+    cache.end_node();
+    cache.keep_for_children(3, 4);
+
+    cache.begin_node(2, right, {2, 1, 0});
+    check_sorted_values(data, cache, right, 2);
+    check_sorted_values(data, cache, right, 1);
+    check_sorted_values(data, cache, right, 0);
+    REQUIRE(cache.get_num_cached_samples() <= max_cached_samples);
+    cache.end_node();
+
+    // The root's orders are released once both children are searched.
+    cache.begin_node(3, left, {0});
+    REQUIRE(cache.get_num_cached_samples() <= left.size() * 3);
+    cache.end_node();
+  }
+}
+
+TEST_CASE("sorted samples cache reads sparse columns from their nonzeros", "[splitting]") {
+  size_t num_rows = 1000;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> coarse(-3, 3);
+  std::uniform_int_distribution<int> nonzero(0, 19);
+
+  // Two sparse columns in CSC form, the second with missing values.
+  std::vector<int> column_starts = {0};
+  std::vector<int> row_indices;
+  std::vector<double> values;
+  for (size_t col = 0; col < 2; col++) {
+    for (size_t row = 0; row < num_rows; row++) {
+      if (nonzero(gen) == 0) {
+        row_indices.push_back(static_cast<int>(row));
+        values.push_back(col == 1 && row % 3 == 0 ? NAN : coarse(gen));
+      }
+    }
+    column_starts.push_back(static_cast<int>(row_indices.size()));
+  }
+  Data full_data(std::vector<const double*>(), num_rows);
+  full_data.add_sparse_columns(column_starts.data(), row_indices.data(), values.data(), 2);
+  Data data = full_data.get_row_range(100, 900);
+  size_t num_range_rows = data.get_num_rows();
+
+  // Overlapping blocks can draw a sample more than once.
+  std::vector<size_t> samples;
+  for (size_t row = 0; row < num_range_rows; row += 2) {
+    samples.push_back(row);
+    if (row % 10 == 0) {
+      samples.push_back(row);
+    }
+  }
+  std::shuffle(samples.begin(), samples.end(), gen);
+  SortedSamplesCache duplicates_cache(num_range_rows);
+  duplicates_cache.begin_node(0, samples, {0});
+  check_sorted_values(data, duplicates_cache, samples, 0);
+  check_sorted_values(data, duplicates_cache, samples, 1);
+  duplicates_cache.end_node();
+
+  // A child filters the parent's order with the values read from the nonzeros.
+  std::vector<size_t> root;
+  for (size_t row = 0; row < num_range_rows; row++) {
+    root.push_back(row);
+  }
+  std::shuffle(root.begin(), root.end(), gen);
+  SortedSamplesCache cache(num_range_rows);
+  cache.begin_node(0, root, {0, 1});
+  check_sorted_values(data, cache, root, 0);
+  check_sorted_values(data, cache, root, 1);
+  cache.end_node();
+  cache.keep_for_children(1, 2);
+
+  std::vector<size_t> left(root.begin(), root.begin() + 200);
+  cache.begin_node(1, left, {0, 1});
+  check_sorted_values(data, cache, left, 0);
+  check_sorted_values(data, cache, left, 1);
+  cache.end_node();
+}
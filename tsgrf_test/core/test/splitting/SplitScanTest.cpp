@@ -0,0 +1,95 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <random>
+
+#include "splitting/SplitScan.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+static void fill_candidates(SplitScan& scan, size_t num_candidates, std::mt19937& gen, bool ties) {
+  std::uniform_real_distribution<double> uniform(0, 1);
+  std::uniform_int_distribution<int> coarse(1, 3);
+  scan.clear();
+  double sum_left = 0;
+  double weight_sum_left = 0;
+  for (size_t i = 0; i < num_candidates; i++) {
+    // With ties, many splits have exactly the same decrease.
+    sum_left += ties ? coarse(gen) : uniform(gen) - 0.3;
+    weight_sum_left += ties ? 1 : uniform(gen);
+    scan.add(2 * i + 1, sum_left, weight_sum_left, i + 1, num_candidates + 1 - i);
+  }
+}
+
+TEST_CASE("split scan kernels agree with the scalar loop", "[splitting]") {
+  std::mt19937 gen(42);
+  std::vector<SplitScanKernel> kernels = {SCAN_AVX2, SCAN_AVX512};
+  size_t max_num_candidates = 40;
+  SplitScan scan(max_num_candidates);
+
+  for (size_t num_candidates = 0; num_candidates <= max_num_candidates; num_candidates++) {
+    for (bool ties : {false, true}) {
+      fill_candidates(scan, num_candidates, gen, ties);
+      double sum_node = ties ? 0 : 2.5;
+      double weight_sum_node = ties ? num_candidates + 1 : num_candidates;
+
+      for (double imbalance_penalty : {0.0, 0.7}) {
+        for (double initial_decrease : {0.0, 1.5}) {
+          double expected_decrease = initial_decrease;
+          size_t expected_split = 0;
+          bool expected_found = scan.find_best(sum_node, weight_sum_node, imbalance_penalty,
+                                               expected_decrease, expected_split, SCAN_SCALAR);
+
+          for (SplitScanKernel kernel : kernels) {
+            if (!SplitScan::is_supported(kernel)) {
+              continue;
+            }
+            double decrease = initial_decrease;
+            size_t split = 0;
+            bool found = scan.find_best(sum_node, weight_sum_node, imbalance_penalty, decrease, split, kernel);
+            REQUIRE(found == expected_found);
+            REQUIRE(split == expected_split);
+            REQUIRE(decrease == expected_decrease);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("split scan keeps the first of equally good splits", "[splitting]") {
+  SplitScan scan(20);
+  for (size_t i = 0; i < 20; i++) {
+    // The decrease is 8 for the 2nd and 14th candidates, and smaller otherwise.
+    double sum_left = (i == 1 || i == 13) ? 2 : 0;
+    scan.add(i, sum_left, 1, 1, 1);
+  }
+
+  std::vector<SplitScanKernel> kernels = {SCAN_SCALAR, SCAN_AVX2, SCAN_AVX512};
+  for (SplitScanKernel kernel : kernels) {
+    if (!SplitScan::is_supported(kernel)) {
+      continue;
+    }
+    double decrease = 0;
+    size_t split = 0;
+    REQUIRE(scan.find_best(0, 2, 0, decrease, split, kernel));
+    REQUIRE(split == 1);
+    REQUIRE(decrease == 8);
+  }
+}
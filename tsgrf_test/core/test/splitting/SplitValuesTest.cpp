@@ -0,0 +1,171 @@
+/*-------------------------------------------------------------------------------
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <numeric>
+
+#include <random>
+
+#include "splitting/SortedSamplesCache.h"
+#include "splitting/SplitValues.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("random split values bucket every sample below its split value", "[splitting]") {
+  std::vector<double> values = {3.0, NAN, -1.0, 2.5, 7.0, NAN, 0.0, 7.0, 4.2, -1.0};
+  Data data(values, values.size(), 1);
+  std::vector<size_t> samples = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  RandomSampler sampler(42, SamplingOptions());
+
+  std::vector<double> split_values;
+  std::vector<size_t> buckets;
+  draw_random_split_values(data, samples, 0, 4, sampler, split_values, buckets);
+
+  // A leading NaN for the missing values, then the thresholds, then the largest value.
+  REQUIRE(split_values.size() >= 3);
+  REQUIRE(split_values.size() <= 6);
+  REQUIRE(std::isnan(split_values[0]));
+  REQUIRE(split_values.back() == 7.0);
+  for (size_t i = 1; i < split_values.size() - 1; i++) {
+    REQUIRE(split_values[i] >= -1.0);
+    REQUIRE(split_values[i] < 7.0);
+    REQUIRE(split_values[i] < split_values[i + 1]);
+  }
+
+  REQUIRE(buckets.size() == samples.size());
+  for (size_t i = 0; i < samples.size(); i++) {
+    if (std::isnan(values[i])) {
+      REQUIRE(buckets[i] == MISSING_BUCKET);
+      continue;
+    }
+    REQUIRE(buckets[i] >= 1);
+    REQUIRE(values[i] <= split_values[buckets[i]]);
+    if (buckets[i] > 1) {
+      REQUIRE(values[i] > split_values[buckets[i] - 1]);
+    }
+  }
+}
+
+TEST_CASE("random split values of a constant variable only split off missing values", "[splitting]") {
+  std::vector<double> values = {1.0, 1.0, NAN, 1.0};
+  Data data(values, values.size(), 1);
+  std::vector<size_t> samples = {0, 1, 2, 3};
+  RandomSampler sampler(42, SamplingOptions());
+
+  std::vector<double> split_values;
+  std::vector<size_t> buckets;
+  draw_random_split_values(data, samples, 0, 4, sampler, split_values, buckets);
+  REQUIRE(split_values.size() == 2);
+  REQUIRE(std::isnan(split_values[0]));
+  REQUIRE(split_values[1] == 1.0);
+  REQUIRE(buckets == std::vector<size_t>({1, 1, MISSING_BUCKET, 1}));
+
+  std::vector<size_t> observed = {0, 1, 3};
+  draw_random_split_values(data, observed, 0, 4, sampler, split_values, buckets);
+  REQUIRE(split_values == std::vector<double>({1.0}));
+}
+
+TEST_CASE("quantile split values divide the node evenly", "[splitting]") {
+  size_t num_rows = 1000;
+  std::mt19937 gen(42);
+  std::normal_distribution<double> normal(0, 1);
+  std::vector<double> values(num_rows);
+  for (double& value : values) {
+    value = normal(gen);
+  }
+  Data data(values, num_rows, 1);
+  std::vector<size_t> samples(num_rows);
+  std::iota(samples.begin(), samples.end(), 0);
+
+  std::vector<double> split_values;
+  std::vector<size_t> buckets;
+  get_quantile_split_values(data, samples, 0, 9, split_values, buckets);
+
+  REQUIRE(split_values.size() == 10);
+  REQUIRE(split_values.back() == *std::max_element(values.begin(), values.end()));
+  std::vector<size_t> bucket_sizes(split_values.size());
+  for (size_t i = 0; i < num_rows; i++) {
+    REQUIRE(values[i] <= split_values[buckets[i]]);
+    if (buckets[i] > 0) {
+      REQUIRE(values[i] > split_values[buckets[i] - 1]);
+    }
+    bucket_sizes[buckets[i]]++;
+  }
+  for (size_t bucket_size : bucket_sizes) {
+    REQUIRE(bucket_size == 100);
+  }
+}
+
+TEST_CASE("quantile split values include every value of a coarse variable", "[splitting]") {
+  std::vector<double> values = {2, NAN, 1, 3, 2, 5, 1, 3, NAN, 5, 2, 4};
+  Data data(values, values.size(), 1);
+  std::vector<size_t> samples(values.size());
+  std::iota(samples.begin(), samples.end(), 0);
+
+  std::vector<double> split_values;
+  std::vector<size_t> sorted_samples;
+  std::vector<size_t> buckets;
+  SplitValueOptions options(0, 256, 10);
+  REQUIRE(get_split_values(data, samples, 0, options, nullptr, nullptr, split_values, sorted_samples, buckets));
+
+  std::vector<double> all_values;
+  data.get_all_values(all_values, sorted_samples, samples, 0);
+  REQUIRE(split_values.size() == all_values.size());
+  REQUIRE(std::isnan(split_values[0]));
+  for (size_t i = 1; i < split_values.size(); i++) {
+    REQUIRE(split_values[i] == all_values[i]);
+  }
+
+  // Below the minimum node size every distinct value is a candidate.
+  std::vector<size_t> small_node = {0, 2, 3};
+  REQUIRE_FALSE(get_split_values(data, small_node, 0, options, nullptr, nullptr, split_values, sorted_samples, buckets));
+  REQUIRE(split_values == std::vector<double>({1, 2, 3}));
+}
+
+TEST_CASE("sparse split values bucket the nonzeros of the node", "[splitting]") {
+  // One sparse column over 10 rows: -1.5 at row 1, NaN at row 4, 2 at rows 6 and 8, 0.5 at row 9.
+  std::vector<int> column_starts = {0, 5};
+  std::vector<int> rows = {1, 4, 6, 8, 9};
+  std::vector<double> values = {-1.5, NAN, 2, 2, 0.5};
+  Data data(std::vector<const double*>(), 10);
+  data.add_sparse_columns(column_starts.data(), rows.data(), values.data(), 1);
+
+  // Rows 6 and 0 are drawn twice, and rows 4 and 9 are not in the node.
+  std::vector<size_t> samples = {6, 0, 1, 8, 6, 3, 0};
+  SortedSamplesCache cache(10);
+  cache.begin_node(0, samples, {0});
+
+  std::vector<double> split_values;
+  std::vector<size_t> nonzero_samples;
+  std::vector<size_t> buckets;
+  size_t zero_bucket;
+  SplitValueOptions options;
+  REQUIRE(get_sparse_split_values(data, samples, 0, options, &cache, split_values, nonzero_samples, buckets,
+                                  zero_bucket));
+  REQUIRE(split_values == std::vector<double>({-1.5, 0, 2}));
+  REQUIRE(zero_bucket == 1);
+  REQUIRE(nonzero_samples == std::vector<size_t>({1, 6, 6, 8}));
+  REQUIRE(buckets == std::vector<size_t>({0, 2, 2, 2}));
+
+  // Sample sets other than the node being searched fall back to reading every sample.
+  std::vector<size_t> other = samples;
+  REQUIRE_FALSE(get_sparse_split_values(data, other, 0, options, &cache, split_values, nonzero_samples, buckets,
+                                        zero_bucket));
+  cache.end_node();
+}
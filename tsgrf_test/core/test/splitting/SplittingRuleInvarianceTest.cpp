@@ -39,7 +39,8 @@ void run_one_split(const Data& data,
                    size_t num_features,
                    size_t& split_var,
                    double& split_value) {
-  std::unique_ptr<SplittingRule> splitting_rule = splitting_rule_factory->create(data.get_num_rows(), options);
+  RandomSampler sampler(42, SamplingOptions());
+  std::unique_ptr<SplittingRule> splitting_rule = splitting_rule_factory->create(data.get_num_rows(), options, sampler);
   std::vector<size_t> possible_split_vars(num_features - 1);
   // Fill with {0, 1, 2, ..., Xj}
   std::iota(possible_split_vars.begin(), possible_split_vars.end(), 0);
@@ -91,6 +92,8 @@ TEST_CASE("regression splitting on Xij then setting all values to the left to Na
     }
   }
 
+  // The storage changed, so rescan the columns for NaN.
+  data.refresh_nan_flags();
   run_one_split(data, options, splitting_rule_factory, relabeling_strategy, num_features, split_var_nan, split_val_nan);
   REQUIRE(split_var == split_var_nan);
   REQUIRE(split_val == split_val_nan);
@@ -122,6 +125,8 @@ TEST_CASE("instrumental splitting on Xij then setting all values to the left to
     }
   }
 
+  // The storage changed, so rescan the columns for NaN.
+  data.refresh_nan_flags();
   run_one_split(data, options, splitting_rule_factory, relabeling_strategy, num_features, split_var_nan, split_val_nan);
   REQUIRE(split_var == split_var_nan);
   REQUIRE(split_val == split_val_nan);
@@ -152,6 +157,8 @@ TEST_CASE("probability splitting on Xij then setting all values to the left to N
     }
   }
 
+  // The storage changed, so rescan the columns for NaN.
+  data.refresh_nan_flags();
   run_one_split(data, options, splitting_rule_factory, relabeling_strategy, num_features, split_var_nan, split_val_nan);
   REQUIRE(split_var == split_var_nan);
   REQUIRE(split_val == split_val_nan);
@@ -181,6 +188,8 @@ TEST_CASE("survival splitting on Xij then setting all values to the left to NaN
     }
   }
 
+  // The storage changed, so rescan the columns for NaN.
+  data.refresh_nan_flags();
   run_one_split(data, options, splitting_rule_factory, relabeling_strategy, num_features, split_var_nan, split_val_nan);
   REQUIRE(split_var == split_var_nan);
   REQUIRE(split_val == split_val_nan);
@@ -213,6 +222,8 @@ TEST_CASE("causal survival splitting on Xij then setting all values to the left
     }
   }
 
+  // The storage changed, so rescan the columns for NaN.
+  data.refresh_nan_flags();
   run_one_split(data, options, splitting_rule_factory, relabeling_strategy, num_features, split_var_nan, split_val_nan);
   REQUIRE(split_var == split_var_nan);
   REQUIRE(split_val == split_val_nan);
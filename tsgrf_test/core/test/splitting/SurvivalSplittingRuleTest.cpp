@@ -15,6 +15,10 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+
 #include "splitting/SurvivalSplittingRule.h"
 #include "relabeling/NoopRelabelingStrategy.h"
 
@@ -88,3 +92,213 @@ TEST_CASE("survival splitting logrank calculation is correct", "[survival], [spl
     REQUIRE(equal_doubles(logrank, expected_logrank, 1e-6));
   }
 }
+
+// The logrank statistic of the samples in `left`, computed directly from its definition
+// as a sum over the failure times of the node at which at least two samples are at risk.
+double direct_logrank(const std::vector<double>& times,
+                      const std::vector<bool>& failures,
+                      const std::vector<size_t>& left) {
+  std::vector<double> failure_times;
+  for (size_t sample = 0; sample < times.size(); sample++) {
+    if (failures[sample]) {
+      failure_times.push_back(times[sample]);
+    }
+  }
+  std::sort(failure_times.begin(), failure_times.end());
+  failure_times.erase(std::unique(failure_times.begin(), failure_times.end()), failure_times.end());
+
+  double numerator = 0;
+  double denominator = 0;
+  for (double time : failure_times) {
+    double Yk = 0, dk = 0, Ykl = 0, dkl = 0;
+    for (size_t sample = 0; sample < times.size(); sample++) {
+      Yk += times[sample] >= time;
+      dk += failures[sample] && times[sample] == time;
+    }
+    for (size_t sample : left) {
+      Ykl += times[sample] >= time;
+      dkl += failures[sample] && times[sample] == time;
+    }
+    if (Yk < 2) {
+      continue;
+    }
+    numerator += dkl - Ykl * dk / Yk;
+    denominator += Ykl / Yk * (1 - Ykl / Yk) * (Yk - dk) / (Yk - 1) * dk;
+  }
+
+  return denominator > 0 ? numerator * numerator / denominator : 0;
+}
+
+// Moves the samples of a node into the left child in random order, and checks the statistic
+// after each one while the right child still has a failure.
+void check_logrank_statistic(const std::vector<size_t>& times,
+                             const std::vector<bool>& failures,
+                             std::mt19937& gen) {
+  size_t num_failures = *std::max_element(times.begin(), times.end());
+  std::vector<double> count_failure(num_failures + 1);
+  std::vector<double> at_risk(num_failures + 1);
+  for (size_t sample = 0; sample < times.size(); sample++) {
+    count_failure[times[sample]] += failures[sample];
+    for (size_t time = 0; time <= times[sample]; time++) {
+      at_risk[time]++;
+    }
+  }
+
+  std::vector<size_t> order(times.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), gen);
+
+  std::vector<double> double_times(times.begin(), times.end());
+  SurvivalSplittingRule::LogrankStatistic logrank(count_failure, at_risk);
+  for (size_t pass = 0; pass < 2; pass++) {
+    logrank.clear();
+    std::vector<size_t> left;
+    size_t num_failures_right = std::count(failures.begin(), failures.end(), true);
+    for (size_t sample : order) {
+      logrank.add(times[sample], failures[sample]);
+      left.push_back(sample);
+      num_failures_right -= failures[sample];
+      if (num_failures_right == 0) {
+        break;
+      }
+      double expected = direct_logrank(double_times, failures, left);
+      REQUIRE(equal_doubles(logrank.compute(), expected, 1e-9 * (1 + expected)));
+    }
+    std::reverse(order.begin(), order.end());
+  }
+}
+
+TEST_CASE("survival logrank statistic matches a direct evaluation", "[survival], [splitting]") {
+  std::mt19937 gen(42);
+
+  // Censoring at time 0 (before the first failure), tied failures at times 1 and 3, and a
+  // single sample at the last time, which is beyond the last time with two samples at risk.
+  std::vector<size_t> times = {0, 0, 1, 1, 1, 1, 2, 3, 3, 3, 4, 4, 5};
+  std::vector<bool> failures = {false, false, true, true, true, false, true, true, true, false, true, false, true};
+  check_logrank_statistic(times, failures, gen);
+
+  std::uniform_int_distribution<size_t> num_failures_dist(2, 12);
+  std::bernoulli_distribution failure_dist(0.6);
+  for (size_t node = 0; node < 50; node++) {
+    size_t num_failures = num_failures_dist(gen);
+    std::uniform_int_distribution<size_t> time_dist(0, num_failures);
+    // Every relabeled time 1, ..., m is the time of at least one failure.
+    std::vector<size_t> node_times;
+    std::vector<bool> node_failures;
+    for (size_t time = 1; time <= num_failures; time++) {
+      node_times.push_back(time);
+      node_failures.push_back(true);
+    }
+    for (size_t i = 0; i < 2 * num_failures; i++) {
+      size_t time = time_dist(gen);
+      node_times.push_back(time);
+      node_failures.push_back(time > 0 && failure_dist(gen));
+    }
+    check_logrank_statistic(node_times, node_failures, gen);
+  }
+}
+
+// The best logrank statistic over every split of `var`, with the missing values sent to
+// either side, and splitting the missing values from the others.
+double exhaustive_best_logrank(const Data& data,
+                               size_t var,
+                               const std::vector<double>& times,
+                               const std::vector<bool>& failures,
+                               double alpha) {
+  size_t num_samples = times.size();
+  size_t min_child_size = std::max<size_t>(static_cast<size_t>(std::ceil(num_samples * alpha)), 1);
+  size_t num_failures = std::count(failures.begin(), failures.end(), true);
+
+  std::vector<double> thresholds = {-INFINITY};
+  for (size_t sample = 0; sample < num_samples; sample++) {
+    if (!std::isnan(data.get(sample, var))) {
+      thresholds.push_back(data.get(sample, var));
+    }
+  }
+
+  double best_logrank = 0;
+  for (double threshold : thresholds) {
+    for (bool send_missing_left : {true, false}) {
+      std::vector<size_t> left;
+      size_t num_failures_left = 0;
+      for (size_t sample = 0; sample < num_samples; sample++) {
+        double value = data.get(sample, var);
+        if (std::isnan(value) ? send_missing_left : value <= threshold) {
+          left.push_back(sample);
+          num_failures_left += failures[sample];
+        }
+      }
+      if (left.empty() || left.size() == num_samples ||
+          num_failures_left < min_child_size || num_failures - num_failures_left < min_child_size) {
+        continue;
+      }
+      best_logrank = std::max(best_logrank, direct_logrank(times, failures, left));
+    }
+  }
+
+  return best_logrank;
+}
+
+TEST_CASE("survival splitting with missing values matches an exhaustive search", "[survival], [splitting]") {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> coarse(0, 9);
+  std::uniform_int_distribution<int> time_dist(1, 8);
+  std::bernoulli_distribution failure_dist(0.7);
+  double alpha = 0.05;
+  size_t num_rows = 120;
+
+  for (bool missing_fail_early : {true, false}) {
+    // Column-major [X, time, failure]. The missing rows fail like the low (or high) values of X,
+    // so the best split sends them left (or right).
+    std::vector<double> data_vec(3 * num_rows);
+    std::vector<double> times(num_rows);
+    std::vector<bool> failures(num_rows);
+    for (size_t row = 0; row < num_rows; row++) {
+      double x = coarse(gen);
+      bool missing = row % 5 == 0;
+      bool early = missing ? missing_fail_early : x < 5;
+      double time = early ? time_dist(gen) : 4 + time_dist(gen);
+      bool failure = failure_dist(gen);
+      if (row % 17 == 0) {
+        // Censored before the first failure.
+        time = 0.5;
+        failure = false;
+      }
+      if (row == 1) {
+        // The only sample at the last failure time.
+        time = 20;
+        failure = true;
+      }
+      data_vec[row] = missing ? NAN : x;
+      data_vec[num_rows + row] = time;
+      data_vec[2 * num_rows + row] = failure;
+      times[row] = time;
+      failures[row] = failure;
+    }
+    Data data(data_vec, num_rows, 3);
+    data.set_outcome_index(1);
+    data.set_censor_index(2);
+
+    Eigen::ArrayXXd responses_by_sample(num_rows, 1);
+    std::vector<size_t> samples;
+    for (size_t sample = 0; sample < num_rows; sample++) {
+      responses_by_sample(sample, 0) = times[sample];
+      samples.push_back(sample);
+    }
+
+    SurvivalSplittingRule splitting_rule(alpha);
+    double best_value = 0;
+    size_t best_var = 0;
+    bool best_send_missing_left = true;
+    double best_logrank = 0;
+    splitting_rule.find_best_split_internal(data, {0}, responses_by_sample, samples,
+                                            best_value, best_var, best_send_missing_left, best_logrank);
+
+    double expected = exhaustive_best_logrank(data, 0, times, failures, alpha);
+    REQUIRE(expected > 0);
+    REQUIRE(equal_doubles(best_logrank, expected, 1e-9 * expected));
+    REQUIRE(best_send_missing_left == missing_fail_early);
+  }
+}
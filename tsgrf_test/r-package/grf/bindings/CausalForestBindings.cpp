@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "commons/globals.h"
+#include "forest/CausalPipeline.h"
 #include "forest/ForestPredictors.h"
 #include "forest/ForestTrainers.h"
 #include "RcppUtilities.h"
@@ -60,7 +61,7 @@ Rcpp::List causal_train(const Rcpp::NumericMatrix& train_matrix,
 
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
                         honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
-  Forest forest = trainer.train(data, options);
+  Forest forest = RcppUtilities::train_forest(trainer, data, options);
 
   std::vector<Prediction> predictions;
   if (compute_oob_predictions) {
@@ -71,6 +72,66 @@ Rcpp::List causal_train(const Rcpp::NumericMatrix& train_matrix,
   return RcppUtilities::create_forest_object(forest, predictions);
 }
 
+// [[Rcpp::export]]
+Rcpp::List causal_pipeline_train(const Rcpp::NumericMatrix& train_matrix,
+                                 size_t outcome_index,
+                                 size_t treatment_index,
+                                 size_t sample_weight_index,
+                                 bool use_sample_weights,
+                                 unsigned int mtry,
+                                 unsigned int num_trees,
+                                 unsigned int nuisance_num_trees,
+                                 unsigned int min_node_size,
+                                 double sample_fraction,
+                                 bool honesty,
+                                 double honesty_fraction,
+                                 bool honesty_prune_leaves,
+                                 size_t ci_group_size,
+                                 double reduced_form_weight,
+                                 double alpha,
+                                 double imbalance_penalty,
+                                 bool stabilize_splits,
+                                 std::vector<size_t> clusters,
+                                 unsigned int samples_per_cluster,
+                                 bool compute_oob_predictions,
+                                 unsigned int num_threads,
+                                 unsigned int seed) {
+  ForestTrainer nuisance_trainer = regression_trainer();
+  ForestPredictor nuisance_predictor = regression_predictor(num_threads);
+  ForestTrainer trainer = instrumental_trainer(reduced_form_weight, stabilize_splits);
+  ForestPredictor predictor = instrumental_predictor(num_threads);
+
+  Data data = RcppUtilities::convert_data(train_matrix);
+  if (use_sample_weights) {
+    data.set_weight_index(sample_weight_index);
+  }
+
+  // The nuisance forests use the same settings as the regression forests causal_forest
+  // would otherwise train for Y.hat and W.hat.
+  ForestOptions nuisance_options(nuisance_num_trees, 2, sample_fraction, mtry, 5, true,
+      0.5, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster, 4, false, 1);
+  ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
+                        honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
+
+  CausalPipeline pipeline(nuisance_trainer, nuisance_predictor, trainer, predictor);
+  std::vector<double> Y_hat;
+  std::vector<double> W_hat;
+  std::vector<Prediction> predictions;
+  bool interrupted = false;
+  TrainingControl control;
+  RcppUtilities::stop_on_interrupt(control, interrupted);
+  Forest forest = pipeline.train(data, outcome_index, treatment_index, nuisance_options, options,
+                                 compute_oob_predictions, Y_hat, W_hat, predictions, control);
+  if (interrupted) {
+    throw Rcpp::internal::InterruptedException();
+  }
+
+  Rcpp::List result = RcppUtilities::create_forest_object(forest, predictions);
+  result.push_back(Y_hat, "Y.hat");
+  result.push_back(W_hat, "W.hat");
+  return result;
+}
+
 
 // [[Rcpp::export]]
 Rcpp::List causal_predict(const Rcpp::List& forest_object,
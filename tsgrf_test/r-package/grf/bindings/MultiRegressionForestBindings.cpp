@@ -43,7 +43,10 @@ Rcpp::List multi_regression_train(const Rcpp::NumericMatrix& train_matrix,
                                   unsigned int samples_per_cluster,
                                   bool compute_oob_predictions,
                                   unsigned int num_threads,
-                                  unsigned int seed) {
+                                  unsigned int seed,
+                                  unsigned int num_random_thresholds,
+                                  unsigned int max_num_thresholds,
+                                  size_t min_quantile_node_size) {
   Data data = RcppUtilities::convert_data(train_matrix);
   data.set_outcome_index(outcome_index);
   if (use_sample_weights) {
@@ -53,8 +56,9 @@ Rcpp::List multi_regression_train(const Rcpp::NumericMatrix& train_matrix,
   size_t ci_group_size = 1;
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
       honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, clusters, samples_per_cluster);
-  ForestTrainer trainer = multi_regression_trainer(data.get_num_outcomes());
-  Forest forest = trainer.train(data, options);
+  SplitValueOptions split_value_options(num_random_thresholds, max_num_thresholds, min_quantile_node_size);
+  ForestTrainer trainer = multi_regression_trainer(data.get_num_outcomes(), split_value_options);
+  Forest forest = RcppUtilities::train_forest(trainer, data, options);
 
   std::vector<Prediction> predictions;
   if (compute_oob_predictions) {
@@ -44,6 +44,35 @@ public:
 
   static Data convert_data(const Rcpp::NumericMatrix& input_data);
 
+  /**
+   * Data over the columns of `input_data` followed by the columns of each element of
+   * `columns` (double vectors or matrices with one value per row), without copying them.
+   */
+  static Data convert_data(const Rcpp::NumericMatrix& input_data, const Rcpp::List& columns);
+
+  /**
+   * Adds the virtual feature columns described by the rows of `virtual_features`
+   * (source column, lag, window, statistic code) to `data`, see Data::add_virtual_column.
+   */
+  static void add_virtual_columns(Data& data, const Rcpp::NumericMatrix& virtual_features);
+
+  /**
+   * Makes `control` stop training on an R user interrupt, and records it in `interrupted`.
+   * The caller re-raises the interrupt (Rcpp::internal::InterruptedException) once
+   * training has returned, so that it never unwinds through running workers.
+   */
+  static void stop_on_interrupt(TrainingControl& control, bool& interrupted);
+
+  /**
+   * Trains a forest that stops early on an R user interrupt (which is then re-raised
+   * once the workers have finished), or once `time_budget` seconds have elapsed.
+   * A non-positive or non-finite budget means no time limit.
+   */
+  static Forest train_forest(const ForestTrainer& trainer,
+                             const Data& data,
+                             const ForestOptions& options,
+                             double time_budget = 0);
+
   static Rcpp::List create_prediction_object(const std::vector<Prediction>& predictions);
   static void add_predictions(Rcpp::List& output,
                               const std::vector<Prediction>& predictions);
@@ -93,6 +93,39 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// causal_pipeline_train
+Rcpp::List causal_pipeline_train(const Rcpp::NumericMatrix& train_matrix, size_t outcome_index, size_t treatment_index, size_t sample_weight_index, bool use_sample_weights, unsigned int mtry, unsigned int num_trees, unsigned int nuisance_num_trees, unsigned int min_node_size, double sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, size_t ci_group_size, double reduced_form_weight, double alpha, double imbalance_penalty, bool stabilize_splits, std::vector<size_t> clusters, unsigned int samples_per_cluster, bool compute_oob_predictions, unsigned int num_threads, unsigned int seed);
+RcppExport SEXP _grf_causal_pipeline_train(SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP treatment_indexSEXP, SEXP sample_weight_indexSEXP, SEXP use_sample_weightsSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP nuisance_num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP ci_group_sizeSEXP, SEXP reduced_form_weightSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP stabilize_splitsSEXP, SEXP clustersSEXP, SEXP samples_per_clusterSEXP, SEXP compute_oob_predictionsSEXP, SEXP num_threadsSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type train_matrix(train_matrixSEXP);
+    Rcpp::traits::input_parameter< size_t >::type outcome_index(outcome_indexSEXP);
+    Rcpp::traits::input_parameter< size_t >::type treatment_index(treatment_indexSEXP);
+    Rcpp::traits::input_parameter< size_t >::type sample_weight_index(sample_weight_indexSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_sample_weights(use_sample_weightsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type mtry(mtrySEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type num_trees(num_treesSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type nuisance_num_trees(nuisance_num_treesSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type min_node_size(min_node_sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type sample_fraction(sample_fractionSEXP);
+    Rcpp::traits::input_parameter< bool >::type honesty(honestySEXP);
+    Rcpp::traits::input_parameter< double >::type honesty_fraction(honesty_fractionSEXP);
+    Rcpp::traits::input_parameter< bool >::type honesty_prune_leaves(honesty_prune_leavesSEXP);
+    Rcpp::traits::input_parameter< size_t >::type ci_group_size(ci_group_sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type reduced_form_weight(reduced_form_weightSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< double >::type imbalance_penalty(imbalance_penaltySEXP);
+    Rcpp::traits::input_parameter< bool >::type stabilize_splits(stabilize_splitsSEXP);
+    Rcpp::traits::input_parameter< std::vector<size_t> >::type clusters(clustersSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type samples_per_cluster(samples_per_clusterSEXP);
+    Rcpp::traits::input_parameter< bool >::type compute_oob_predictions(compute_oob_predictionsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(causal_pipeline_train(train_matrix, outcome_index, treatment_index, sample_weight_index, use_sample_weights, mtry, num_trees, nuisance_num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, ci_group_size, reduced_form_weight, alpha, imbalance_penalty, stabilize_splits, clusters, samples_per_cluster, compute_oob_predictions, num_threads, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
 // causal_predict
 Rcpp::List causal_predict(const Rcpp::List& forest_object, const Rcpp::NumericMatrix& train_matrix, size_t outcome_index, size_t treatment_index, const Rcpp::NumericMatrix& test_matrix, unsigned int num_threads, bool estimate_variance);
 RcppExport SEXP _grf_causal_predict(SEXP forest_objectSEXP, SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP treatment_indexSEXP, SEXP test_matrixSEXP, SEXP num_threadsSEXP, SEXP estimate_varianceSEXP) {
@@ -361,8 +394,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // multi_regression_train
-Rcpp::List multi_regression_train(const Rcpp::NumericMatrix& train_matrix, const std::vector<size_t>& outcome_index, size_t sample_weight_index, bool use_sample_weights, unsigned int mtry, unsigned int num_trees, unsigned int min_node_size, double sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, double alpha, double imbalance_penalty, std::vector<size_t>& clusters, unsigned int samples_per_cluster, bool compute_oob_predictions, unsigned int num_threads, unsigned int seed);
-RcppExport SEXP _grf_multi_regression_train(SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP sample_weight_indexSEXP, SEXP use_sample_weightsSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP clustersSEXP, SEXP samples_per_clusterSEXP, SEXP compute_oob_predictionsSEXP, SEXP num_threadsSEXP, SEXP seedSEXP) {
+Rcpp::List multi_regression_train(const Rcpp::NumericMatrix& train_matrix, const std::vector<size_t>& outcome_index, size_t sample_weight_index, bool use_sample_weights, unsigned int mtry, unsigned int num_trees, unsigned int min_node_size, double sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, double alpha, double imbalance_penalty, std::vector<size_t>& clusters, unsigned int samples_per_cluster, bool compute_oob_predictions, unsigned int num_threads, unsigned int seed, unsigned int num_random_thresholds, unsigned int max_num_thresholds, size_t min_quantile_node_size);
+RcppExport SEXP _grf_multi_regression_train(SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP sample_weight_indexSEXP, SEXP use_sample_weightsSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP clustersSEXP, SEXP samples_per_clusterSEXP, SEXP compute_oob_predictionsSEXP, SEXP num_threadsSEXP, SEXP seedSEXP, SEXP num_random_thresholdsSEXP, SEXP max_num_thresholdsSEXP, SEXP min_quantile_node_sizeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -384,7 +417,10 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< bool >::type compute_oob_predictions(compute_oob_predictionsSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type num_threads(num_threadsSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
-    rcpp_result_gen = Rcpp::wrap(multi_regression_train(train_matrix, outcome_index, sample_weight_index, use_sample_weights, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, clusters, samples_per_cluster, compute_oob_predictions, num_threads, seed));
+    Rcpp::traits::input_parameter< unsigned int >::type num_random_thresholds(num_random_thresholdsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type max_num_thresholds(max_num_thresholdsSEXP);
+    Rcpp::traits::input_parameter< size_t >::type min_quantile_node_size(min_quantile_node_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(multi_regression_train(train_matrix, outcome_index, sample_weight_index, use_sample_weights, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, clusters, samples_per_cluster, compute_oob_predictions, num_threads, seed, num_random_thresholds, max_num_thresholds, min_quantile_node_size));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -418,8 +454,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // probability_train
-Rcpp::List probability_train(const Rcpp::NumericMatrix& train_matrix, size_t outcome_index, size_t sample_weight_index, bool use_sample_weights, size_t num_classes, unsigned int mtry, unsigned int num_trees, int min_node_size, double sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, size_t ci_group_size, double alpha, double imbalance_penalty, const std::vector<size_t>& clusters, unsigned int samples_per_cluster, bool compute_oob_predictions, int num_threads, unsigned int seed);
-RcppExport SEXP _grf_probability_train(SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP sample_weight_indexSEXP, SEXP use_sample_weightsSEXP, SEXP num_classesSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP ci_group_sizeSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP clustersSEXP, SEXP samples_per_clusterSEXP, SEXP compute_oob_predictionsSEXP, SEXP num_threadsSEXP, SEXP seedSEXP) {
+Rcpp::List probability_train(const Rcpp::NumericMatrix& train_matrix, size_t outcome_index, size_t sample_weight_index, bool use_sample_weights, size_t num_classes, unsigned int mtry, unsigned int num_trees, int min_node_size, double sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, size_t ci_group_size, double alpha, double imbalance_penalty, const std::vector<size_t>& clusters, unsigned int samples_per_cluster, bool compute_oob_predictions, int num_threads, unsigned int seed, unsigned int num_random_thresholds, unsigned int max_num_thresholds, size_t min_quantile_node_size);
+RcppExport SEXP _grf_probability_train(SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP sample_weight_indexSEXP, SEXP use_sample_weightsSEXP, SEXP num_classesSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP ci_group_sizeSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP clustersSEXP, SEXP samples_per_clusterSEXP, SEXP compute_oob_predictionsSEXP, SEXP num_threadsSEXP, SEXP seedSEXP, SEXP num_random_thresholdsSEXP, SEXP max_num_thresholdsSEXP, SEXP min_quantile_node_sizeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -443,7 +479,10 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< bool >::type compute_oob_predictions(compute_oob_predictionsSEXP);
     Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
-    rcpp_result_gen = Rcpp::wrap(probability_train(train_matrix, outcome_index, sample_weight_index, use_sample_weights, num_classes, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, ci_group_size, alpha, imbalance_penalty, clusters, samples_per_cluster, compute_oob_predictions, num_threads, seed));
+    Rcpp::traits::input_parameter< unsigned int >::type num_random_thresholds(num_random_thresholdsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type max_num_thresholds(max_num_thresholdsSEXP);
+    Rcpp::traits::input_parameter< size_t >::type min_quantile_node_size(min_quantile_node_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(probability_train(train_matrix, outcome_index, sample_weight_index, use_sample_weights, num_classes, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, ci_group_size, alpha, imbalance_penalty, clusters, samples_per_cluster, compute_oob_predictions, num_threads, seed, num_random_thresholds, max_num_thresholds, min_quantile_node_size));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -481,8 +520,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // quantile_train
-Rcpp::List quantile_train(std::vector<double> quantiles, bool regression_splitting, const Rcpp::NumericMatrix& train_matrix, size_t outcome_index, unsigned int mtry, unsigned int num_trees, int min_node_size, double sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, size_t nonlapping_block_size, double alpha, double imbalance_penalty, std::vector<size_t> clusters, unsigned int samples_per_cluster, bool compute_oob_predictions, int num_threads, unsigned int seed, size_t honesty_method);
-RcppExport SEXP _grf_quantile_train(SEXP quantilesSEXP, SEXP regression_splittingSEXP, SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP nonlapping_block_sizeSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP clustersSEXP, SEXP samples_per_clusterSEXP, SEXP compute_oob_predictionsSEXP, SEXP num_threadsSEXP, SEXP seedSEXP, SEXP honesty_methodSEXP) {
+Rcpp::List quantile_train(std::vector<double> quantiles, bool regression_splitting, const Rcpp::NumericMatrix& train_matrix, size_t outcome_index, unsigned int mtry, unsigned int num_trees, int min_node_size, double sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, size_t nonlapping_block_size, double alpha, double imbalance_penalty, std::vector<size_t> clusters, unsigned int samples_per_cluster, bool compute_oob_predictions, int num_threads, unsigned int seed, size_t honesty_method, unsigned int num_random_thresholds, unsigned int max_num_thresholds, size_t min_quantile_node_size);
+RcppExport SEXP _grf_quantile_train(SEXP quantilesSEXP, SEXP regression_splittingSEXP, SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP nonlapping_block_sizeSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP clustersSEXP, SEXP samples_per_clusterSEXP, SEXP compute_oob_predictionsSEXP, SEXP num_threadsSEXP, SEXP seedSEXP, SEXP honesty_methodSEXP, SEXP num_random_thresholdsSEXP, SEXP max_num_thresholdsSEXP, SEXP min_quantile_node_sizeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -506,7 +545,10 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
     Rcpp::traits::input_parameter< size_t >::type honesty_method(honesty_methodSEXP);
-    rcpp_result_gen = Rcpp::wrap(quantile_train(quantiles, regression_splitting, train_matrix, outcome_index, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, nonlapping_block_size, alpha, imbalance_penalty, clusters, samples_per_cluster, compute_oob_predictions, num_threads, seed, honesty_method));
+    Rcpp::traits::input_parameter< unsigned int >::type num_random_thresholds(num_random_thresholdsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type max_num_thresholds(max_num_thresholdsSEXP);
+    Rcpp::traits::input_parameter< size_t >::type min_quantile_node_size(min_quantile_node_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(quantile_train(quantiles, regression_splitting, train_matrix, outcome_index, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, nonlapping_block_size, alpha, imbalance_penalty, clusters, samples_per_cluster, compute_oob_predictions, num_threads, seed, honesty_method, num_random_thresholds, max_num_thresholds, min_quantile_node_size));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -542,15 +584,20 @@ BEGIN_RCPP
 END_RCPP
 }
 // regression_train
-Rcpp::List regression_train(const Rcpp::NumericMatrix& train_matrix, size_t outcome_index, size_t sample_weight_index, bool use_sample_weights, unsigned int mtry, unsigned int num_trees, unsigned int min_node_size, double sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, size_t nonlapping_block_size, double alpha, double imbalance_penalty, std::vector<size_t> clusters, unsigned int samples_per_cluster, bool compute_oob_predictions, unsigned int num_threads, unsigned int seed,  size_t honesty_method);
-RcppExport SEXP _grf_regression_train(SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP sample_weight_indexSEXP, SEXP use_sample_weightsSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP nonlapping_block_sizeSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP clustersSEXP, SEXP samples_per_clusterSEXP, SEXP compute_oob_predictionsSEXP, SEXP num_threadsSEXP, SEXP seedSEXP, SEXP honesty_methodSEXP) {
+Rcpp::List regression_train(const Rcpp::NumericMatrix& train_matrix, const Rcpp::List& train_columns, const Rcpp::NumericMatrix& virtual_features, size_t outcome_index, size_t sample_weight_index, bool use_sample_weights, size_t series_index, bool use_series, bool equal_series_allocation, unsigned int mtry, unsigned int num_trees, unsigned int min_node_size, double sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, size_t nonlapping_block_size, size_t ci_group_size, double alpha, double imbalance_penalty, std::vector<size_t> clusters, unsigned int samples_per_cluster, bool compute_oob_predictions, unsigned int num_threads, unsigned int seed, size_t honesty_method, double train_time_budget, unsigned int num_random_thresholds, unsigned int max_num_thresholds, size_t min_quantile_node_size);
+RcppExport SEXP _grf_regression_train(SEXP train_matrixSEXP, SEXP train_columnsSEXP, SEXP virtual_featuresSEXP, SEXP outcome_indexSEXP, SEXP sample_weight_indexSEXP, SEXP use_sample_weightsSEXP, SEXP series_indexSEXP, SEXP use_seriesSEXP, SEXP equal_series_allocationSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP nonlapping_block_sizeSEXP, SEXP ci_group_sizeSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP clustersSEXP, SEXP samples_per_clusterSEXP, SEXP compute_oob_predictionsSEXP, SEXP num_threadsSEXP, SEXP seedSEXP, SEXP honesty_methodSEXP, SEXP train_time_budgetSEXP, SEXP num_random_thresholdsSEXP, SEXP max_num_thresholdsSEXP, SEXP min_quantile_node_sizeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type train_matrix(train_matrixSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type train_columns(train_columnsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type virtual_features(virtual_featuresSEXP);
     Rcpp::traits::input_parameter< size_t >::type outcome_index(outcome_indexSEXP);
     Rcpp::traits::input_parameter< size_t >::type sample_weight_index(sample_weight_indexSEXP);
     Rcpp::traits::input_parameter< bool >::type use_sample_weights(use_sample_weightsSEXP);
+    Rcpp::traits::input_parameter< size_t >::type series_index(series_indexSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_series(use_seriesSEXP);
+    Rcpp::traits::input_parameter< bool >::type equal_series_allocation(equal_series_allocationSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type mtry(mtrySEXP);
     Rcpp::traits::input_parameter< unsigned int >::type num_trees(num_treesSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type min_node_size(min_node_sizeSEXP);
@@ -559,6 +606,7 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< double >::type honesty_fraction(honesty_fractionSEXP);
     Rcpp::traits::input_parameter< bool >::type honesty_prune_leaves(honesty_prune_leavesSEXP);
     Rcpp::traits::input_parameter< size_t >::type nonlapping_block_size(nonlapping_block_sizeSEXP);
+    Rcpp::traits::input_parameter< size_t >::type ci_group_size(ci_group_sizeSEXP);
     Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
     Rcpp::traits::input_parameter< double >::type imbalance_penalty(imbalance_penaltySEXP);
     Rcpp::traits::input_parameter< std::vector<size_t> >::type clusters(clustersSEXP);
@@ -567,38 +615,152 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< unsigned int >::type num_threads(num_threadsSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
     Rcpp::traits::input_parameter< size_t >::type honesty_method(honesty_methodSEXP);
-    rcpp_result_gen = Rcpp::wrap(regression_train(train_matrix, outcome_index, sample_weight_index, use_sample_weights, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, nonlapping_block_size, alpha, imbalance_penalty, clusters, samples_per_cluster, compute_oob_predictions, num_threads, seed, honesty_method));
+    Rcpp::traits::input_parameter< double >::type train_time_budget(train_time_budgetSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type num_random_thresholds(num_random_thresholdsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type max_num_thresholds(max_num_thresholdsSEXP);
+    Rcpp::traits::input_parameter< size_t >::type min_quantile_node_size(min_quantile_node_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(regression_train(train_matrix, train_columns, virtual_features, outcome_index, sample_weight_index, use_sample_weights, series_index, use_series, equal_series_allocation, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, nonlapping_block_size, ci_group_size, alpha, imbalance_penalty, clusters, samples_per_cluster, compute_oob_predictions, num_threads, seed, honesty_method, train_time_budget, num_random_thresholds, max_num_thresholds, min_quantile_node_size));
+    return rcpp_result_gen;
+END_RCPP
+}
+// regression_tune
+Rcpp::NumericVector regression_tune(const Rcpp::NumericMatrix& train_matrix, const Rcpp::List& train_columns, const Rcpp::NumericMatrix& virtual_features, size_t outcome_index, size_t sample_weight_index, bool use_sample_weights, size_t series_index, bool use_series, bool equal_series_allocation, std::vector<unsigned int> mtry, unsigned int num_trees, std::vector<unsigned int> min_node_size, std::vector<double> sample_fraction, bool honesty, std::vector<double> honesty_fraction, std::vector<bool> honesty_prune_leaves, size_t nonlapping_block_size, std::vector<double> alpha, std::vector<double> imbalance_penalty, std::vector<size_t> clusters, unsigned int samples_per_cluster, unsigned int num_threads, unsigned int seed, size_t honesty_method, unsigned int num_random_thresholds, unsigned int max_num_thresholds, size_t min_quantile_node_size);
+RcppExport SEXP _grf_regression_tune(SEXP train_matrixSEXP, SEXP train_columnsSEXP, SEXP virtual_featuresSEXP, SEXP outcome_indexSEXP, SEXP sample_weight_indexSEXP, SEXP use_sample_weightsSEXP, SEXP series_indexSEXP, SEXP use_seriesSEXP, SEXP equal_series_allocationSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP nonlapping_block_sizeSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP clustersSEXP, SEXP samples_per_clusterSEXP, SEXP num_threadsSEXP, SEXP seedSEXP, SEXP honesty_methodSEXP, SEXP num_random_thresholdsSEXP, SEXP max_num_thresholdsSEXP, SEXP min_quantile_node_sizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type train_matrix(train_matrixSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type train_columns(train_columnsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type virtual_features(virtual_featuresSEXP);
+    Rcpp::traits::input_parameter< size_t >::type outcome_index(outcome_indexSEXP);
+    Rcpp::traits::input_parameter< size_t >::type sample_weight_index(sample_weight_indexSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_sample_weights(use_sample_weightsSEXP);
+    Rcpp::traits::input_parameter< size_t >::type series_index(series_indexSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_series(use_seriesSEXP);
+    Rcpp::traits::input_parameter< bool >::type equal_series_allocation(equal_series_allocationSEXP);
+    Rcpp::traits::input_parameter< std::vector<unsigned int> >::type mtry(mtrySEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type num_trees(num_treesSEXP);
+    Rcpp::traits::input_parameter< std::vector<unsigned int> >::type min_node_size(min_node_sizeSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type sample_fraction(sample_fractionSEXP);
+    Rcpp::traits::input_parameter< bool >::type honesty(honestySEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type honesty_fraction(honesty_fractionSEXP);
+    Rcpp::traits::input_parameter< std::vector<bool> >::type honesty_prune_leaves(honesty_prune_leavesSEXP);
+    Rcpp::traits::input_parameter< size_t >::type nonlapping_block_size(nonlapping_block_sizeSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type imbalance_penalty(imbalance_penaltySEXP);
+    Rcpp::traits::input_parameter< std::vector<size_t> >::type clusters(clustersSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type samples_per_cluster(samples_per_clusterSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< size_t >::type honesty_method(honesty_methodSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type num_random_thresholds(num_random_thresholdsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type max_num_thresholds(max_num_thresholdsSEXP);
+    Rcpp::traits::input_parameter< size_t >::type min_quantile_node_size(min_quantile_node_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(regression_tune(train_matrix, train_columns, virtual_features, outcome_index, sample_weight_index, use_sample_weights, series_index, use_series, equal_series_allocation, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, nonlapping_block_size, alpha, imbalance_penalty, clusters, samples_per_cluster, num_threads, seed, honesty_method, num_random_thresholds, max_num_thresholds, min_quantile_node_size));
+    return rcpp_result_gen;
+END_RCPP
+}
+// regression_backtest
+Rcpp::List regression_backtest(const Rcpp::NumericMatrix& train_matrix, const Rcpp::List& train_columns, const Rcpp::NumericMatrix& virtual_features, size_t outcome_index, size_t sample_weight_index, bool use_sample_weights, size_t series_index, bool use_series, bool equal_series_allocation, std::vector<size_t> train_end, std::vector<size_t> horizon, size_t window_size, unsigned int mtry, unsigned int num_trees, unsigned int min_node_size, double sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, size_t nonlapping_block_size, double alpha, double imbalance_penalty, unsigned int num_threads, unsigned int seed, size_t honesty_method);
+RcppExport SEXP _grf_regression_backtest(SEXP train_matrixSEXP, SEXP train_columnsSEXP, SEXP virtual_featuresSEXP, SEXP outcome_indexSEXP, SEXP sample_weight_indexSEXP, SEXP use_sample_weightsSEXP, SEXP series_indexSEXP, SEXP use_seriesSEXP, SEXP equal_series_allocationSEXP, SEXP train_endSEXP, SEXP horizonSEXP, SEXP window_sizeSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP nonlapping_block_sizeSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP num_threadsSEXP, SEXP seedSEXP, SEXP honesty_methodSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type train_matrix(train_matrixSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type train_columns(train_columnsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type virtual_features(virtual_featuresSEXP);
+    Rcpp::traits::input_parameter< size_t >::type outcome_index(outcome_indexSEXP);
+    Rcpp::traits::input_parameter< size_t >::type sample_weight_index(sample_weight_indexSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_sample_weights(use_sample_weightsSEXP);
+    Rcpp::traits::input_parameter< size_t >::type series_index(series_indexSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_series(use_seriesSEXP);
+    Rcpp::traits::input_parameter< bool >::type equal_series_allocation(equal_series_allocationSEXP);
+    Rcpp::traits::input_parameter< std::vector<size_t> >::type train_end(train_endSEXP);
+    Rcpp::traits::input_parameter< std::vector<size_t> >::type horizon(horizonSEXP);
+    Rcpp::traits::input_parameter< size_t >::type window_size(window_sizeSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type mtry(mtrySEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type num_trees(num_treesSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type min_node_size(min_node_sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type sample_fraction(sample_fractionSEXP);
+    Rcpp::traits::input_parameter< bool >::type honesty(honestySEXP);
+    Rcpp::traits::input_parameter< double >::type honesty_fraction(honesty_fractionSEXP);
+    Rcpp::traits::input_parameter< bool >::type honesty_prune_leaves(honesty_prune_leavesSEXP);
+    Rcpp::traits::input_parameter< size_t >::type nonlapping_block_size(nonlapping_block_sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< double >::type imbalance_penalty(imbalance_penaltySEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< size_t >::type honesty_method(honesty_methodSEXP);
+    rcpp_result_gen = Rcpp::wrap(regression_backtest(train_matrix, train_columns, virtual_features, outcome_index, sample_weight_index, use_sample_weights, series_index, use_series, equal_series_allocation, train_end, horizon, window_size, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, nonlapping_block_size, alpha, imbalance_penalty, num_threads, seed, honesty_method));
+    return rcpp_result_gen;
+END_RCPP
+}
+// regression_train_batch
+Rcpp::List regression_train_batch(const Rcpp::NumericMatrix& train_matrix, const Rcpp::List& train_columns, size_t outcome_index, size_t sample_weight_index, bool use_sample_weights, std::vector<size_t> row_begin, std::vector<size_t> row_end, std::vector<unsigned int> mtry, unsigned int num_trees, std::vector<unsigned int> min_node_size, std::vector<double> sample_fraction, bool honesty, double honesty_fraction, bool honesty_prune_leaves, size_t nonlapping_block_size, double alpha, double imbalance_penalty, unsigned int num_threads, unsigned int seed, size_t honesty_method);
+RcppExport SEXP _grf_regression_train_batch(SEXP train_matrixSEXP, SEXP train_columnsSEXP, SEXP outcome_indexSEXP, SEXP sample_weight_indexSEXP, SEXP use_sample_weightsSEXP, SEXP row_beginSEXP, SEXP row_endSEXP, SEXP mtrySEXP, SEXP num_treesSEXP, SEXP min_node_sizeSEXP, SEXP sample_fractionSEXP, SEXP honestySEXP, SEXP honesty_fractionSEXP, SEXP honesty_prune_leavesSEXP, SEXP nonlapping_block_sizeSEXP, SEXP alphaSEXP, SEXP imbalance_penaltySEXP, SEXP num_threadsSEXP, SEXP seedSEXP, SEXP honesty_methodSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type train_matrix(train_matrixSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type train_columns(train_columnsSEXP);
+    Rcpp::traits::input_parameter< size_t >::type outcome_index(outcome_indexSEXP);
+    Rcpp::traits::input_parameter< size_t >::type sample_weight_index(sample_weight_indexSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_sample_weights(use_sample_weightsSEXP);
+    Rcpp::traits::input_parameter< std::vector<size_t> >::type row_begin(row_beginSEXP);
+    Rcpp::traits::input_parameter< std::vector<size_t> >::type row_end(row_endSEXP);
+    Rcpp::traits::input_parameter< std::vector<unsigned int> >::type mtry(mtrySEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type num_trees(num_treesSEXP);
+    Rcpp::traits::input_parameter< std::vector<unsigned int> >::type min_node_size(min_node_sizeSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type sample_fraction(sample_fractionSEXP);
+    Rcpp::traits::input_parameter< bool >::type honesty(honestySEXP);
+    Rcpp::traits::input_parameter< double >::type honesty_fraction(honesty_fractionSEXP);
+    Rcpp::traits::input_parameter< bool >::type honesty_prune_leaves(honesty_prune_leavesSEXP);
+    Rcpp::traits::input_parameter< size_t >::type nonlapping_block_size(nonlapping_block_sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< double >::type imbalance_penalty(imbalance_penaltySEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< unsigned int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< size_t >::type honesty_method(honesty_methodSEXP);
+    rcpp_result_gen = Rcpp::wrap(regression_train_batch(train_matrix, train_columns, outcome_index, sample_weight_index, use_sample_weights, row_begin, row_end, mtry, num_trees, min_node_size, sample_fraction, honesty, honesty_fraction, honesty_prune_leaves, nonlapping_block_size, alpha, imbalance_penalty, num_threads, seed, honesty_method));
     return rcpp_result_gen;
 END_RCPP
 }
 // regression_predict
-Rcpp::List regression_predict(const Rcpp::List& forest_object, const Rcpp::NumericMatrix& train_matrix, size_t outcome_index, const Rcpp::NumericMatrix& test_matrix, unsigned int num_threads, unsigned int estimate_variance);
-RcppExport SEXP _grf_regression_predict(SEXP forest_objectSEXP, SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP test_matrixSEXP, SEXP num_threadsSEXP, SEXP estimate_varianceSEXP) {
+Rcpp::List regression_predict(const Rcpp::List& forest_object, const Rcpp::NumericMatrix& train_matrix, const Rcpp::List& train_columns, size_t outcome_index, size_t series_index, bool use_series, const Rcpp::NumericMatrix& test_matrix, const Rcpp::NumericMatrix& virtual_features, unsigned int num_threads, unsigned int estimate_variance);
+RcppExport SEXP _grf_regression_predict(SEXP forest_objectSEXP, SEXP train_matrixSEXP, SEXP train_columnsSEXP, SEXP outcome_indexSEXP, SEXP series_indexSEXP, SEXP use_seriesSEXP, SEXP test_matrixSEXP, SEXP virtual_featuresSEXP, SEXP num_threadsSEXP, SEXP estimate_varianceSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::List& >::type forest_object(forest_objectSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type train_matrix(train_matrixSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type train_columns(train_columnsSEXP);
     Rcpp::traits::input_parameter< size_t >::type outcome_index(outcome_indexSEXP);
+    Rcpp::traits::input_parameter< size_t >::type series_index(series_indexSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_series(use_seriesSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type test_matrix(test_matrixSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type virtual_features(virtual_featuresSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type num_threads(num_threadsSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type estimate_variance(estimate_varianceSEXP);
-    rcpp_result_gen = Rcpp::wrap(regression_predict(forest_object, train_matrix, outcome_index, test_matrix, num_threads, estimate_variance));
+    rcpp_result_gen = Rcpp::wrap(regression_predict(forest_object, train_matrix, train_columns, outcome_index, series_index, use_series, test_matrix, virtual_features, num_threads, estimate_variance));
     return rcpp_result_gen;
 END_RCPP
 }
 // regression_predict_oob
-Rcpp::List regression_predict_oob(const Rcpp::List& forest_object, const Rcpp::NumericMatrix& train_matrix, size_t outcome_index, unsigned int num_threads, bool estimate_variance);
-RcppExport SEXP _grf_regression_predict_oob(SEXP forest_objectSEXP, SEXP train_matrixSEXP, SEXP outcome_indexSEXP, SEXP num_threadsSEXP, SEXP estimate_varianceSEXP) {
+Rcpp::List regression_predict_oob(const Rcpp::List& forest_object, const Rcpp::NumericMatrix& train_matrix, const Rcpp::List& train_columns, const Rcpp::NumericMatrix& virtual_features, size_t outcome_index, size_t series_index, bool use_series, unsigned int num_threads, bool estimate_variance);
+RcppExport SEXP _grf_regression_predict_oob(SEXP forest_objectSEXP, SEXP train_matrixSEXP, SEXP train_columnsSEXP, SEXP virtual_featuresSEXP, SEXP outcome_indexSEXP, SEXP series_indexSEXP, SEXP use_seriesSEXP, SEXP num_threadsSEXP, SEXP estimate_varianceSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::List& >::type forest_object(forest_objectSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type train_matrix(train_matrixSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type train_columns(train_columnsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type virtual_features(virtual_featuresSEXP);
     Rcpp::traits::input_parameter< size_t >::type outcome_index(outcome_indexSEXP);
+    Rcpp::traits::input_parameter< size_t >::type series_index(series_indexSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_series(use_seriesSEXP);
     Rcpp::traits::input_parameter< unsigned int >::type num_threads(num_threadsSEXP);
     Rcpp::traits::input_parameter< bool >::type estimate_variance(estimate_varianceSEXP);
-    rcpp_result_gen = Rcpp::wrap(regression_predict_oob(forest_object, train_matrix, outcome_index, num_threads, estimate_variance));
+    rcpp_result_gen = Rcpp::wrap(regression_predict_oob(forest_object, train_matrix, train_columns, virtual_features, outcome_index, series_index, use_series, num_threads, estimate_variance));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -746,6 +908,7 @@ static const R_CallMethodDef CallEntries[] = {
     {"_grf_compute_weights_oob", (DL_FUNC) &_grf_compute_weights_oob, 3},
     {"_grf_merge", (DL_FUNC) &_grf_merge, 1},
     {"_grf_causal_train", (DL_FUNC) &_grf_causal_train, 22},
+    {"_grf_causal_pipeline_train", (DL_FUNC) &_grf_causal_pipeline_train, 23},
     {"_grf_causal_predict", (DL_FUNC) &_grf_causal_predict, 7},
     {"_grf_causal_predict_oob", (DL_FUNC) &_grf_causal_predict_oob, 6},
     {"_grf_ll_causal_predict", (DL_FUNC) &_grf_ll_causal_predict, 10},
@@ -759,18 +922,21 @@ static const R_CallMethodDef CallEntries[] = {
     {"_grf_multi_causal_train", (DL_FUNC) &_grf_multi_causal_train, 22},
     {"_grf_multi_causal_predict", (DL_FUNC) &_grf_multi_causal_predict, 7},
     {"_grf_multi_causal_predict_oob", (DL_FUNC) &_grf_multi_causal_predict_oob, 6},
-    {"_grf_multi_regression_train", (DL_FUNC) &_grf_multi_regression_train, 18},
+    {"_grf_multi_regression_train", (DL_FUNC) &_grf_multi_regression_train, 21},
     {"_grf_multi_regression_predict", (DL_FUNC) &_grf_multi_regression_predict, 5},
     {"_grf_multi_regression_predict_oob", (DL_FUNC) &_grf_multi_regression_predict_oob, 4},
-    {"_grf_probability_train", (DL_FUNC) &_grf_probability_train, 20},
+    {"_grf_probability_train", (DL_FUNC) &_grf_probability_train, 23},
     {"_grf_probability_predict", (DL_FUNC) &_grf_probability_predict, 7},
     {"_grf_probability_predict_oob", (DL_FUNC) &_grf_probability_predict_oob, 6},
-    {"_grf_quantile_train", (DL_FUNC) &_grf_quantile_train, 20},
+    {"_grf_quantile_train", (DL_FUNC) &_grf_quantile_train, 23},
     {"_grf_quantile_predict", (DL_FUNC) &_grf_quantile_predict, 6},
     {"_grf_quantile_predict_oob", (DL_FUNC) &_grf_quantile_predict_oob, 5},
-    {"_grf_regression_train", (DL_FUNC) &_grf_regression_train, 20},
-    {"_grf_regression_predict", (DL_FUNC) &_grf_regression_predict, 6},
-    {"_grf_regression_predict_oob", (DL_FUNC) &_grf_regression_predict_oob, 5},
+    {"_grf_regression_train", (DL_FUNC) &_grf_regression_train, 30},
+    {"_grf_regression_tune", (DL_FUNC) &_grf_regression_tune, 27},
+    {"_grf_regression_backtest", (DL_FUNC) &_grf_regression_backtest, 25},
+    {"_grf_regression_train_batch", (DL_FUNC) &_grf_regression_train_batch, 20},
+    {"_grf_regression_predict", (DL_FUNC) &_grf_regression_predict, 10},
+    {"_grf_regression_predict_oob", (DL_FUNC) &_grf_regression_predict_oob, 9},
     {"_grf_ll_regression_train", (DL_FUNC) &_grf_ll_regression_train, 21},
     {"_grf_ll_regression_predict", (DL_FUNC) &_grf_ll_regression_predict, 9},
     {"_grf_ll_regression_predict_oob", (DL_FUNC) &_grf_ll_regression_predict_oob, 8},
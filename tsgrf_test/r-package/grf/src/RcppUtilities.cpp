@@ -16,6 +16,8 @@
  #-------------------------------------------------------------------------------*/
 
 #include <Rcpp.h>
+#include <stdexcept>
+#include <vector>
 
 #include "commons/Data.h"
 #include "forest/ForestOptions.h"
@@ -116,6 +118,70 @@ Data RcppUtilities::convert_data(const Rcpp::NumericMatrix& input_data) {
   return Data(input_data.begin(), input_data.nrow(), input_data.ncol());
 }
 
+Data RcppUtilities::convert_data(const Rcpp::NumericMatrix& input_data, const Rcpp::List& columns) {
+  size_t num_rows = input_data.nrow();
+  std::vector<const double*> column_ptrs;
+  for (int col = 0; col < input_data.ncol(); col++) {
+    column_ptrs.push_back(input_data.begin() + col * num_rows);
+  }
+  for (R_xlen_t i = 0; i < columns.size(); i++) {
+    SEXP column = columns[i];
+    if (TYPEOF(column) != REALSXP) {
+      throw std::runtime_error("Training columns must be double vectors or matrices.");
+    }
+    size_t length = Rf_xlength(column);
+    if (num_rows == 0 || length % num_rows != 0) {
+      throw std::runtime_error("Training columns must have one value per row.");
+    }
+    for (size_t offset = 0; offset < length; offset += num_rows) {
+      column_ptrs.push_back(REAL(column) + offset);
+    }
+  }
+  return Data(column_ptrs, num_rows);
+}
+
+void RcppUtilities::add_virtual_columns(Data& data, const Rcpp::NumericMatrix& virtual_features) {
+  for (int i = 0; i < virtual_features.nrow(); i++) {
+    data.add_virtual_column(static_cast<size_t>(virtual_features(i, 0)),
+                            static_cast<size_t>(virtual_features(i, 1)),
+                            static_cast<size_t>(virtual_features(i, 2)),
+                            static_cast<RollingStatistic>(virtual_features(i, 3)));
+  }
+}
+
+static void check_interrupt_fn(void* /*dummy*/) {
+  R_CheckUserInterrupt();
+}
+
+// R_CheckUserInterrupt longjmps on an interrupt, which must not happen while
+// worker threads are running: R_ToplevelExec turns the jump into a return value.
+static bool user_interrupt_pending() {
+  return !R_ToplevelExec(check_interrupt_fn, nullptr);
+}
+
+void RcppUtilities::stop_on_interrupt(TrainingControl& control, bool& interrupted) {
+  control.set_progress_callback([&interrupted](size_t num_trees_done, size_t num_trees, double eta_seconds) {
+    interrupted = interrupted || user_interrupt_pending();
+    return !interrupted;
+  }, 0.1);
+}
+
+Forest RcppUtilities::train_forest(const ForestTrainer& trainer,
+                                   const Data& data,
+                                   const ForestOptions& options,
+                                   double time_budget) {
+  bool interrupted = false;
+  TrainingControl control;
+  control.set_time_budget(time_budget);
+  stop_on_interrupt(control, interrupted);
+
+  Forest forest = trainer.train(data, options, control);
+  if (interrupted) {
+    throw Rcpp::internal::InterruptedException();
+  }
+  return forest;
+}
+
 Rcpp::List RcppUtilities::create_prediction_object(const std::vector<Prediction>& predictions) {
   Rcpp::List result;
   add_predictions(result, predictions);